@@ -3,6 +3,7 @@ CONTEST_SRC_DIR = $(SRC)/Engine/Contest
 CONTEST_SOURCES = \
 	$(CONTEST_SRC_DIR)/Settings.cpp \
 	$(CONTEST_SRC_DIR)/ContestManager.cpp \
+	$(CONTEST_SRC_DIR)/ContestFlight.cpp \
 	$(CONTEST_SRC_DIR)/Solvers/Contests.cpp \
 	$(CONTEST_SRC_DIR)/Solvers/AbstractContest.cpp \
 	$(CONTEST_SRC_DIR)/Solvers/TraceManager.cpp \
@@ -27,6 +28,6 @@ CONTEST_SOURCES = \
 	$(CONTEST_SRC_DIR)/Solvers/WeglideOR.cpp \
 	$(CONTEST_SRC_DIR)/Solvers/Charron.cpp \
 
-CONTEST_DEPENDS = GEO
+CONTEST_DEPENDS = GEO THREAD
 
 $(eval $(call link-library,libcontest,CONTEST))
@@ -7,7 +7,8 @@ WAYPOINTFILE_SOURCES = \
 	$(SRC)/Waypoint/WaypointReaderZander.cpp \
 	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
-	$(SRC)/Waypoint/WaypointReader.cpp
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp
 
 WAYPOINTFILE_DEPENDS = WAYPOINT CUPFILE UNITS IO
 
@@ -9,6 +9,7 @@
 #include "Language/Language.hpp"
 #include "InfoBoxes/InfoBoxManager.hpp"
 #include "FLARM/Glue.hpp"
+#include "FLARM/Store.hpp"
 #include "Device/MultipleDevices.hpp"
 #include "Blackboard/DeviceBlackboard.hpp"
 #include "CalculationThread.hpp"
@@ -34,6 +35,7 @@ XCSoarInterface::ReceiveGPS() noexcept
     const std::lock_guard lock{device_blackboard.mutex};
 
     ReadBlackboardBasic(device_blackboard.Basic());
+    ReadTraffic(device_blackboard.GetTraffic());
 
     const NMEAInfo &real = device_blackboard.RealState();
     Private::movement_detected = real.alive && real.gps.real &&
@@ -42,7 +44,8 @@ XCSoarInterface::ReceiveGPS() noexcept
 
   BroadcastGPSUpdate();
 
-  if (!Basic().flarm.traffic.IsEmpty())
+  if (const auto &traffic = GetTraffic();
+      traffic != nullptr && !traffic->IsEmpty())
     /* auto-load FlarmNet when traffic is seen */
     LoadFlarmDatabases();
 }
@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "io/BufferedReader.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "util/SpanCast.hxx"
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <string.h>
+
+namespace {
+
+struct CacheHeader {
+  /**
+   * Increment this whenever the file format or the parser output
+   * changes.
+   */
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  uint32_t n_airspaces;
+};
+
+/**
+ * Fixed-size part of one airspace.  It is followed by #name_length
+ * characters of the name and #n_points #GeoPoint objects (polygons
+ * only).
+ */
+struct CacheRecord {
+  AbstractAirspace::Shape shape;
+  AirspaceClass asclass, astype;
+  uint8_t days;
+  uint16_t radio_frequency;
+  uint32_t name_length;
+  uint32_t n_points;
+
+  AirspaceAltitude base, top;
+
+  /* circles only */
+  GeoPoint center;
+  double radius;
+};
+
+static constexpr uint32_t MAX_AIRSPACES = 1024 * 1024;
+static constexpr uint32_t MAX_NAME_LENGTH = 4096;
+static constexpr uint32_t MAX_POINTS = 1024 * 1024;
+
+} // anonymous namespace
+
+static constexpr bool
+IsValid(const AirspaceAltitude &altitude) noexcept
+{
+  return altitude.reference == AltitudeReference::AGL ||
+    altitude.reference == AltitudeReference::MSL ||
+    altitude.reference == AltitudeReference::STD;
+}
+
+static bool
+IsValid(const CacheRecord &record) noexcept
+{
+  if (record.asclass >= AIRSPACECLASSCOUNT ||
+      record.astype >= AIRSPACECLASSCOUNT ||
+      record.name_length > MAX_NAME_LENGTH ||
+      !IsValid(record.base) || !IsValid(record.top))
+    return false;
+
+  switch (record.shape) {
+  case AbstractAirspace::Shape::CIRCLE:
+    return record.n_points == 0 && record.center.Check() &&
+      record.radius > 0;
+
+  case AbstractAirspace::Shape::POLYGON:
+    return record.n_points >= 3 && record.n_points <= MAX_POINTS;
+  }
+
+  return false;
+}
+
+static void
+SaveAirspace(BufferedOutputStream &os, const AbstractAirspace &airspace)
+{
+  CacheRecord record;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(&record, 0, sizeof(record));
+
+  const std::basic_string_view<TCHAR> name{airspace.GetName()};
+
+  record.shape = airspace.GetShape();
+  record.asclass = airspace.GetClass();
+  record.astype = airspace.GetType();
+  record.days = std::bit_cast<uint8_t>(airspace.GetDays());
+  record.radio_frequency =
+    std::bit_cast<uint16_t>(airspace.GetRadioFrequency());
+  record.name_length = name.size();
+  record.base = airspace.GetBase();
+  record.top = airspace.GetTop();
+
+  if (record.shape == AbstractAirspace::Shape::CIRCLE) {
+    const auto &circle = static_cast<const AirspaceCircle &>(airspace);
+    record.center = circle.GetReferenceLocation();
+    record.radius = circle.GetRadius();
+  } else
+    record.n_points = airspace.GetPoints().size();
+
+  os.Write(ReferenceAsBytes(record));
+  os.Write(std::as_bytes(std::span{name}));
+
+  if (record.shape == AbstractAirspace::Shape::POLYGON)
+    for (const auto &i : airspace.GetPoints())
+      os.Write(ReferenceAsBytes(i.GetLocation()));
+}
+
+void
+SaveAirspaceCache(BufferedOutputStream &os,
+                  std::span<const AirspacePtr> airspaces)
+{
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = CacheHeader::VERSION;
+  header.n_airspaces = airspaces.size();
+
+  os.Write(ReferenceAsBytes(header));
+
+  for (const auto &i : airspaces)
+    SaveAirspace(os, *i);
+}
+
+static AirspacePtr
+LoadAirspace(BufferedReader &r, std::vector<GeoPoint> &points)
+{
+  const auto record = r.ReadFullT<CacheRecord>();
+  if (!IsValid(record))
+    throw std::runtime_error("Malformed airspace cache record");
+
+  tstring name(record.name_length, _T('\0'));
+  r.ReadFull(std::as_writable_bytes(std::span{name}));
+
+  std::shared_ptr<AbstractAirspace> airspace;
+  if (record.shape == AbstractAirspace::Shape::CIRCLE) {
+    airspace = std::make_shared<AirspaceCircle>(record.center,
+                                                record.radius);
+  } else {
+    points.resize(record.n_points);
+    r.ReadFull(std::as_writable_bytes(std::span{points}));
+
+    for (const auto &i : points)
+      if (!i.Check())
+        throw std::runtime_error("Malformed airspace cache point");
+
+    airspace = std::make_shared<AirspacePolygon>(points);
+  }
+
+  airspace->SetProperties(std::move(name), record.asclass, record.astype,
+                          record.base, record.top);
+  airspace->SetRadioFrequency(std::bit_cast<RadioFrequency>(
+                                record.radio_frequency));
+  airspace->SetDays(std::bit_cast<AirspaceActivity>(record.days));
+  return airspace;
+}
+
+void
+LoadAirspaceCache(BufferedReader &r, Airspaces &airspaces)
+{
+  const auto header = r.ReadFullT<CacheHeader>();
+  if (header.version != CacheHeader::VERSION ||
+      header.n_airspaces > MAX_AIRSPACES)
+    throw std::runtime_error("Malformed airspace cache header");
+
+  std::vector<AirspacePtr> result;
+  result.reserve(header.n_airspaces);
+
+  std::vector<GeoPoint> points;
+  for (unsigned i = 0; i < header.n_airspaces; ++i)
+    result.emplace_back(LoadAirspace(r, points));
+
+  for (auto &i : result)
+    airspaces.Add(std::move(i));
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Airspace/Ptr.hpp"
+
+#include <span>
+
+class Airspaces;
+class BufferedReader;
+class BufferedOutputStream;
+
+/**
+ * Write the given airspaces to a binary cache file, which can be
+ * loaded with LoadAirspaceCache() much faster than parsing the
+ * original file.
+ *
+ * Throws on error.
+ */
+void
+SaveAirspaceCache(BufferedOutputStream &os,
+                  std::span<const AirspacePtr> airspaces);
+
+/**
+ * Load a cache file written by SaveAirspaceCache() and add all its
+ * airspaces to the #Airspaces object.  Nothing is added if the file
+ * is malformed.
+ *
+ * Throws on error.
+ */
+void
+LoadAirspaceCache(BufferedReader &reader, Airspaces &airspaces);
@@ -3,6 +3,7 @@
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Atmosphere/Pressure.hpp"
 #include "Profile/Keys.hpp"
@@ -12,26 +13,199 @@
 #include "lib/fmt/PathFormatter.hpp"
 #include "lib/fmt/RuntimeError.hxx"
 #include "system/Path.hpp"
+#include "io/FileCache.hpp"
 #include "io/FileReader.hxx"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "io/ProgressReader.hpp"
 #include "io/BufferedReader.hxx"
 #include "io/ZipArchive.hpp"
 #include "io/ZipLineReader.hpp"
 #include "io/MapFile.hpp"
 #include "Profile/Profile.hpp"
+#include "thread/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <string.h>
 
+static const TCHAR *const airspace_cache_name = _T("airspace");
+static const TCHAR *const additional_airspace_cache_name =
+  _T("airspace-additional");
+static const TCHAR *const map_airspace_cache_name = _T("airspace-map");
+
+/**
+ * Attempt to load the airspaces of the given file from the cache.
+ *
+ * @return true on success, false if there is no (valid) cache file
+ */
 static bool
-ParseAirspaceFile(Airspaces &airspaces, Path path,
+LoadAirspaceCache(Airspaces &airspaces, FileCache &cache,
+                  const TCHAR *cache_name, Path original_path) noexcept
+try {
+  auto r = cache.Load(cache_name, original_path);
+  if (!r)
+    return false;
+
+  BufferedReader buffered_reader{*r};
+  LoadAirspaceCache(buffered_reader, airspaces);
+  return true;
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load airspace cache");
+  cache.Flush(cache_name);
+  return false;
+}
+
+/**
+ * Save the airspaces which have been added (but not yet optimised)
+ * after the first #start ones to the cache.
+ */
+static void
+SaveAirspaceCache(const Airspaces &airspaces, std::size_t start,
+                  FileCache &cache,
+                  const TCHAR *cache_name, Path original_path) noexcept
+try {
+  const auto &pending = airspaces.GetPending();
+  const std::vector<AirspacePtr> list(std::next(pending.begin(), start),
+                                      pending.end());
+
+  auto os = cache.Save(cache_name, original_path);
+  BufferedOutputStream bos{*os};
+  SaveAirspaceCache(bos, list);
+  bos.Flush();
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save airspace cache");
+}
+
+/**
+ * Creates the #ThreadPool for parsing large OpenAir files on demand,
+ * i.e. only if such a file is not in the cache.
+ */
+class AirspaceParserPool {
+  std::unique_ptr<ThreadPool> pool;
+
+  bool initialized = false;
+
+public:
+  /**
+   * @return nullptr if there is only one CPU core or if the threads
+   * could not be created
+   */
+  ThreadPool *Get() noexcept;
+};
+
+ThreadPool *
+AirspaceParserPool::Get() noexcept
+{
+  if (initialized)
+    return pool.get();
+
+  initialized = true;
+
+  const unsigned n_threads =
+    std::min(ThreadPool::GetProcessorCount(), 4u) - 1;
+  if (n_threads == 0)
+    return nullptr;
+
+  try {
+    pool = std::make_unique<ThreadPool>("AirspaceParser", n_threads);
+  } catch (...) {
+    LogError(std::current_exception(),
+             "Failed to start airspace parser threads");
+  }
+
+  return pool.get();
+}
+
+/**
+ * A #Reader which returns data which has already been read from
+ * another #Reader, followed by the rest of that #Reader.
+ */
+class PrefixReader final : public Reader {
+  std::span<const std::byte> prefix;
+  Reader &next;
+
+public:
+  PrefixReader(std::span<const std::byte> _prefix, Reader &_next) noexcept
+    :prefix(_prefix), next(_next) {}
+
+  std::size_t Read(std::span<std::byte> dest) override {
+    if (prefix.empty())
+      return next.Read(dest);
+
+    const std::size_t nbytes = std::min(dest.size(), prefix.size());
+    std::copy_n(prefix.begin(), nbytes, dest.begin());
+    prefix = prefix.subspan(nbytes);
+    return nbytes;
+  }
+};
+
+/**
+ * The granularity of reading a file into memory; this keeps the
+ * progress bar moving.
+ */
+static constexpr std::size_t READ_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * Parse an airspace file.  Large OpenAir files are read into memory
+ * first, which allows splitting them over several CPU cores.  All
+ * other files are streamed.
+ *
+ * Throws on error.
+ */
+static void
+ParseAirspaceFile(Airspaces &airspaces, Reader &reader, uint64_t size,
+                  AirspaceParserPool &pool)
+{
+  if (size < MIN_PARALLEL_AIRSPACE_SIZE) {
+    BufferedReader buffered_reader{reader};
+    ParseAirspaceFile(airspaces, buffered_reader);
+    return;
+  }
+
+  static_assert(READ_BLOCK_SIZE <= MIN_PARALLEL_AIRSPACE_SIZE);
+
+  std::string data(READ_BLOCK_SIZE, '\0');
+  reader.ReadFull(std::as_writable_bytes(std::span{data}));
+
+  ThreadPool *thread_pool = IsTNPAirspaceFile(data)
+    ? nullptr
+    : pool.Get();
+  if (thread_pool == nullptr) {
+    PrefixReader prefix_reader{std::as_bytes(std::span{data}), reader};
+    BufferedReader buffered_reader{prefix_reader};
+    ParseAirspaceFile(airspaces, buffered_reader);
+    return;
+  }
+
+  data.resize(size);
+
+  const auto dest = std::as_writable_bytes(std::span{data});
+  for (std::size_t position = READ_BLOCK_SIZE; position < size;) {
+    const std::size_t nbytes = std::min<std::size_t>(READ_BLOCK_SIZE,
+                                                     size - position);
+    reader.ReadFull(dest.subspan(position, nbytes));
+    position += nbytes;
+  }
+
+  ParseAirspaceFile(airspaces, data, *thread_pool);
+}
+
+static bool
+ParseAirspaceFile(Airspaces &airspaces, Path path, AirspaceParserPool &pool,
                   OperationEnvironment &operation) noexcept
 try {
   FileReader file_reader{path};
-  ProgressReader progress_reader{file_reader, file_reader.GetSize(), operation};
-  BufferedReader buffered_reader{progress_reader};
+  const auto size = file_reader.GetSize();
+  ProgressReader progress_reader{file_reader, size, operation};
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(airspaces, progress_reader, size, pool);
   } catch (...) {
     // TODO translate this?
     std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
@@ -47,14 +221,15 @@ try {
 static bool
 ParseAirspaceFile(Airspaces &airspaces,
                   struct zzip_dir *dir, const char *path,
+                  AirspaceParserPool &pool,
                   OperationEnvironment &operation)
 try {
   ZipReader zip_reader{dir, path};
-  ProgressReader progress_reader{zip_reader, zip_reader.GetSize(), operation};
-  BufferedReader buffered_reader{progress_reader};
+  const auto size = zip_reader.GetSize();
+  ProgressReader progress_reader{zip_reader, size, operation};
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(airspaces, progress_reader, size, pool);
   } catch (...) {
     // TODO translate this?
     std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
@@ -67,8 +242,60 @@ try {
   return false;
 }
 
+/**
+ * Load the airspaces of the given file from the cache, or parse the
+ * file and update the cache.
+ */
+static bool
+ParseAirspaceFile(Airspaces &airspaces, Path path,
+                  FileCache *cache, const TCHAR *cache_name,
+                  AirspaceParserPool &pool,
+                  OperationEnvironment &operation) noexcept
+{
+  if (cache == nullptr)
+    return ParseAirspaceFile(airspaces, path, pool, operation);
+
+  if (LoadAirspaceCache(airspaces, *cache, cache_name, path))
+    return true;
+
+  const std::size_t start = airspaces.GetPending().size();
+  if (!ParseAirspaceFile(airspaces, path, pool, operation))
+    return false;
+
+  SaveAirspaceCache(airspaces, start, *cache, cache_name, path);
+  return true;
+}
+
+static bool
+ParseMapAirspaceFile(Airspaces &airspaces, FileCache *cache,
+                     AirspaceParserPool &pool,
+                     OperationEnvironment &operation)
+{
+  const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+  if (map_path == nullptr)
+    return false;
+
+  if (cache != nullptr &&
+      LoadAirspaceCache(airspaces, *cache, map_airspace_cache_name, map_path))
+    return true;
+
+  auto archive = OpenMapFile();
+  if (!archive || !archive->Exists("airspace.txt"))
+    return false;
+
+  const std::size_t start = airspaces.GetPending().size();
+  if (!ParseAirspaceFile(airspaces, archive->get(), "airspace.txt",
+                         pool, operation))
+    return false;
+
+  if (cache != nullptr)
+    SaveAirspaceCache(airspaces, start, *cache,
+                      map_airspace_cache_name, map_path);
+  return true;
+}
+
 void
-ReadAirspace(Airspaces &airspaces,
+ReadAirspace(Airspaces &airspaces, FileCache *cache,
              AtmosphericPressure press,
              OperationEnvironment &operation)
 {
@@ -77,20 +304,25 @@ ReadAirspace(Airspaces &airspaces,
 
   bool airspace_ok = false;
 
+  /* large OpenAir files are parsed on all CPU cores */
+  AirspaceParserPool pool;
+
   // Read the airspace filenames from the registry
   if (const auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
       path != nullptr)
-    airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+    airspace_ok |= ParseAirspaceFile(airspaces, path,
+                                     cache, airspace_cache_name,
+                                     pool, operation);
 
   if (const auto path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
       path != nullptr)
-    airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+    airspace_ok |= ParseAirspaceFile(airspaces, path,
+                                     cache, additional_airspace_cache_name,
+                                     pool, operation);
 
   try {
-    if (auto archive = OpenMapFile();
-        archive && archive->Exists("airspace.txt"))
-      airspace_ok |= ParseAirspaceFile(airspaces, archive->get(),
-                                       "airspace.txt", operation);
+    airspace_ok |= ParseMapAirspaceFile(airspaces, cache, pool,
+                                        operation);
   } catch (...) {
     LogError(std::current_exception(),
              "Failed to load airspaces from map file");
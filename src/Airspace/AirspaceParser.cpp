@@ -17,13 +17,20 @@
 #include "Engine/Airspace/AirspaceClass.hpp"
 #include "lib/fmt/RuntimeError.hxx"
 #include "io/BufferedReader.hxx"
+#include "io/MemoryReader.hxx"
 #include "io/StringConverter.hpp"
+#include "thread/ThreadPool.hpp"
 #include "util/ConvertString.hpp"
 #include "util/StaticString.hxx"
 #include "util/StringCompare.hxx"
 #include "util/StringSplit.hxx"
+#include "util/StringStrip.hxx"
+#include "util/SpanCast.hxx"
 
+#include <algorithm>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 using std::string_view_literals::operator""sv;
 
@@ -210,6 +217,19 @@ struct TempAirspace
     first_line_number = line_number;
   }
 
+  /**
+   * Is this object in the state left by Reset()?  #asclass (which is
+   * overwritten by the next "AC" record) and #first_line_number are
+   * not considered.
+   */
+  [[gnu::pure]]
+  bool IsClean() const noexcept {
+    return name.empty() && !radio_frequency.IsDefined() &&
+      astype == OTHER && !base && !top &&
+      days_of_operation.equals(AirspaceActivity{}) &&
+      points.empty() && !center.IsValid() && radius < 0 && rotation == 1;
+  }
+
   /**
    * If there is an airspace, add it to the #Airspaces and return
    * true.  Returns false if no airspace was being constructed.
@@ -1041,3 +1061,247 @@ ParseAirspaceFile(Airspaces &airspaces,
   // Process final area (if any)
   temp_area.Commit(airspaces);
 }
+
+static constexpr std::size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * A portion of an OpenAir file which begins with an "AC" record (or
+ * with the first line of the file) and can be parsed independently.
+ */
+struct AirspaceChunk {
+  std::string_view src;
+
+  /**
+   * The number of lines before this chunk.
+   */
+  unsigned line_offset;
+
+  /**
+   * The airspaces parsed from this chunk; they are only collected
+   * here and will be moved to the destination #Airspaces object.
+   */
+  Airspaces airspaces;
+
+  /**
+   * The charset of the #StringConverter after parsing this chunk.
+   */
+  Charset charset;
+
+  /**
+   * Was the #TempAirspace in the state left by Reset() after the
+   * final airspace of this chunk was committed?  If not, the
+   * sequential parser would carry some of its attributes over to the
+   * next chunk.
+   */
+  bool clean;
+};
+
+/**
+ * Would ParseLine() begin a new airspace with this (raw) line,
+ * committing the previous one?
+ */
+[[gnu::pure]]
+static bool
+IsAirspaceStart(std::string_view line) noexcept
+{
+  line = StripRight(line.substr(0, line.find('\0')));
+  return line.size() > 2 &&
+    (line[0] == 'A' || line[0] == 'a') &&
+    (line[1] == 'C' || line[1] == 'c') &&
+    IsWhitespaceNotNull(line[2]);
+}
+
+bool
+IsTNPAirspaceFile(std::string_view head) noexcept
+{
+  /* the last line may be incomplete */
+  head = head.substr(0, head.rfind('\n') + 1);
+
+  while (!head.empty()) {
+    auto [line, next] = Split(head, '\n');
+    head = next;
+
+    std::string buffer{line};
+    StripRight(buffer.data());
+
+    switch (DetectFileType(buffer.c_str())) {
+    case AirspaceFileType::UNKNOWN:
+      continue;
+
+    case AirspaceFileType::OPENAIR:
+      return false;
+
+    case AirspaceFileType::TNP:
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Split an OpenAir file into chunks at "AC" records.
+ *
+ * @return an empty list if this is not an OpenAir file
+ */
+static std::vector<std::pair<std::string_view, unsigned>>
+SplitOpenAir(std::string_view src, std::size_t chunk_size)
+{
+  std::vector<std::pair<std::string_view, unsigned>> chunks;
+
+  const char *chunk_start = nullptr;
+  unsigned line_number = 0, chunk_line_offset = 0;
+
+  for (std::string_view rest = src; !rest.empty();) {
+    const char *const line_start = rest.data();
+    auto [line, next] = Split(rest, '\n');
+    rest = next;
+    ++line_number;
+
+    if (chunk_start == nullptr) {
+      /* skip everything up to the line which determines the file
+         type, just like ParseAirspaceFile() does */
+      std::string buffer{line};
+      StripRight(buffer.data());
+      if (StringIsEmpty(buffer.c_str()))
+        continue;
+
+      switch (DetectFileType(buffer.c_str())) {
+      case AirspaceFileType::UNKNOWN:
+        continue;
+
+      case AirspaceFileType::OPENAIR:
+        break;
+
+      case AirspaceFileType::TNP:
+        return {};
+      }
+
+      chunk_start = line_start;
+      chunk_line_offset = line_number - 1;
+    } else if (std::size_t(line_start - chunk_start) >= chunk_size &&
+               IsAirspaceStart(line)) {
+      chunks.emplace_back(std::string_view{chunk_start, line_start},
+                          chunk_line_offset);
+      chunk_start = line_start;
+      chunk_line_offset = line_number - 1;
+    }
+  }
+
+  if (chunk_start != nullptr)
+    chunks.emplace_back(std::string_view{chunk_start, src.data() + src.size()},
+                        chunk_line_offset);
+
+  return chunks;
+}
+
+/**
+ * Parse one chunk of an OpenAir file.  Unlike the sequential parser,
+ * this does not modify the input buffer.
+ *
+ * Throws on error.
+ */
+static void
+ParseChunk(AirspaceChunk &chunk, Charset charset)
+{
+  chunk.airspaces.Clear();
+
+  StringConverter string_converter{charset};
+  TempAirspace temp_area;
+  unsigned line_number = chunk.line_offset;
+  std::string line;
+
+  for (std::string_view rest = chunk.src; !rest.empty();) {
+    auto [l, next] = Split(rest, '\n');
+    rest = next;
+    ++line_number;
+
+    line.assign(l);
+    StripRight(line.data());
+    if (StringIsEmpty(line.c_str()))
+      continue;
+
+    ParseLine(chunk.airspaces, line_number, line.data(),
+              string_converter, temp_area);
+  }
+
+  /* this is what the "AC" record at the beginning of the next chunk
+     does */
+  chunk.clean = temp_area.Commit(chunk.airspaces) || temp_area.IsClean();
+
+  chunk.charset = string_converter.GetCharset();
+}
+
+/**
+ * Parse the chunks in parallel.
+ *
+ * @return false if the result would differ from the sequential
+ * parser
+ */
+static bool
+ParseChunks(std::vector<AirspaceChunk> &chunks, ThreadPool &pool)
+{
+  pool.ForEach(chunks.size(), [&chunks](unsigned i){
+    ParseChunk(chunks[i], Charset::AUTO);
+  });
+
+  /* the sequential parser uses a single #StringConverter, which
+     switches to a fixed charset at the first non-ASCII name; parse
+     all chunks after that one again with that charset */
+  const auto switched = std::find_if(chunks.begin(), chunks.end(),
+                                     [](const AirspaceChunk &chunk){
+    return chunk.charset != Charset::AUTO;
+  });
+
+  if (switched != chunks.end() && std::next(switched) != chunks.end()) {
+    const Charset charset = switched->charset;
+    const std::size_t first = std::distance(chunks.begin(), switched) + 1;
+
+    pool.ForEach(chunks.size() - first, [&chunks, first, charset](unsigned i){
+      ParseChunk(chunks[first + i], charset);
+    });
+  }
+
+  return std::all_of(chunks.begin(), std::prev(chunks.end()),
+                     [](const AirspaceChunk &chunk){
+    return chunk.clean;
+  });
+}
+
+void
+ParseAirspaceFile(Airspaces &airspaces, std::string_view src,
+                  ThreadPool &pool)
+{
+  if (src.size() >= MIN_PARALLEL_AIRSPACE_SIZE) {
+    const std::size_t chunk_size =
+      std::max(src.size() / (4 * (pool.GetSize() + 1)), MIN_CHUNK_SIZE);
+
+    const auto split = SplitOpenAir(src, chunk_size);
+    if (split.size() > 1) {
+      std::vector<AirspaceChunk> chunks(split.size());
+      for (std::size_t i = 0; i < split.size(); ++i) {
+        chunks[i].src = split[i].first;
+        chunks[i].line_offset = split[i].second;
+      }
+
+      bool success;
+      try {
+        success = ParseChunks(chunks, pool);
+      } catch (...) {
+        /* let the sequential parser generate the error message */
+        success = false;
+      }
+
+      if (success) {
+        for (const auto &chunk : chunks)
+          for (const auto &i : chunk.airspaces.GetPending())
+            airspaces.Add(i);
+        return;
+      }
+    }
+  }
+
+  MemoryReader memory_reader{AsBytes(src)};
+  BufferedReader buffered_reader{memory_reader};
+  ParseAirspaceFile(airspaces, buffered_reader);
+}
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+
 class Airspaces;
 class BufferedReader;
+class ThreadPool;
 
 /**
  * Throws on error.
@@ -12,3 +16,31 @@ class BufferedReader;
 void
 ParseAirspaceFile(Airspaces &airspaces,
                   BufferedReader &reader);
+
+/**
+ * Files smaller than this are not worth parsing in parallel; they
+ * are better streamed into ParseAirspaceFile(BufferedReader&).
+ */
+static constexpr std::size_t MIN_PARALLEL_AIRSPACE_SIZE = 256 * 1024;
+
+/**
+ * Is this the beginning of a TNP file?  Those are never split, so
+ * there is no point in loading them into memory.
+ *
+ * @param head the first bytes of the file
+ */
+[[gnu::pure]]
+bool
+IsTNPAirspaceFile(std::string_view head) noexcept;
+
+/**
+ * Parse an airspace file which has been loaded into memory.  Large
+ * OpenAir files are split into chunks at "AC" records, which are
+ * parsed in parallel.  The airspaces are added in file order, and the
+ * result is the same as with the sequential parser.
+ *
+ * Throws on error.
+ */
+void
+ParseAirspaceFile(Airspaces &airspaces, std::string_view src,
+                  ThreadPool &pool);
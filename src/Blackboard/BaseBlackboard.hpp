@@ -6,6 +6,10 @@
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 
+#include <memory>
+
+class TrafficStore;
+
 /**
  * Base class for blackboards, providing read access to NMEA_INFO and DERIVED_INFO
  */
@@ -15,6 +19,13 @@ protected:
   MoreData gps_info;
   DerivedInfo calculated_info;
 
+  /**
+   * The merged traffic of all devices (an immutable snapshot which
+   * is shared between blackboards).  It is nullptr until the
+   * #MergeThread has run.
+   */
+  std::shared_ptr<const TrafficStore> traffic;
+
 public:
   // all blackboards can be read as const
   constexpr const MoreData &Basic() const noexcept {
@@ -24,4 +35,8 @@ public:
   constexpr const DerivedInfo& Calculated() const noexcept {
     return calculated_info;
   }
+
+  const std::shared_ptr<const TrafficStore> &GetTraffic() const noexcept {
+    return traffic;
+  }
 };
@@ -213,3 +213,21 @@ DeviceBlackboard::Merge() noexcept
     basic = real_data;
   }
 }
+
+StaticArray<const TrafficList *, NUMDEV>
+DeviceBlackboard::GetTrafficSources() const noexcept
+{
+  StaticArray<const TrafficList *, NUMDEV> sources;
+
+  if (replay_data.alive) {
+    sources.push_back(&replay_data.flarm.traffic);
+  } else if (simulator_data.alive) {
+    sources.push_back(&simulator_data.flarm.traffic);
+  } else {
+    for (const auto &basic : per_device_data)
+      if (basic.alive)
+        sources.push_back(&basic.flarm.traffic);
+  }
+
+  return sources;
+}
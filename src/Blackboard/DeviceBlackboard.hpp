@@ -9,6 +9,7 @@
 #include "Device/Features.hpp"
 #include "thread/Mutex.hxx"
 #include "time/WrapClock.hpp"
+#include "util/StaticArray.hxx"
 
 #include <array>
 
@@ -85,6 +86,17 @@ protected:
   NMEAInfo &SetBasic() noexcept { return gps_info; }
   MoreData &SetMoreData() noexcept { return gps_info; }
 
+  void SetTraffic(std::shared_ptr<const TrafficStore> &&_traffic) noexcept {
+    traffic = std::move(_traffic);
+  }
+
+  /**
+   * Returns the traffic lists of all devices which were merged by
+   * Merge().
+   */
+  [[gnu::pure]]
+  StaticArray<const TrafficList *, NUMDEV> GetTrafficSources() const noexcept;
+
 public:
   const NMEAInfo &RealState(unsigned i) const noexcept {
     return per_device_data[i];
@@ -11,6 +11,10 @@ public:
   void ReadBlackboardBasic(const MoreData &nmea_info) noexcept;
   void ReadBlackboardCalculated(const DerivedInfo &derived_info) noexcept;
 
+  void ReadTraffic(const std::shared_ptr<const TrafficStore> &_traffic) noexcept {
+    traffic = _traffic;
+  }
+
   [[gnu::const]]
   SystemSettings &SetSystemSettings() noexcept {
     return system_settings;
@@ -3,6 +3,10 @@
 
 #include "ContestComputer.hpp"
 #include "Engine/Contest/Settings.hpp"
+#include "thread/ThreadPool.hpp"
+#include "LogFile.hpp"
+
+#include <algorithm>
 
 ContestComputer::ContestComputer(const Trace &trace_full,
                                  const Trace &trace_triangle,
@@ -10,8 +14,25 @@ ContestComputer::ContestComputer(const Trace &trace_full,
   :contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle, trace_sprint, true)
 {
   contest_manager.SetIncremental(true);
+
+  /* the calculation thread runs one solver itself, and no contest
+     has more than 3 independent solvers */
+  const unsigned n_threads =
+    std::min(ThreadPool::GetProcessorCount(), 3u) - 1;
+  if (n_threads > 0) {
+    try {
+      solver_pool = std::make_unique<ThreadPool>("ContestSolver",
+                                                 n_threads);
+      contest_manager.SetThreadPool(solver_pool.get());
+    } catch (...) {
+      LogError(std::current_exception(),
+               "Failed to start contest solver threads");
+    }
+  }
 }
 
+ContestComputer::~ContestComputer() noexcept = default;
+
 void
 ContestComputer::Solve(const ContestSettings &settings,
                        ContestStatistics &contest_stats)
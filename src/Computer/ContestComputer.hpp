@@ -5,17 +5,27 @@
 
 #include "Engine/Contest/ContestManager.hpp"
 
+#include <memory>
+
+class ThreadPool;
 struct ContestSettings;
 struct ContestStatistics;
 class Trace;
 
 class ContestComputer {
+  /**
+   * Runs the independent solvers of contests such as OLC Plus and
+   * WeGlide Free in parallel; nullptr on single-core machines.
+   */
+  std::unique_ptr<ThreadPool> solver_pool;
+
   ContestManager contest_manager;
 
 public:
   ContestComputer(const Trace &trace_full,
                   const Trace &trace_triangle,
                   const Trace &trace_sprint);
+  ~ContestComputer() noexcept;
 
   void SetIncremental(bool incremental) {
     contest_manager.SetIncremental(incremental);
@@ -71,35 +71,35 @@ RouteComputer::TerrainWarning(const MoreData &basic,
     v.distance = 200000;
 
   if (terrain) {
-    if (sol.IsDefined()) {
-      const AGeoPoint dest(v.EndPoint(start), sol.min_arrival_altitude);
-      bool dirty = route_clock.CheckAdvance(basic.time, PERIOD);
+    const AGeoPoint dest(v.EndPoint(start), sol.min_arrival_altitude);
+    bool dirty = route_clock.CheckAdvance(basic.time, PERIOD);
+
+    if (calculated.task_stats.active_index != last_active_tp ||
+        calculated.common_stats.task_type != last_task_type) {
+      // a suspended search would be for the old destination
+      protected_route_planner.CancelRoute();
 
       if (!dirty) {
-        dirty =
-          calculated.task_stats.active_index != last_active_tp ||
-          calculated.common_stats.task_type != last_task_type;
-        if (dirty) {
-          // restart clock
-          route_clock.Reset();
-        }
+        dirty = true;
+        // restart clock
+        route_clock.Reset();
       }
+    }
 
-      last_task_type = calculated.common_stats.task_type;
-      last_active_tp = calculated.task_stats.active_index;
-
-      if (dirty) {
-        protected_route_planner.SolveRoute(dest, start, config, h_ceiling);
-        calculated.planned_route = route_planner.GetSolution();
+    last_task_type = calculated.common_stats.task_type;
+    last_active_tp = calculated.task_stats.active_index;
 
-        calculated.terrain_warning_location =
-          route_planner.Intersection(start, dest);
-      }
-      return;
-    } else {
-      protected_route_planner.SolveRoute(start, start, config, h_ceiling);
+    if (dirty || protected_route_planner.IsSolvingRoute()) {
+      /* while the search is suspended, this publishes the previous
+         solution */
+      protected_route_planner.SolveRoute(dest, start, config, h_ceiling,
+                                         ROUTE_STEPS_PER_CYCLE);
       calculated.planned_route = route_planner.GetSolution();
+
+      calculated.terrain_warning_location =
+        route_planner.Intersection(start, dest);
     }
+    return;
   }
   calculated.terrain_warning_location.SetInvalid();
 }
@@ -19,6 +19,14 @@ class GlidePolar;
 class RouteComputer {
   static constexpr std::chrono::steady_clock::duration PERIOD = std::chrono::seconds(5);
 
+  /**
+   * The maximum number of search nodes expanded by the route planner
+   * per calculation cycle.  A search which needs more is suspended
+   * and resumed in the next cycle, so a difficult airspace maze does
+   * not delay the other computers.
+   */
+  static constexpr unsigned ROUTE_STEPS_PER_CYCLE = 256;
+
   RoutePlannerGlue route_planner;
   ProtectedRoutePlanner protected_route_planner;
 
@@ -51,14 +51,14 @@ public:
     return trace;
   }
 
-  void LockedCopyTraceTo(TracePointVector &v) const {
-    trace.LockedCopyTo(v);
+  void CopyTraceTo(TracePointVector &v) const {
+    trace.CopyTo(v);
   }
 
-  void LockedCopyTraceTo(TracePointVector &v,
-                         std::chrono::duration<unsigned> min_time,
-                         const GeoPoint &location, double resolution) const {
-    trace.LockedCopyTo(v, min_time, location, resolution);
+  void CopyTraceTo(TracePointVector &v,
+                   std::chrono::duration<unsigned> min_time,
+                   const GeoPoint &location, double resolution) const {
+    trace.CopyTo(v, min_time, location, resolution);
   }
 
   void ProcessBasicTask(const MoreData &basic,
@@ -5,6 +5,7 @@
 #include "Settings.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
+#include "Engine/Trace/Snapshot.hpp"
 
 static constexpr unsigned full_trace_size = 1024;
 static constexpr unsigned contest_trace_size = 256;
@@ -17,35 +18,61 @@ TraceComputer::TraceComputer()
   contest({}, Trace::null_time, contest_trace_size),
   sprint({}, std::chrono::minutes{150}, sprint_trace_size)
 {
+  PublishSnapshot();
 }
 
+TraceComputer::~TraceComputer() noexcept = default;
+
 void
 TraceComputer::Reset()
 {
-  {
-    const std::lock_guard lock{mutex};
-    full.clear();
-  }
-
+  full.clear();
   contest.clear();
   sprint.clear();
+
+  PublishSnapshot();
 }
 
 void
-TraceComputer::LockedCopyTo(TracePointVector &v) const
+TraceComputer::PublishSnapshot() noexcept
 {
-  const std::lock_guard lock{mutex};
-  full.GetPoints(v);
+  /* no lock needed for reading #snapshot here: only this thread
+     replaces it */
+  if (snapshot != nullptr && snapshot->GetSerial() == full.GetAppendSerial())
+    /* unmodified */
+    return;
+
+  /* copy the trace before locking; only the pointer swap is
+     protected, and the old snapshot is freed after unlocking (unless
+     another thread still uses it) */
+  std::shared_ptr<const TraceSnapshot> s =
+    std::make_shared<const TraceSnapshot>(full);
+
+  const std::lock_guard lock{snapshot_mutex};
+  snapshot.swap(s);
+}
+
+std::shared_ptr<const TraceSnapshot>
+TraceComputer::GetSnapshot() const noexcept
+{
+  const std::lock_guard lock{snapshot_mutex};
+  return snapshot;
 }
 
 void
-TraceComputer::LockedCopyTo(TracePointVector &v,
-                            std::chrono::duration<unsigned> min_time,
-                            const GeoPoint &location,
-                            double resolution) const
+TraceComputer::CopyTo(TracePointVector &v) const
 {
-  const std::lock_guard lock{mutex};
-  full.GetPoints(v, min_time, location, resolution);
+  const auto s = GetSnapshot();
+  v.assign(s->GetPoints().begin(), s->GetPoints().end());
+}
+
+void
+TraceComputer::CopyTo(TracePointVector &v,
+                      std::chrono::duration<unsigned> min_time,
+                      const GeoPoint &location,
+                      double resolution) const
+{
+  GetSnapshot()->GetPoints(v, min_time, location, resolution);
 }
 
 void
@@ -61,10 +88,8 @@ TraceComputer::Update(const ComputerSettings &settings_computer,
 
   const TracePoint point(basic);
 
-  {
-    const std::lock_guard lock{mutex};
-    full.push_back(point);
-  }
+  full.push_back(point);
+  PublishSnapshot();
 
   // only contest requires trace_sprint
   if (settings_computer.contest.enable) {
@@ -6,33 +6,43 @@
 #include "thread/Mutex.hxx"
 #include "Engine/Trace/Trace.hpp"
 
+#include <memory>
+
 struct ComputerSettings;
 struct MoreData;
 struct DerivedInfo;
+class TraceSnapshot;
 
 /**
  * Record a trace of the current flight.
  */
 class TraceComputer {
   /**
-   * This mutex protects trace_full: it must be locked while editing
-   * the trace, and while reading it from a thread other than the
-   * #CalculationThread.
+   * The traces are only accessed by the #CalculationThread; other
+   * threads read #snapshot instead.
    */
-  mutable Mutex mutex;
-
   Trace full, contest, sprint;
 
+  /**
+   * This mutex protects #snapshot.  It is only held while the
+   * pointer is being copied or replaced, never while the trace is
+   * being modified.
+   */
+  mutable Mutex snapshot_mutex;
+
+  /**
+   * An immutable copy of #full, replaced after each modification.
+   */
+  std::shared_ptr<const TraceSnapshot> snapshot;
+
 public:
   TraceComputer();
-
-  operator Mutex &() const {
-    return const_cast<Mutex &>(mutex);
-  }
+  ~TraceComputer() noexcept;
 
   /**
-   * Returns a reference to the full trace.  When using this reference
-   * outside of the #CalculationThread, the mutex must be locked.
+   * Returns an unprotected reference to the full trace.  This object
+   * may be used only inside the #CalculationThread; other threads
+   * must use GetSnapshot().
    */
   const Trace &GetFull() const {
     return full;
@@ -57,19 +67,32 @@ public:
   void Reset();
 
   /**
-   * Extract all trace points.  The trace is locked, and the method
-   * may be called from any thread.
+   * Obtain the most recent copy of the full trace.  This method may
+   * be called from any thread, and it does not wait for the
+   * #CalculationThread.
    */
-  void LockedCopyTo(TracePointVector &v) const;
+  std::shared_ptr<const TraceSnapshot> GetSnapshot() const noexcept;
 
   /**
-   * Extract some trace points.  The trace is locked, and the method
-   * may be called from any thread.
+   * Extract all trace points.  This method may be called from any
+   * thread.
    */
-  void LockedCopyTo(TracePointVector &v,
-                    std::chrono::duration<unsigned> min_time,
-                    const GeoPoint &location, double resolution) const;
+  void CopyTo(TracePointVector &v) const;
+
+  /**
+   * Extract some trace points.  This method may be called from any
+   * thread.
+   */
+  void CopyTo(TracePointVector &v,
+              std::chrono::duration<unsigned> min_time,
+              const GeoPoint &location, double resolution) const;
 
   void Update(const ComputerSettings &settings_computer,
               const MoreData &basic, const DerivedInfo &calculated);
+
+private:
+  /**
+   * Replace #snapshot with a copy of #full if it has been modified.
+   */
+  void PublishSnapshot() noexcept;
 };
@@ -15,6 +15,8 @@
 #include "Engine/GlideSolvers/MacCready.hpp"
 #include "Language/Language.hpp"
 
+#include <array>
+
 CrossSectionRenderer::CrossSectionRenderer(const CrossSectionLook &_look,
                                            const AirspaceLook &_airspace_look,
                                            const ChartLook &_chart_look,
@@ -103,13 +105,14 @@ CrossSectionRenderer::UpdateTerrain(TerrainHeight *elevations) const
 
   const GeoPoint point_diff = vec.EndPoint(start) - start;
 
-  RasterTerrain::Lease map(*terrain);
+  std::array<GeoPoint, NUM_SLICES> slice_points;
   for (unsigned i = 0; i < NUM_SLICES; ++i) {
     const auto slice_distance_factor = double(i) / (NUM_SLICES - 1);
-    const GeoPoint slice_point = start + point_diff * slice_distance_factor;
-
-    elevations[i] = map->GetHeight(slice_point);
+    slice_points[i] = start + point_diff * slice_distance_factor;
   }
+
+  RasterTerrain::Lease map(*terrain);
+  map->GetHeights(slice_points, elevations);
 }
 
 void
@@ -14,6 +14,7 @@
 #include "Port/ConfiguredPort.hpp"
 #include "Port/DumpPort.hpp"
 #include "NMEA/Info.hpp"
+#include "NMEA/Checksum.hpp"
 #include "thread/Mutex.hxx"
 #include "util/StringAPI.hxx"
 #include "util/ConvertString.hpp"
@@ -709,7 +710,15 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info) noexcept
   const ExternalSettings old_settings = info.settings;
   info.settings = settings_received;
 
-  if (device != nullptr && device->ParseNMEA(line, info)) {
+  /* verify the checksum only once for the driver and the generic
+     parser; lines without a valid checksum are still passed to the
+     driver, because some devices don't send one */
+  const bool checksum_valid = VerifyNMEAChecksum(line);
+
+  if (device != nullptr &&
+      (checksum_valid
+       ? device->ParseVerifiedNMEA(line, info)
+       : device->ParseNMEA(line, info))) {
     info.alive.Update(info.clock);
 
     if (!config.sync_from_device)
@@ -729,7 +738,7 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info) noexcept
   info.settings = old_settings;
 
   // Additional "if" to find GPS strings
-  if (parser.ParseLine(line, info)) {
+  if (checksum_valid && parser.ParseVerifiedLine(line, info)) {
     info.alive.Update(info.clock);
     return true;
   }
@@ -1337,16 +1346,43 @@ DeviceDescriptor::DataReceived(std::span<const std::byte> s) noexcept
 bool
 DeviceDescriptor::LineReceived(const char *line) noexcept
 {
-  if (nmea_logger != nullptr)
-    nmea_logger->Log(line);
-
   if (dispatcher != nullptr)
     dispatcher->LineReceived(line);
 
+  if (received_lines.full())
+    ParseReceivedLines();
+
+  received_lines.push_back(line);
+  return true;
+}
+
+bool
+DeviceDescriptor::FlushLines() noexcept
+{
+  if (!received_lines.empty())
+    ParseReceivedLines();
+
+  return true;
+}
+
+void
+DeviceDescriptor::ParseReceivedLines() noexcept
+{
+  assert(!received_lines.empty());
+
+  if (nmea_logger != nullptr)
+    nmea_logger->Log(received_lines);
+
+  /* parse directly into the DeviceBlackboard while holding its
+     lock; parsing into a copy and storing it back later would
+     discard modifications by other BeginEdit() callers */
   const auto e = BeginEdit();
   e->UpdateClock();
-  ParseNMEA(line, *e);
+
+  for (const char *line : received_lines)
+    ParseNMEA(line, *e);
+
   e.Commit();
 
-  return true;
+  received_lines.clear();
 }
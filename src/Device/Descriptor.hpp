@@ -20,6 +20,7 @@
 #include "time/FloatDuration.hxx"
 #include "util/tstring.hpp"
 #include "util/StaticFifoBuffer.hxx"
+#include "util/TrivialArray.hxx"
 
 #ifdef HAVE_INTERNAL_GPS
 #include "SensorListener.hpp"
@@ -125,6 +126,13 @@ class DeviceDescriptor final
    */
   PortLineHandler *dispatcher = nullptr;
 
+  /**
+   * The lines passed to LineReceived() which have not been parsed
+   * yet.  They point into the buffer of #PortLineSplitter, and are
+   * parsed by FlushLines() with only one #DeviceBlackboard lock.
+   */
+  TrivialArray<const char *, 32> received_lines;
+
   /**
    * The device driver used to handle data to/from the device.
    */
@@ -514,6 +522,11 @@ public:
 private:
   bool ParseNMEA(const char *line, struct NMEAInfo &info) noexcept;
 
+  /**
+   * Log and parse all #received_lines and clear the list.
+   */
+  void ParseReceivedLines() noexcept;
+
 public:
   void SetMonitor(DataHandler  *_monitor) noexcept {
     monitor = _monitor;
@@ -598,6 +611,9 @@ private:
   /* virtual methods from PortLineHandler */
   bool LineReceived(const char *line) noexcept override;
 
+  /* virtual methods from PortLineSplitter */
+  bool FlushLines() noexcept override;
+
 #ifdef HAVE_INTERNAL_GPS
   /* methods from SensorListener */
   void OnConnected(int connected) noexcept override;
@@ -25,6 +25,12 @@ AbstractDevice::ParseNMEA([[maybe_unused]] const char *line, [[maybe_unused]] st
   return false;
 }
 
+bool
+AbstractDevice::ParseVerifiedNMEA(const char *line, struct NMEAInfo &info)
+{
+  return ParseNMEA(line, info);
+}
+
 bool
 AbstractDevice::PutMacCready([[maybe_unused]] double MacCready, [[maybe_unused]] OperationEnvironment &env)
 {
@@ -55,6 +55,18 @@ public:
    */
   virtual bool ParseNMEA(const char *line, struct NMEAInfo &info) = 0;
 
+  /**
+   * Like ParseNMEA(), but the caller has already verified the NMEA
+   * checksum of this line.  Drivers which reject lines with a bad
+   * checksum implement ParseNMEA() by calling VerifyNMEAChecksum()
+   * and this method; everything else goes here, so the checksum is
+   * calculated only once per line.
+   *
+   * @param info destination for sensor values
+   * @return true when the line has been processed
+   */
+  virtual bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) = 0;
+
   /**
    * Send the new MacCready value to the device.
    *
@@ -239,6 +251,7 @@ public:
   bool EnableNMEA(OperationEnvironment &env) override;
 
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 
   bool PutMacCready(double MacCready, OperationEnvironment &env) override;
   bool PutBugs(double bugs, OperationEnvironment &env) override;
@@ -116,6 +116,7 @@ public:
 
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
   bool PutQNH(const AtmosphericPressure &pres,
               OperationEnvironment &env) override;
   bool PutVolume(unsigned volume, OperationEnvironment &env) override;
@@ -169,9 +170,12 @@ ACDDevice::PutTransponderCode(TransponderCode code, OperationEnvironment &env)
 bool
 ACDDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+ACDDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
 
   if (line.ReadCompare("$PAAVS"))
@@ -47,6 +47,7 @@ public:
 public:
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
   bool Declare(const struct Declaration &declaration,
                const Waypoint *home,
                OperationEnvironment &env) override;
@@ -100,9 +101,12 @@ PTFRS(NMEAInputLine &line, NMEAInfo &info)
 bool
 AltairProDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+AltairProDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
   const auto type = line.ReadView();
 
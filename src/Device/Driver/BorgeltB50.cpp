@@ -23,6 +23,7 @@ public:
 
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 
   bool PutMacCready(double mc, OperationEnvironment &env) override;
   bool PutBugs(double bugs, OperationEnvironment &env) override;
@@ -105,9 +106,12 @@ PBB50(NMEAInputLine &line, NMEAInfo &info)
 bool
 B50Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+B50Device::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
   const auto type = line.ReadView();
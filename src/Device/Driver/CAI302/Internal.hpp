@@ -43,6 +43,7 @@ public:
   virtual bool EnableNMEA(OperationEnvironment &env) override;
 
   virtual bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  virtual bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
   virtual bool PutMacCready(double mc, OperationEnvironment &env) override;
   virtual bool PutBugs(double bugs, OperationEnvironment &env) override;
   virtual bool PutBallast(double fraction, double overload,
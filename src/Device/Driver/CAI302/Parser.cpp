@@ -6,8 +6,7 @@
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Checksum.hpp"
-
-using std::string_view_literals::operator""sv;
+#include "NMEA/SentenceTable.hpp"
 
 static bool
 ReadSpeedVector(NMEAInputLine &line, SpeedVector &value_r)
@@ -126,18 +125,22 @@ cai_w(NMEAInputLine &line, NMEAInfo &info)
 bool
 CAI302Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+CAI302Device::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
-  const auto type = line.ReadView();
-  if (type == "$PCAIB"sv)
-    return cai_PCAIB(line, info);
-  else if (type == "$PCAID"sv)
-    return cai_PCAID(line, info);
-  else if (type == "!w"sv)
-    return cai_w(line, info);
-  else
-    return false;
+  using Handler = bool (*)(NMEAInputLine &line, NMEAInfo &info);
+
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$PCAIB", cai_PCAIB},
+    {"$PCAID", cai_PCAID},
+    {"!w", cai_w},
+  });
+
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(line, info);
 }
@@ -14,6 +14,7 @@ class CondorDevice : public AbstractDevice {
 public:
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 };
 
 static bool
@@ -63,9 +64,12 @@ cLXWP0(NMEAInputLine &line, NMEAInfo &info)
 bool
 CondorDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+CondorDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
   const auto type = line.ReadView();
@@ -38,6 +38,7 @@ public:
   /* virtual methods from class Device */
   bool EnableNMEA(OperationEnvironment &env) override;
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
   bool Declare(const Declaration &declaration, const Waypoint *home,
                OperationEnvironment &env) override;
 };
@@ -68,9 +69,12 @@ ReadAltitude(NMEAInputLine &line, double &value_r)
 bool
 EWMicroRecorderDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+EWMicroRecorderDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
   const auto type = line.ReadView();
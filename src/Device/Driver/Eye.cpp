@@ -16,6 +16,7 @@ class EyeDevice : public AbstractDevice {
 public:
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, NMEAInfo &info) override;
 
   static bool PEYA(NMEAInputLine &line, NMEAInfo &info);
   static bool PEYI(NMEAInputLine &line, NMEAInfo &info);
@@ -27,9 +28,12 @@ protected:
 bool
 EyeDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+EyeDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
 
   const auto type = line.ReadView();
@@ -29,11 +29,14 @@ FlarmDevice::ParsePFLAC(NMEAInputLine &line)
 }
 
 bool
-FlarmDevice::ParseNMEA(const char *_line, [[maybe_unused]] NMEAInfo &info)
+FlarmDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+FlarmDevice::ParseVerifiedNMEA(const char *_line, [[maybe_unused]] NMEAInfo &info)
+{
   NMEAInputLine line(_line);
 
   const auto type = line.ReadView();
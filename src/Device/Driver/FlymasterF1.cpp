@@ -19,6 +19,7 @@ public:
   /* virtual methods from class Device */
   bool EnableNMEA(OperationEnvironment &env) override;
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 };
 
 bool
@@ -71,9 +72,12 @@ VARIO(NMEAInputLine &line, NMEAInfo &info)
 bool
 FlymasterF1Device::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+FlymasterF1Device::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
   const auto type = line.ReadView();
@@ -24,6 +24,7 @@ public:
 
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, NMEAInfo &info) override;
 
   bool ReadFlightList(RecordedFlightList &flight_list,
                       OperationEnvironment &env) override;
@@ -6,10 +6,9 @@
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Checksum.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Units/System.hpp"
 
-using std::string_view_literals::operator""sv;
-
 /**
  * Parse a "$BRSF" sentence.
  *
@@ -227,18 +226,31 @@ FlytecDevice::ParseFLYSEN(NMEAInputLine &line, NMEAInfo &info)
 bool
 FlytecDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+FlytecDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
 
-  const auto type = line.ReadView();
-  if (type == "$BRSF"sv)
-    return FlytecParseBRSF(line, info);
-  else if (type == "$VMVABD"sv)
-    return FlytecParseVMVABD(line, info);
-  else if (type == "$FLYSEN"sv)
-    return ParseFLYSEN(line, info);
-  else
-    return false;
+  using Handler = bool (*)(FlytecDevice &device, NMEAInputLine &line,
+                           NMEAInfo &info);
+
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$BRSF", [](FlytecDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return FlytecParseBRSF(line, info);
+    }},
+
+    {"$VMVABD", [](FlytecDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return FlytecParseVMVABD(line, info);
+    }},
+
+    {"$FLYSEN", [](FlytecDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      return device.ParseFLYSEN(line, info);
+    }},
+  });
+
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(*this, line, info);
 }
@@ -13,6 +13,7 @@ class ILECDevice : public AbstractDevice {
 public:
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 };
 
 /**
@@ -47,9 +48,12 @@ ParsePDA1(NMEAInputLine &line, NMEAInfo &info)
 bool
 ILECDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+ILECDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
 
   auto type = line.ReadView();
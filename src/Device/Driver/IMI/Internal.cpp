@@ -47,9 +47,12 @@ ReadAltitude(NMEAInputLine &line, double &value_r)
 bool
 IMIDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+IMIDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
   const auto type = line.ReadView();
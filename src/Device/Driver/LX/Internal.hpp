@@ -241,6 +241,9 @@ protected:
 
   bool EnableCommandMode(OperationEnvironment &env);
 
+  void ParseLXWP1(NMEAInputLine &line, NMEAInfo &info);
+  void ParsePLXVC(NMEAInputLine &line, NMEAInfo &info);
+
 public:
   // These methods are reused by the LX Eos driver
   static void LXWP1(NMEAInputLine &line, DeviceInfo &device);
@@ -251,6 +254,7 @@ public:
   bool EnableNMEA(OperationEnvironment &env) override;
 
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 
   bool PutBallast(double fraction, double overload,
                   OperationEnvironment &env) override;
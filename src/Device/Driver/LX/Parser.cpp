@@ -4,6 +4,7 @@
 #include "Internal.hpp"
 #include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "NMEA/Info.hpp"
 #include "Geo/SpeedVector.hpp"
 #include "Units/System.hpp"
@@ -289,82 +290,107 @@ PLXVS(NMEAInputLine &line, NMEAInfo &info)
 bool
 LXDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+LXDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
-  const auto type = line.ReadView();
-  if (type == "$LXWP0"sv)
-    return LXWP0(line, info);
-
-  else if (type == "$LXWP1"sv) {
-    /* if in pass-through mode, assume that this line was sent by the
-       secondary device */
-    DeviceInfo &device_info = mode == Mode::PASS_THROUGH
-      ? info.secondary_device
-      : info.device;
-    LXWP1(line, device_info);
-
-    const bool saw_sVario = device_info.product.equals("NINC") || 
-                            device_info.product.equals("S8x");
-    const bool saw_v7 = device_info.product.equals("V7");
-    const bool saw_nano = device_info.product.equals("NANO") ||
-                            device_info.product.equals("NANO3") || 
-                            device_info.product.equals("NANO4");
-    const bool saw_lx16xx = device_info.product.equals("1606") ||
-                             device_info.product.equals("1600");
-
-    if (mode == Mode::PASS_THROUGH) {
-      /* in pass-through mode, we should never clear the V7 flag,
-         because the V7 is still there, even though it's "hidden"
-         currently */
-      is_v7 |= saw_v7;
-      is_sVario |= saw_sVario;
-      is_nano |= saw_nano;
-      is_lx16xx |= saw_lx16xx;
-      is_forwarded_nano = saw_nano;
-    } else {
-      is_v7 = saw_v7;
-      is_sVario = saw_sVario;
-      is_nano = saw_nano;
-      is_lx16xx = saw_lx16xx;
-    }
-
-    if (saw_v7 || saw_sVario || saw_nano || saw_lx16xx)
-      is_colibri = false;
-
-    return true;
-
-  } else if (type == "$LXWP2"sv)
-    return LXWP2(line, info);
-
-  else if (type == "$LXWP3"sv)
-    return LXWP3(line, info);
-
-  else if (type == "$PLXV0"sv) {
-    is_colibri = false;
-    return PLXV0(line, lxnav_vario_settings);
-
-  } else if (type == "$PLXVC"sv) {
-    is_colibri = false;
-    PLXVC(line, info.device, info.secondary_device, nano_settings);
-    is_forwarded_nano = info.secondary_device.product.equals("NANO") ||
-                          info.secondary_device.product.equals("NANO3") ||
-                          info.secondary_device.product.equals("NANO4");
-
-    LXDevice::IdDeviceByName(info.device.product);
+  using Handler = bool (*)(LXDevice &device, NMEAInputLine &line,
+                           NMEAInfo &info);
+
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$LXWP0", [](LXDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return LXWP0(line, info);
+    }},
+
+    {"$LXWP1", [](LXDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      device.ParseLXWP1(line, info);
+      return true;
+    }},
+
+    {"$LXWP2", [](LXDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return LXWP2(line, info);
+    }},
+
+    {"$LXWP3", [](LXDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return LXWP3(line, info);
+    }},
+
+    {"$PLXV0", [](LXDevice &device, NMEAInputLine &line, NMEAInfo &){
+      device.is_colibri = false;
+      return PLXV0(line, device.lxnav_vario_settings);
+    }},
+
+    {"$PLXVC", [](LXDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      device.ParsePLXVC(line, info);
+      return true;
+    }},
+
+    {"$PLXVF", [](LXDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      device.is_colibri = false;
+      return PLXVF(line, info);
+    }},
+
+    {"$PLXVS", [](LXDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      device.is_colibri = false;
+      return PLXVS(line, info);
+    }},
+  });
+
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(*this, line, info);
+}
 
-    return true;
+inline void
+LXDevice::ParseLXWP1(NMEAInputLine &line, NMEAInfo &info)
+{
+  /* if in pass-through mode, assume that this line was sent by the
+     secondary device */
+  DeviceInfo &device_info = mode == Mode::PASS_THROUGH
+    ? info.secondary_device
+    : info.device;
+  LXWP1(line, device_info);
+
+  const bool saw_sVario = device_info.product.equals("NINC") || 
+                          device_info.product.equals("S8x");
+  const bool saw_v7 = device_info.product.equals("V7");
+  const bool saw_nano = device_info.product.equals("NANO") ||
+                          device_info.product.equals("NANO3") || 
+                          device_info.product.equals("NANO4");
+  const bool saw_lx16xx = device_info.product.equals("1606") ||
+                           device_info.product.equals("1600");
+
+  if (mode == Mode::PASS_THROUGH) {
+    /* in pass-through mode, we should never clear the V7 flag,
+       because the V7 is still there, even though it's "hidden"
+       currently */
+    is_v7 |= saw_v7;
+    is_sVario |= saw_sVario;
+    is_nano |= saw_nano;
+    is_lx16xx |= saw_lx16xx;
+    is_forwarded_nano = saw_nano;
+  } else {
+    is_v7 = saw_v7;
+    is_sVario = saw_sVario;
+    is_nano = saw_nano;
+    is_lx16xx = saw_lx16xx;
+  }
 
-  } else if (type == "$PLXVF"sv) {
+  if (saw_v7 || saw_sVario || saw_nano || saw_lx16xx)
     is_colibri = false;
-    return PLXVF(line, info);
+}
 
-  } else if (type == "$PLXVS"sv) {
-    is_colibri = false;
-    return PLXVS(line, info);
+inline void
+LXDevice::ParsePLXVC(NMEAInputLine &line, NMEAInfo &info)
+{
+  is_colibri = false;
+  PLXVC(line, info.device, info.secondary_device, nano_settings);
+  is_forwarded_nano = info.secondary_device.product.equals("NANO") ||
+                        info.secondary_device.product.equals("NANO3") ||
+                        info.secondary_device.product.equals("NANO4");
 
-  } else
-    return false;
+  LXDevice::IdDeviceByName(info.device.product);
 }
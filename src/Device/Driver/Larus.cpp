@@ -32,6 +32,7 @@ public:
   LarusDevice(Port &_port) : port(_port) {}
 
   bool ParseNMEA(const char *line, NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, NMEAInfo &info) override;
   bool PutMacCready(double mc, OperationEnvironment &env) override;
   bool PutBugs(double bugs, OperationEnvironment &env) override;
   bool PutBallast(double fraction, double overload,
@@ -70,9 +71,12 @@ ReadBearing(NMEAInputLine &line, Angle &value_r)
 bool
 LarusDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+LarusDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
   const auto type = line.ReadView();
   if (type.starts_with("$PLAR"sv)) {
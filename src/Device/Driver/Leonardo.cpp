@@ -5,10 +5,9 @@
 #include "Device/Driver.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Units/System.hpp"
 
-using std::string_view_literals::operator""sv;
-
 class LeonardoDevice : public AbstractDevice {
 public:
   /* virtual methods from class Device */
@@ -169,18 +168,19 @@ LeonardoDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
   NMEAInputLine line(_line);
 
-  const auto type = line.ReadView();
-  if (type == "$C"sv || type == "$c"sv)
-    return LeonardoParseC(line, info);
-
-  else if (type == "$D"sv || type == "$d"sv)
-    return LeonardoParseD(line, info);
+  using Handler = bool (*)(NMEAInputLine &line, NMEAInfo &info);
 
-  else if (type == "$PDGFTL1"sv || type == "$PDGFTTL"sv)
-    return PDGFTL1(line, info);
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$C", LeonardoParseC},
+    {"$c", LeonardoParseC},
+    {"$D", LeonardoParseD},
+    {"$d", LeonardoParseD},
+    {"$PDGFTL1", PDGFTL1},
+    {"$PDGFTTL", PDGFTL1},
+  });
 
-  else
-    return false;
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(line, info);
 }
 
 static Device *
@@ -22,6 +22,7 @@ public:
 
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, NMEAInfo &info) override;
   bool PutMacCready(double mc, OperationEnvironment &env) override;
   bool PutBallast(double fraction, double overload,
                   OperationEnvironment &env) override;
@@ -242,9 +243,12 @@ OpenVarioDevice::PutBugs(double bugs, OperationEnvironment &env)
 bool
 OpenVarioDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+OpenVarioDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
   if (line.ReadCompare("$POV"))
     return POV(line, info);
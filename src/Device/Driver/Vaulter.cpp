@@ -7,8 +7,7 @@
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Checksum.hpp"
-
-using std::string_view_literals::operator""sv;
+#include "NMEA/SentenceTable.hpp"
 
 static bool
 ParsePITV3(NMEAInputLine &line, NMEAInfo &info)
@@ -110,6 +109,7 @@ public:
 
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 
   bool PutMacCready(double mc, OperationEnvironment &env) override;
   bool PutBallast(double fraction, double overload,
@@ -141,20 +141,24 @@ VaulterDevice::PutBallast([[maybe_unused]] double fraction, double overload, Ope
 bool
 VaulterDevice::ParseNMEA(const char *_line, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(_line))
-    return false;
+  return VerifyNMEAChecksum(_line) && ParseVerifiedNMEA(_line, info);
+}
 
+bool
+VaulterDevice::ParseVerifiedNMEA(const char *_line, NMEAInfo &info)
+{
   NMEAInputLine line(_line);
 
-  const auto type = line.ReadView();
-  if (type == "$PITV3"sv)
-    return ParsePITV3(line, info);
-  else if (type == "$PITV4"sv)
-    return ParsePITV4(line, info);
-  else if (type == "$PITV5"sv)
-    return ParsePITV5(line, info);
-  else
-    return false;
+  using Handler = bool (*)(NMEAInputLine &line, NMEAInfo &info);
+
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$PITV3", ParsePITV3},
+    {"$PITV4", ParsePITV4},
+    {"$PITV5", ParsePITV5},
+  });
+
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(line, info);
 }
 
 static Device *
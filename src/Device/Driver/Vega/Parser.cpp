@@ -5,6 +5,7 @@
 #include "Message.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 
 #include <tchar.h>
 #include <algorithm>
@@ -204,26 +205,47 @@ VegaDevice::ParseNMEA(const char *String, NMEAInfo &info)
   if (type.starts_with("$PD"sv))
     detected = true;
 
-  if (type == "$PDSWC"sv)
-    return PDSWC(line, info, volatile_data);
-  else if (type == "$PDAAV"sv)
-    return PDAAV(line, info);
-  else if (type == "$PDVSC"sv)
-    return PDVSC(line, info);
-  else if (type == "$PDVDV"sv)
-    return PDVDV(line, info);
-  else if (type == "$PDVDS"sv)
-    return PDVDS(line, info);
-  else if (type == "$PDVVT"sv)
-    return PDVVT(line, info);
-  else if (type == "$PDVSD"sv) {
-    const auto message = line.Rest();
-    StaticString<256> buffer;
-    buffer.SetASCII(message);
-    Message::AddMessage(buffer);
-    return true;
-  } else if (type == "$PDTSM"sv)
-    return PDTSM(line, info);
-  else
-    return false;
+  using Handler = bool (*)(VegaDevice &device, NMEAInputLine &line,
+                           NMEAInfo &info);
+
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$PDSWC", [](VegaDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      return PDSWC(line, info, device.volatile_data);
+    }},
+
+    {"$PDAAV", [](VegaDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return PDAAV(line, info);
+    }},
+
+    {"$PDVSC", [](VegaDevice &device, NMEAInputLine &line, NMEAInfo &info){
+      return device.PDVSC(line, info);
+    }},
+
+    {"$PDVDV", [](VegaDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return PDVDV(line, info);
+    }},
+
+    {"$PDVDS", [](VegaDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return PDVDS(line, info);
+    }},
+
+    {"$PDVVT", [](VegaDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return PDVVT(line, info);
+    }},
+
+    {"$PDVSD", [](VegaDevice &, NMEAInputLine &line, NMEAInfo &){
+      const auto message = line.Rest();
+      StaticString<256> buffer;
+      buffer.SetASCII(message);
+      Message::AddMessage(buffer);
+      return true;
+    }},
+
+    {"$PDTSM", [](VegaDevice &, NMEAInputLine &line, NMEAInfo &info){
+      return PDTSM(line, info);
+    }},
+  });
+
+  const auto *handler = sentences.Find(type);
+  return handler != nullptr && (*handler)(*this, line, info);
 }
@@ -26,6 +26,7 @@ public:
 
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
   bool PutMacCready(double mac_cready, OperationEnvironment &env) override;
   bool PutBugs(double bugs, OperationEnvironment &env) override;
 };
@@ -119,9 +120,12 @@ PWES1(NMEAInputLine &line, NMEAInfo &info)
 bool
 WesterboerDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+WesterboerDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
   const auto type = line.ReadView();
@@ -33,4 +33,5 @@ public:
    * virtual methods from class Device
    */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 };
@@ -249,9 +249,12 @@ XCTracerDevice::XCTRC(NMEAInputLine &line, NMEAInfo &info)
 bool
 XCTracerDevice::ParseNMEA(const char *string, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(string))
-    return false;
+  return VerifyNMEAChecksum(string) && ParseVerifiedNMEA(string, info);
+}
 
+bool
+XCTracerDevice::ParseVerifiedNMEA(const char *string, NMEAInfo &info)
+{
   NMEAInputLine line(string);
 
   const auto type = line.ReadView();
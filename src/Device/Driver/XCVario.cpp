@@ -30,6 +30,7 @@ class XVCDevice : public AbstractDevice {
   XVCDevice(Port &_port):port(_port) {};
   // virtual methods from class Device
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
   bool PutMacCready(double mc, OperationEnvironment &env) override;
   bool PutBugs(double bugs, OperationEnvironment &env) override;
   bool PutBallast(double fraction, double overload, OperationEnvironment &env) override;
@@ -193,8 +194,12 @@ bool XVCDevice::EnableNMEA([[maybe_unused]] OperationEnvironment &env)
 bool
 XVCDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
+
+bool
+XVCDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
   const auto type = line.ReadView();
   if (type == "$PXCV"sv) {                // cyclic data from device useful for channel supervision
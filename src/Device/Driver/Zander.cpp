@@ -6,6 +6,7 @@
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
 #include "NMEA/Checksum.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Units/System.hpp"
 #include "util/StringAPI.hxx"
 
@@ -15,6 +16,7 @@ class ZanderDevice : public AbstractDevice {
 public:
   /* virtual methods from class Device */
   bool ParseNMEA(const char *line, struct NMEAInfo &info) override;
+  bool ParseVerifiedNMEA(const char *line, struct NMEAInfo &info) override;
 };
 
 static bool
@@ -109,30 +111,26 @@ PZAN5(NMEAInputLine &line, NMEAInfo &info)
 bool
 ZanderDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
-  if (!VerifyNMEAChecksum(String))
-    return false;
+  return VerifyNMEAChecksum(String) && ParseVerifiedNMEA(String, info);
+}
 
+bool
+ZanderDevice::ParseVerifiedNMEA(const char *String, NMEAInfo &info)
+{
   NMEAInputLine line(String);
 
-  const auto type = line.ReadView();
-
-  if (type == "$PZAN1"sv)
-    return PZAN1(line, info);
+  using Handler = bool (*)(NMEAInputLine &line, NMEAInfo &info);
 
-  else if (type == "$PZAN2"sv)
-    return PZAN2(line, info);
+  static constexpr auto sentences = MakeNMEASentenceTable<Handler>({
+    {"$PZAN1", PZAN1},
+    {"$PZAN2", PZAN2},
+    {"$PZAN3", PZAN3},
+    {"$PZAN4", PZAN4},
+    {"$PZAN5", PZAN5},
+  });
 
-  else if (type == "$PZAN3"sv)
-    return PZAN3(line, info);
-
-  else if (type == "$PZAN4"sv)
-    return PZAN4(line, info);
-
-  else if (type == "$PZAN5"sv)
-    return PZAN5(line, info);
-
-  else
-    return false;
+  const auto *handler = sentences.Find(line.ReadView());
+  return handler != nullptr && (*handler)(line, info);
 }
 
 static Device *
@@ -6,6 +6,7 @@
 #include "NMEA/Info.hpp"
 #include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Units/System.hpp"
 #include "Driver/FLARM/StaticParser.hpp"
 #include "util/CharUtil.hxx"
@@ -27,80 +28,115 @@ NMEAParser::Reset()
   last_time = {};
 }
 
+/**
+ * The signature of all entries in the sentence tables.
+ */
+using SentenceHandler = bool (*)(NMEAParser &parser, NMEAInputLine &line,
+                                 NMEAInfo &info);
+
+/**
+ * Adapts a #NMEAParser method to #SentenceHandler.
+ */
+template<bool (NMEAParser::*method)(NMEAInputLine &, NMEAInfo &)>
+static bool
+CallSentenceMethod(NMEAParser &parser, NMEAInputLine &line, NMEAInfo &info)
+{
+  return (parser.*method)(line, info);
+}
+
+/**
+ * Adapts a static #NMEAParser method to #SentenceHandler.
+ */
+template<bool (*function)(NMEAInputLine &, NMEAInfo &)>
+static bool
+CallSentenceFunction(NMEAParser &, NMEAInputLine &line, NMEAInfo &info)
+{
+  return function(line, info);
+}
+
+static bool
+HandlePFLAE(NMEAParser &, NMEAInputLine &line, NMEAInfo &info)
+{
+  ParsePFLAE(line, info.flarm.error, info.clock);
+  return true;
+}
+
+static bool
+HandlePFLAV(NMEAParser &, NMEAInputLine &line, NMEAInfo &info)
+{
+  ParsePFLAV(line, info.flarm.version, info.clock);
+  return true;
+}
+
+static bool
+HandlePFLAA(NMEAParser &, NMEAInputLine &line, NMEAInfo &info)
+{
+  ParsePFLAA(line, info.flarm.traffic, info.clock);
+  return true;
+}
+
+static bool
+HandlePFLAU(NMEAParser &, NMEAInputLine &line, NMEAInfo &info)
+{
+  ParsePFLAU(line, info.flarm.status, info.clock);
+  return true;
+}
+
 bool
 NMEAParser::ParseLine(const char *string, NMEAInfo &info)
+{
+  return NMEAChecksum(string) && ParseVerifiedLine(string, info);
+}
+
+bool
+NMEAParser::ParseVerifiedLine(const char *string, NMEAInfo &info)
 {
   assert(info.clock.IsDefined());
 
   if (string[0] != '$')
     return false;
 
-  if (!NMEAChecksum(string))
-    return false;
-
   NMEAInputLine line(string);
 
   const auto type = line.ReadView();
   if (type.size() < 6)
     return false;
 
-  if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2])) {
-    const auto type2 = type.substr(3);
-
-    if (type2 == "GSA"sv)
-      return GSA(line, info);
-
-    if (type2 == "GLL"sv)
-      return GLL(line, info);
-
-    if (type2 == "RMC"sv)
-      return RMC(line, info);
-
-    if (type2 == "GGA"sv)
-      return GGA(line, info);
-
-    if (type2 == "HDM"sv)
-      return HDM(line, info);
-
-    if (type2 == "MWV"sv)
-      return MWV(line, info);
-  }
-
-  // if (proprietary sentence) ...
-  if (type[1] == 'P') {
-    const auto type2 = type.substr(1);
-
-    // Airspeed and vario sentence
-    if (type2 == "PTAS1"sv)
-      return PTAS1(line, info);
-
-    // FLARM sentences
-    if (type2 == "PFLAE"sv) {
-      ParsePFLAE(line, info.flarm.error, info.clock);
-      return true;
-    }
-
-    if (type2 == "PFLAV"sv) {
-      ParsePFLAV(line, info.flarm.version, info.clock);
-      return true;
-    }
-
-    if (type2 == "PFLAA"sv) {
-      ParsePFLAA(line, info.flarm.traffic, info.clock);
-      return true;
-    }
-
-    if (type2 == "PFLAU"sv) {
-      ParsePFLAU(line, info.flarm.status, info.clock);
-      return true;
-    }
-
-    // Garmin altitude sentence
-    if (type2 == "PGRMZ"sv)
-      return RMZ(line, info);
-
-    return false;
-  }
+  /* sentences with a two-letter talker id (e.g. "GP" or "GN"),
+     looked up without it */
+  static constexpr auto talker_sentences =
+    MakeNMEASentenceTable<SentenceHandler>({
+      {"GSA", CallSentenceMethod<&NMEAParser::GSA>},
+      {"GLL", CallSentenceMethod<&NMEAParser::GLL>},
+      {"RMC", CallSentenceMethod<&NMEAParser::RMC>},
+      {"GGA", CallSentenceMethod<&NMEAParser::GGA>},
+      {"HDM", CallSentenceMethod<&NMEAParser::HDM>},
+      {"MWV", CallSentenceFunction<&NMEAParser::MWV>},
+    });
+
+  if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2]))
+    if (const auto *handler = talker_sentences.Find(type.substr(3)))
+      return (*handler)(*this, line, info);
+
+  /* proprietary sentences */
+  static constexpr auto proprietary_sentences =
+    MakeNMEASentenceTable<SentenceHandler>({
+      // Airspeed and vario sentence
+      {"PTAS1", CallSentenceFunction<&NMEAParser::PTAS1>},
+
+      // FLARM sentences
+      {"PFLAE", HandlePFLAE},
+      {"PFLAV", HandlePFLAV},
+      {"PFLAA", HandlePFLAA},
+      {"PFLAU", HandlePFLAU},
+
+      // Garmin altitude sentence
+      {"PGRMZ", CallSentenceMethod<&NMEAParser::RMZ>},
+    });
+
+  if (type[1] == 'P')
+    if (const auto *handler = proprietary_sentences.Find(type.substr(1)))
+      return (*handler)(*this, line, info);
 
   return false;
 }
@@ -44,6 +44,12 @@ public:
    */
   bool ParseLine(const char *line, NMEAInfo &info);
 
+  /**
+   * Like ParseLine(), but the caller has already verified the NMEA
+   * checksum (see VerifyNMEAChecksum()).
+   */
+  bool ParseVerifiedLine(const char *line, NMEAInfo &info);
+
 public:
   /**
    * Calculates the checksum of the provided NMEA string and
@@ -71,6 +71,10 @@ PortLineSplitter::DataReceived(std::span<const std::byte> s) noexcept
       if (!LineReceived(line))
         return false;
     }
+
+    /* the next buffer.Write() may overwrite the lines */
+    if (!FlushLines())
+      return false;
   } while (data < end);
 
   return true;
@@ -15,4 +15,15 @@ class PortLineSplitter : public DataHandler, protected PortLineHandler {
 public:
   /* virtual methods from class DataHandler */
   bool DataReceived(std::span<const std::byte> s) noexcept override;
+
+protected:
+  /**
+   * All complete lines in the buffer have been passed to
+   * LineReceived().  The pointers passed to it remain valid until
+   * this method returns, which allows the subclass to collect them
+   * and handle them all at once here.
+   */
+  virtual bool FlushLines() noexcept {
+    return true;
+  }
 };
@@ -183,7 +183,7 @@ MapItemListWidget::OnPaintItem(Canvas &canvas, const PixelRect rc,
 {
   const MapItem &item = *list[idx];
   renderer.Draw(canvas, rc, item,
-                &CommonInterface::Basic().flarm.traffic);
+                CommonInterface::GetTraffic().get());
 
   if ((settings.item_list.add_arrival_altitude &&
        item.type == MapItem::Type::ARRIVAL_ALTITUDE) ||
@@ -23,6 +23,8 @@ AirspacePolygon::AirspacePolygon(const std::vector<GeoPoint> &pts) noexcept
   if (p_start != p_end)
     m_border.emplace_back(p_start);
 
+  edges.Update(m_border);
+
   is_convex = TriState::UNKNOWN;
 }
 
@@ -55,7 +57,7 @@ AirspacePolygon::GetCenter() const noexcept
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const noexcept
 {
-  return m_border.IsInside(loc);
+  return edges.IsInside(loc);
 }
 
 AirspaceIntersectionVector
@@ -67,13 +69,9 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
 
   AirspaceIntersectSort sorter(start, *this);
 
-  for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
-
-    const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
-    auto t = ray.DistinctIntersection(r_seg);
-    if (t >= 0)
-      sorter.add(t, projection.Unproject(ray.Parametric(t)));
-  }
+  edges.VisitIntersections(ray, [&](double t){
+    sorter.add(t, projection.Unproject(ray.Parametric(t)));
+  });
 
   return sorter.all();
 }
@@ -86,3 +84,10 @@ AirspacePolygon::ClosestPoint(const GeoPoint &loc,
   const auto pb = m_border.NearestPoint(p);
   return projection.Unproject(pb);
 }
+
+void
+AirspacePolygon::Project(const FlatProjection &projection) noexcept
+{
+  AbstractAirspace::Project(projection);
+  edges.Project(m_border);
+}
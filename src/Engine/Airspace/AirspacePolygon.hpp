@@ -4,6 +4,8 @@
 #pragma once
 
 #include "AbstractAirspace.hpp"
+#include "Geo/PolygonEdgeArray.hpp"
+
 #include <vector>
 
 #ifdef DO_PRINT
@@ -12,6 +14,11 @@
 
 /** General polygon form airspace */
 class AirspacePolygon final : public AbstractAirspace {
+  /**
+   * A copy of #m_border optimised for Inside() and Intersects().
+   */
+  PolygonEdgeArray edges;
+
 public:
   /**
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -28,6 +35,7 @@ public:
    */
   void MakeConvex() noexcept {
     m_border.PruneInterior();
+    edges.Update(m_border);
     is_convex = TriState::TRUE;
   }
 
@@ -41,6 +49,9 @@ public:
   GeoPoint ClosestPoint(const GeoPoint &loc,
                         const FlatProjection &projection) const noexcept override;
 
+protected:
+  void Project(const FlatProjection &tp) noexcept override;
+
 public:
 #ifdef DO_PRINT
   friend std::ostream &operator<<(std::ostream &f,
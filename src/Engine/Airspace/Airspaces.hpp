@@ -49,6 +49,14 @@ public:
   Airspaces(const Airspaces &) = delete;
   Airspaces &operator=(const Airspaces &) = delete;
 
+  /**
+   * Returns the airspaces which have been added since the last
+   * Optimise() call, in the order they were added.
+   */
+  const std::deque<AirspacePtr> &GetPending() const noexcept {
+    return tmp_as;
+  }
+
   const Serial &GetSerial() const noexcept {
     return serial;
   }
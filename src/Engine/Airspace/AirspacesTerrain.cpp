@@ -4,17 +4,36 @@
 #include "Airspaces.hpp"
 #include "Terrain/RasterTerrain.hpp"
 
+#include <vector>
+
 void
 Airspaces::SetGroundLevels(const RasterTerrain &terrain) noexcept
 {
+  /* collect all airspaces which need the ground level, to look them
+     up with one batched terrain query */
+  std::vector<const Airspace *> items;
+  std::vector<GeoPoint> locations;
+
   for (auto &v : QueryAll()) {
     // If we don't need the ground level we don't have to calculate it
     if (!v.NeedGroundLevel())
       continue;
 
     FlatGeoPoint c_flat = v.GetCenter();
-    GeoPoint g = task_projection.Unproject(c_flat);
-    v.SetGroundLevel(terrain.GetTerrainHeight(g).GetValueOr0());
+    items.push_back(&v);
+    locations.push_back(task_projection.Unproject(c_flat));
   }
-}
 
+  if (items.empty())
+    return;
+
+  std::vector<TerrainHeight> heights(items.size());
+
+  {
+    RasterTerrain::Lease map(terrain);
+    map->GetHeights(locations, heights.data());
+  }
+
+  for (std::size_t i = 0; i < items.size(); ++i)
+    items[i]->SetGroundLevel(heights[i].GetValueOr0());
+}
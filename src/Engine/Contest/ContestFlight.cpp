@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ContestFlight.hpp"
+#include "ContestManager.hpp"
+#include "thread/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+using namespace std::chrono;
+
+/**
+ * Determine the trace size for the given number of fixes; the trace
+ * needs one spare slot, because it thins before inserting.
+ */
+static constexpr unsigned
+GetTraceSize(std::size_t n_points) noexcept
+{
+  return std::clamp<std::size_t>(n_points + 1, 4, ContestFlight::MAX_POINTS);
+}
+
+ContestFlight::ContestFlight(std::span<const TracePoint> points) noexcept
+  :full({}, Trace::null_time, GetTraceSize(points.size())),
+   triangle({}, Trace::null_time, GetTraceSize(points.size())),
+   sprint({}, minutes{150}, GetTraceSize(points.size()))
+{
+  for (const auto &i : points) {
+    full.push_back(i);
+    triangle.push_back(i);
+    sprint.push_back(i);
+  }
+}
+
+ContestStatistics
+ContestFlight::Solve(Contest contest, unsigned handicap) const noexcept
+{
+  /* on the heap, because worker threads may have small stacks */
+  const auto manager = std::make_unique<ContestManager>(contest, full,
+                                                        triangle, sprint);
+  manager->SetHandicap(handicap);
+  manager->SolveExhaustive();
+  return manager->GetStats();
+}
+
+void
+ContestFlight::Solve(std::span<const Contest> contests,
+                     std::span<ContestStatistics> results,
+                     unsigned handicap, ThreadPool *pool) const noexcept
+{
+  assert(results.size() == contests.size());
+
+  const auto run = [&](unsigned i){
+    results[i] = Solve(contests[i], handicap);
+  };
+
+  if (pool != nullptr)
+    /* Solve() doesn't throw, therefore ForEach() won't */
+    pool->ForEach(contests.size(), run);
+  else
+    for (unsigned i = 0; i < contests.size(); ++i)
+      run(i);
+}
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Trace/Trace.hpp"
+
+#include <span>
+
+enum class Contest : uint8_t;
+struct ContestStatistics;
+class ThreadPool;
+
+/**
+ * A complete flight for post-flight contest optimisation.  Unlike the
+ * in-flight #ContestManager setup, the traces are large enough to
+ * hold every fix (up to #MAX_POINTS), so the solvers work at the full
+ * resolution of the flight log instead of on a thinned trace.
+ *
+ * After construction, this object is read-only, and several contests
+ * may be solved on it concurrently.
+ */
+class ContestFlight {
+  Trace full, triangle, sprint;
+
+public:
+  /**
+   * The solvers address trace points with 16 bit indices (see
+   * #ScanTaskPoint), and one index is reserved for the predicted
+   * finish.  Longer flights are thinned to this size.
+   */
+  static constexpr unsigned MAX_POINTS = 0xfffe;
+
+  /**
+   * @param points all fixes of the flight (after release) in
+   * chronological order
+   */
+  explicit ContestFlight(std::span<const TracePoint> points) noexcept;
+
+  ContestFlight(const ContestFlight &) = delete;
+  ContestFlight &operator=(const ContestFlight &) = delete;
+
+  const Trace &GetFull() const noexcept {
+    return full;
+  }
+
+  /**
+   * Find the exhaustive solution for one contest.
+   */
+  ContestStatistics Solve(Contest contest,
+                          unsigned handicap=100) const noexcept;
+
+  /**
+   * Solve several contests, in parallel if a #ThreadPool is given.
+   * The result for contests[i] is stored in results[i].
+   */
+  void Solve(std::span<const Contest> contests,
+             std::span<ContestStatistics> results,
+             unsigned handicap=100,
+             ThreadPool *pool=nullptr) const noexcept;
+};
@@ -2,6 +2,11 @@
 // Copyright The XCSoar Project
 
 #include "ContestManager.hpp"
+#include "thread/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
 
 ContestManager::ContestManager(const Contest _contest,
                                const Trace &trace_full,
@@ -140,6 +145,29 @@ RunContest(AbstractContest &_contest,
   return true;
 }
 
+bool
+ContestManager::RunIndependent(std::span<AbstractContest *const> solvers,
+                               bool exhaustive) noexcept
+{
+  std::array<bool, 3> found{};
+  assert(solvers.size() <= found.size());
+
+  const auto run = [&](unsigned i){
+    found[i] = RunContest(*solvers[i], stats.result[i],
+                          stats.solution[i], exhaustive);
+  };
+
+  if (thread_pool != nullptr && solvers.size() > 1)
+    /* RunContest() doesn't throw, therefore ForEach() won't */
+    thread_pool->ForEach(solvers.size(), run);
+  else
+    for (unsigned i = 0; i < solvers.size(); ++i)
+      run(i);
+
+  return std::any_of(found.begin(), found.end(),
+                     [](bool b){ return b; });
+}
+
 bool
 ContestManager::UpdateIdle(bool exhaustive) noexcept
 {
@@ -174,12 +202,9 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
                          stats.solution[0], exhaustive);
     break;
 
-  case Contest::OLC_PLUS:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(olc_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
+  case Contest::OLC_PLUS: {
+    AbstractContest *const solvers[] = { &olc_classic, &olc_fai };
+    retval = RunIndependent(solvers, exhaustive);
 
     if (retval) {
       olc_plus.Feed(stats.result[0], stats.solution[0],
@@ -190,25 +215,24 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     }
 
     break;
+  }
 
   case Contest::DMST:
     retval = RunContest(dmst_quad, stats.result[0],
                         stats.solution[0], exhaustive);
     break;
 
-  case Contest::XCONTEST:
-    retval = RunContest(xcontest_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(xcontest_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+  case Contest::XCONTEST: {
+    AbstractContest *const solvers[] = { &xcontest_free, &xcontest_triangle };
+    retval = RunIndependent(solvers, exhaustive);
     break;
+  }
 
-  case Contest::DHV_XC:
-    retval = RunContest(dhv_xc_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(dhv_xc_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+  case Contest::DHV_XC: {
+    AbstractContest *const solvers[] = { &dhv_xc_free, &dhv_xc_triangle };
+    retval = RunIndependent(solvers, exhaustive);
     break;
+  }
 
   case Contest::SIS_AT:
     retval = RunContest(sis_at, stats.result[0],
@@ -220,15 +244,11 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
                         stats.solution[0], exhaustive);
     break;
 
-  case Contest::WEGLIDE_FREE:
-    retval = RunContest(weglide_distance, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(weglide_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
-
-    retval |= RunContest(weglide_or, stats.result[2],
-                         stats.solution[2], exhaustive);
+  case Contest::WEGLIDE_FREE: {
+    AbstractContest *const solvers[] = {
+      &weglide_distance, &weglide_fai, &weglide_or,
+    };
+    retval = RunIndependent(solvers, exhaustive);
 
     if (retval) {
       weglide_free.Feed(stats.result[0], stats.solution[0],
@@ -239,6 +259,7 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
                  stats.solution[3], exhaustive);
     }
     break;
+  }
 
   case Contest::WEGLIDE_DISTANCE:
     retval = RunContest(weglide_distance, stats.result[0],
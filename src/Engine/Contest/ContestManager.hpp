@@ -21,7 +21,10 @@
 #include "Solvers/Charron.hpp"
 #include "ContestStatistics.hpp"
 
+#include <span>
+
 class Trace;
+class ThreadPool;
 
 /**
  * Special task holder for Online Contest calculations
@@ -53,6 +56,13 @@ class ContestManager
   Charron charron_small;
   Charron charron_large;
 
+  /**
+   * If set, then the independent solvers of contests which combine
+   * several of them (e.g. OLC Plus, WeGlide Free) run in parallel on
+   * this pool.
+   */
+  ThreadPool *thread_pool = nullptr;
+
 public:
   /**
    * Base constructor.
@@ -87,6 +97,15 @@ public:
 
   void SetHandicap(unsigned handicap) noexcept;
 
+  /**
+   * Run independent solvers on the given #ThreadPool.  The caller
+   * retains ownership; pass nullptr to run all solvers in the calling
+   * thread.
+   */
+  void SetThreadPool(ThreadPool *_thread_pool) noexcept {
+    thread_pool = _thread_pool;
+  }
+
   /**
    * Update internal states (non-essential) for housework,
    * or where functions are slow and would cause loss to real-time performance.
@@ -124,4 +143,17 @@ public:
   const ContestStatistics &GetStats() const noexcept {
     return stats;
   }
+
+private:
+  /**
+   * Run the given solvers, which must not depend on each other;
+   * solver #i stores its result in #stats slot #i.  They run in
+   * parallel if a #ThreadPool was set.  All solvers only read their
+   * master #Trace, which is safe because it is appended to only by
+   * the calling thread, which is blocked meanwhile.
+   *
+   * @return true if at least one solver found a new solution
+   */
+  bool RunIndependent(std::span<AbstractContest *const> solvers,
+                      bool exhaustive) noexcept;
 };
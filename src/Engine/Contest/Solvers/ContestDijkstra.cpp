@@ -5,6 +5,7 @@
 #include "../ContestResult.hpp"
 #include "Trace/Trace.hpp"
 #include "Cast.hpp"
+#include "util/Compiler.h"
 
 #include <algorithm>
 #include <cassert>
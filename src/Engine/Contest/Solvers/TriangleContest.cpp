@@ -5,6 +5,10 @@
 #include "Cast.hpp"
 #include "Trace/Trace.hpp"
 #include "util/QuadTree.hxx"
+#include "util/Compiler.h"
+
+#include <algorithm>
+#include <vector>
 
 /*
  @todo potential to use 3d convex hull to speed search
@@ -58,6 +62,7 @@ TriangleContest::Reset() noexcept
 
   closing_pairs.Clear();
   ClearTrace();
+  bounds.Clear();
 
   ResetBranchAndBound();
   AbstractContest::Reset();
@@ -85,6 +90,24 @@ CalcLegDistance(const ContestTraceVector &solution,
   return p_start.Distance(p_dest);
 }
 
+inline void
+TriangleContest::UpdateBounds() noexcept
+{
+  bounds.Update(n_points, [this](unsigned i){
+    return GetPoint(i).GetFlatLocation();
+  });
+}
+
+unsigned
+TriangleContest::GetMaxPerimeter(unsigned first, unsigned last) const noexcept
+{
+  /* a triangle inside a rectangle can't be longer than the
+     rectangle's perimeter; add a little for rounding errors in
+     CandidateSet */
+  const auto box = bounds.Get(first, last + 1);
+  return 2 * (box.GetWidth() + box.GetHeight()) + 3;
+}
+
 inline void
 TriangleContest::UpdateTrace(bool force) noexcept
 {
@@ -92,6 +115,7 @@ TriangleContest::UpdateTrace(bool force) noexcept
 
   if (force || IsMasterUpdated(false)) {
     UpdateTraceFull();
+    UpdateBounds();
 
     is_complete = false;
 
@@ -103,6 +127,7 @@ TriangleContest::UpdateTrace(bool force) noexcept
    } else if (is_complete && incremental) {
     const unsigned old_size = n_points;
     if (UpdateTraceTail()) {
+      UpdateBounds();
       is_complete = false;
       is_closed = FindClosingPairs(old_size);
     }
@@ -186,16 +211,30 @@ TriangleContest::SolveTriangle(bool exhaustive) noexcept
       relaxed_pairs.Insert({relax_first, relax_last});
     }
 
-    // TODO: reverse sort relaxed pairs according to number of contained points
+    /* search the relaxed pairs with the largest bounding boxes
+       first; a large triangle found early raises the bound for all
+       others, and those whose bounding box can't contain a larger
+       triangle are skipped altogether */
+    std::vector<std::pair<unsigned, ClosingPair>> sorted_pairs;
+    sorted_pairs.reserve(relaxed_pairs.closing_pairs.size());
+    for (const auto &i : relaxed_pairs.closing_pairs)
+      sorted_pairs.emplace_back(GetMaxPerimeter(i.first, i.second), i);
+
+    std::stable_sort(sorted_pairs.begin(), sorted_pairs.end(),
+                     [](const auto &a, const auto &b){
+                       return a.first > b.first;
+                     });
 
     ClosingPairs close_look;
 
 #if GCC_CHECK_VERSION(12,0)
-    // yes, we do want relaxed_pair to be a copy
+    // yes, we do want closing_pair to be a copy
 #pragma GCC diagnostic ignored "-Wrange-loop-construct"
 #endif
 
-    for (const auto relaxed_pair : relaxed_pairs.closing_pairs) {
+    for (const auto &[max_perimeter, relaxed_pair] : sorted_pairs) {
+      if (max_perimeter <= best_triangle.distance)
+        break;
 
       const auto triangle = RunBranchAndBound(relaxed_pair.first,
                                               relaxed_pair.second,
@@ -223,6 +262,10 @@ TriangleContest::SolveTriangle(bool exhaustive) noexcept
     }
 
     for (const auto &close_look_pair : close_look.closing_pairs) {
+      if (GetMaxPerimeter(close_look_pair.first,
+                          close_look_pair.second) <= best_triangle.distance)
+        continue;
+
       const auto triangle = RunBranchAndBound(close_look_pair.first,
                                               close_look_pair.second,
                                               best_triangle.distance, exhaustive);
@@ -8,6 +8,7 @@
 #include "TraceManager.hpp"
 #include "Trace/Point.hpp"
 #include "Geo/Flat/FlatBoundingBox.hpp"
+#include "Geo/Flat/FlatRangeBounds.hpp"
 
 #include <map>
 #include <utility> // for std::swap()
@@ -120,6 +121,13 @@ private:
 
   ClosingPairs closing_pairs;
 
+  /**
+   * Bounding boxes of trace index ranges, updated together with the
+   * working trace.  This avoids iterating over all trace points of a
+   * #TurnPointRange each time the search splits one.
+   */
+  FlatRangeBounds bounds;
+
   struct Candidate {
     unsigned tp1, tp2, tp3;
     unsigned distance;
@@ -145,11 +153,7 @@ private:
     TurnPointRange(const TriangleContest &parent,
                    const unsigned min, const unsigned max) noexcept
       :index_min(min), index_max(max),
-       bounding_box(FlatBoundingBox(parent.GetPoint(min).GetFlatLocation()))
-    {
-      for (unsigned i = min + 1; i < max; ++i)
-        bounding_box.Expand(parent.GetPoint(i).GetFlatLocation());
-    }
+       bounding_box(parent.bounds.Get(min, max)) {}
 
     bool operator==(TurnPointRange other) const noexcept {
       return (index_min == other.index_min && index_max == other.index_max);
@@ -274,6 +278,14 @@ private:
                               bool exhaustive) noexcept;
 
   void UpdateTrace(bool force) noexcept override;
+  void UpdateBounds() noexcept;
+
+  /**
+   * Calculate an upper bound for the flat distance of all triangles
+   * within the trace index range [first, last].
+   */
+  [[gnu::pure]]
+  unsigned GetMaxPerimeter(unsigned first, unsigned last) const noexcept;
   void ResetBranchAndBound() noexcept;
 
   void CheckAddCandidate(unsigned worst_d,
@@ -3,9 +3,14 @@
 
 #pragma once
 
+#include "util/AllocatedArray.hxx"
 #include "util/ReservablePriorityQueue.hpp"
 
-#include <unordered_map>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
 struct AStarPriorityValue
 {
@@ -55,21 +60,45 @@ template <class Node, class Hash=std::hash<Node>,
           bool m_min=true>
 class AStar
 {
-  typedef std::unordered_map<Node, AStarPriorityValue, Hash, KeyEqual> node_value_map;
-
-  typedef typename node_value_map::iterator node_value_iterator;
+  /**
+   * The value and the predecessor of one node.  Records are only ever
+   * appended to #records (until Clear() is called), therefore their
+   * index is stable and can be stored in the priority queue.
+   */
+  struct NodeRecord {
+    Node node;
+
+    /**
+     * The best predecessor found so far.  Equals #node for the start
+     * node.
+     */
+    Node parent;
+
+    /**
+     * The best value found so far.  It is updated by Push(), if a
+     * value lower than the current one is found.
+     */
+    AStarPriorityValue value;
+
+    constexpr NodeRecord(const Node &_node, const Node &_parent,
+                         const AStarPriorityValue &_value) noexcept
+      :node(_node), parent(_parent), value(_value) {}
+  };
 
-  typedef std::unordered_map<Node, Node, Hash, KeyEqual> node_parent_map;
+  static constexpr unsigned NO_RECORD = ~0u;
 
   struct NodeValue {
     AStarPriorityValue priority;
 
-    node_value_iterator iterator;
+    /**
+     * Index into #records.
+     */
+    unsigned record;
 
     constexpr
     NodeValue(const AStarPriorityValue &_priority,
-              node_value_iterator _iterator) noexcept
-      :priority(_priority), iterator(_iterator) {}
+              unsigned _record) noexcept
+      :priority(_priority), record(_record) {}
   };
 
   struct Rank {
@@ -80,23 +109,35 @@ class AStar
   };
 
   /**
-   * Stores the value of each node.  It is updated by push(), if a
-   * value lower than the current one is found.
+   * All nodes visited by this search, in the order of their
+   * discovery.  The allocation is kept by Clear(), so the next search
+   * does not need to touch the heap until it outgrows the previous
+   * one.
    */
-  node_value_map node_values;
+  std::vector<NodeRecord> records;
 
   /**
-   * Stores the predecessor of each node.  It is maintained by
-   * set_predecessor().
+   * An open-addressing (linear probing) hash table mapping nodes to
+   * indices into #records, or #NO_RECORD for empty slots.  Its size
+   * is a power of two and at least twice the number of records.
    */
-  node_parent_map node_parents;
+  AllocatedArray<unsigned> slots;
+
+  /**
+   * The number of bits to shift the mixed hash value right to obtain
+   * a slot index; 64 minus log2 of the size of #slots.
+   */
+  unsigned slot_shift = 64;
 
   /**
    * A sorted list of all possible node paths, lowest distance first.
    */
   reservable_priority_queue<NodeValue, std::vector<NodeValue>, Rank> q;
 
-  node_value_iterator cur;
+  /**
+   * The record consumed by the last Pop() call.
+   */
+  unsigned cur = NO_RECORD;
 
 public:
   static constexpr unsigned DEFAULT_QUEUE_SIZE = 1024;
@@ -126,15 +167,19 @@ public:
     Push(node, node, AStarPriorityValue(0));
   }
 
-  /** Clears the queues */
+  /**
+   * Clears the queues.  This does not free any memory; the buffers
+   * remain sized for the largest search so far.
+   */
   void Clear() noexcept {
     // Clear the search queue
     q.clear();
 
-    // Clear the node_parent_map
-    node_parents.clear();
-    // Clear the node_value_map
-    node_values.clear();
+    // Clear the node table
+    if (!records.empty())
+      std::fill(slots.begin(), slots.end(), NO_RECORD);
+    records.clear();
+    cur = NO_RECORD;
   }
 
   /**
@@ -150,17 +195,21 @@ public:
   /**
    * Return top element of queue for processing
    *
-   * @return Node for processing
+   * @return Node for processing; the reference is invalidated by the
+   * next Link() call
    */
   const Node &Pop() noexcept {
-    cur = q.top().iterator;
+    assert(!q.empty());
+
+    cur = q.top().record;
 
     do { // remove this item
       q.pop();
-    } while (!q.empty() && (q.top().priority > q.top().iterator->second));
+    } while (!q.empty() &&
+             (q.top().priority > records[q.top().record].value));
     // and all lower rank than this
 
-    return cur->first;
+    return records[cur].node;
   }
 
   /**
@@ -185,9 +234,8 @@ public:
    */
   [[gnu::pure]]
   Node GetPredecessor(const Node &node) const noexcept {
-    // Try to find the given node in the node_parent_map
-    const auto it = node_parents.find(node);
-    if (it == node_parents.end())
+    const unsigned i = Find(node);
+    if (i == NO_RECORD)
       // first entry
       // If the node wasn't found
       // -> Return the given node itself
@@ -195,12 +243,16 @@ public:
 
     // If the node was found
     // -> Return the parent node
-    return it->second;
+    return records[i].parent;
   }
 
   /** Reserve queue size (if available) */
   void Reserve(unsigned size) noexcept {
     q.reserve(size);
+    records.reserve(size);
+
+    if (slots.size() < 2 * std::size_t(size))
+      Rehash(2 * std::size_t(size));
   }
 
   /**
@@ -209,17 +261,74 @@ public:
    */
   [[gnu::pure]]
   AStarPriorityValue GetNodeValue(const Node &node) const noexcept {
-    if (cur->first == node)
-      return cur->second;
+    if (cur != NO_RECORD && KeyEqual()(records[cur].node, node))
+      return records[cur].value;
 
-    const auto it = node_values.find(node);
-    if (it == node_values.end())
+    const unsigned i = Find(node);
+    if (i == NO_RECORD)
       return AStarPriorityValue(0);
 
-    return it->second;
+    return records[i].value;
   }
 
 private:
+  /**
+   * Calculate the first slot to be probed for the given node.  The
+   * hash is mixed (Fibonacci hashing), because the hashers used with
+   * this class are cheap and have poor low-order bits.
+   */
+  [[gnu::pure]]
+  std::size_t GetSlot(const Node &node) const noexcept {
+    const uint64_t h = uint64_t(Hash()(node)) * UINT64_C(0x9e3779b97f4a7c15);
+    return std::size_t(h >> slot_shift);
+  }
+
+  [[gnu::pure]]
+  std::size_t NextSlot(std::size_t slot) const noexcept {
+    return (slot + 1) & (slots.size() - 1);
+  }
+
+  /**
+   * Look up the record of the given node.
+   *
+   * @return an index into #records or #NO_RECORD
+   */
+  [[gnu::pure]]
+  unsigned Find(const Node &node) const noexcept {
+    if (slots.empty())
+      return NO_RECORD;
+
+    for (std::size_t slot = GetSlot(node);; slot = NextSlot(slot)) {
+      const unsigned i = slots[slot];
+      if (i == NO_RECORD || KeyEqual()(records[i].node, node))
+        return i;
+    }
+  }
+
+  /**
+   * Resize the hash table to (at least) the given number of slots and
+   * re-insert all records.
+   */
+  void Rehash(std::size_t min_size) noexcept {
+    std::size_t size = 16;
+    unsigned shift = 60;
+    while (size < min_size) {
+      size <<= 1;
+      --shift;
+    }
+
+    slots.ResizeDiscard(size);
+    slot_shift = shift;
+    std::fill(slots.begin(), slots.end(), NO_RECORD);
+
+    for (unsigned i = 0; i < records.size(); ++i) {
+      std::size_t slot = GetSlot(records[i].node);
+      while (slots[slot] != NO_RECORD)
+        slot = NextSlot(slot);
+      slots[slot] = i;
+    }
+  }
+
   /**
    * Add node to search queue
    *
@@ -229,37 +338,39 @@ private:
    */
   void Push(const Node &node, const Node &parent,
             const AStarPriorityValue &edge_value) noexcept {
-    // Try to find the given node n in the node_value_map
-    const auto [it, inserted] = node_values.try_emplace(node, edge_value);
-    if (inserted) {
-      // first entry
-      // If the node wasn't found
-      // -> Insert a new node into the node_value_map
-
-      // Remember the parent node
-      SetPredecessor(node, parent);
-    } else if (it->second > edge_value) {
-      // If the node was found and the new value is smaller
-      // -> Replace the value with the new one
-      it->second = edge_value;
-      // replace, it's bigger
-
-      // Remember the new parent node
-      SetPredecessor(node, parent);
-    } else
-      // If the node was found but the value is higher or equal
-      // -> Don't use this new leg
-      return;
-
-    q.push(NodeValue(edge_value, it));
-  }
-
-  void SetPredecessor(const Node &node, const Node &parent) noexcept {
-    // Try to find the given node in the node_parent_map
-    auto result = node_parents.try_emplace(node, parent);
-    if (!result.second)
-      // If the node was found
-      // -> Replace the according parent node with the new one
-      result.first->second = parent;
+    /* keep the load factor at or below 50% */
+    if (2 * (records.size() + 1) > slots.size())
+      Rehash(2 * slots.size());
+
+    std::size_t slot = GetSlot(node);
+    while (true) {
+      const unsigned i = slots[slot];
+      if (i == NO_RECORD) {
+        // first entry
+        // If the node wasn't found
+        // -> Insert a new record, remembering the parent node
+        slots[slot] = records.size();
+        records.emplace_back(node, parent, edge_value);
+        q.push(NodeValue(edge_value, slots[slot]));
+        return;
+      }
+
+      NodeRecord &record = records[i];
+      if (KeyEqual()(record.node, node)) {
+        if (!(record.value > edge_value))
+          // If the node was found but the value is higher or equal
+          // -> Don't use this new leg
+          return;
+
+        // If the node was found and the new value is smaller
+        // -> Replace the value and the parent node with the new ones
+        record.value = edge_value;
+        record.parent = parent;
+        q.push(NodeValue(edge_value, i));
+        return;
+      }
+
+      slot = NextSlot(slot);
+    }
   }
 };
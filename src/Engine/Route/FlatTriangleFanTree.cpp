@@ -155,11 +155,20 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint o,
     return;
   }
 
-  for (const auto &x : fan.GetVertices()) {
+  const auto vertices = fan.GetVertices();
+
+  auto &locations = parms.terrain_locations;
+  locations.clear();
+  for (const auto &x : vertices) {
     const FlatGeoPoint av = (o + x) * 0.5;
-    const GeoPoint p = parms.projection.Unproject(av);
-    const auto h = parms.terrain->GetHeight(p);
+    locations.push_back(parms.projection.Unproject(av));
+  }
+
+  auto &heights = parms.terrain_heights;
+  heights.resize(locations.size());
+  parms.terrain->GetHeights(locations, heights.data());
 
+  for (const auto h : heights) {
     if (h.IsWater())
       /* water: assume 0m MSL */
       parms.terrain_counter++;
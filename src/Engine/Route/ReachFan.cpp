@@ -5,9 +5,22 @@
 #include "Terrain/RasterMap.hpp"
 #include "ReachFanParms.hpp"
 #include "ReachResult.hpp"
+#include "RouteLink.hpp"
 
 static constexpr int MIN_FLOOR_CLEARANCE = 100;
 
+/**
+ * The maximum distance (m) from the previous origin for reusing a
+ * fan, see ReachFan::IsReusable().
+ */
+static constexpr double MAX_REUSE_DISTANCE = 250;
+
+/**
+ * The maximum height (m) which may be wasted by reusing a fan.  Above
+ * that, the reach would be underestimated too much.
+ */
+static constexpr int MAX_REUSE_HEIGHT_MARGIN = 30;
+
 void
 ReachFan::Reset() noexcept
 {
@@ -21,6 +34,13 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
 {
   Reset();
 
+  last_origin = origin;
+  last_rpolars = rpolars;
+  last_terrain = terrain;
+  if (terrain != nullptr)
+    last_terrain_serial = terrain->GetSerial();
+  last_do_solve = do_solve;
+
   // initialise projection
   projection = FlatProjection(origin);
 
@@ -62,6 +82,35 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
   return true;
 }
 
+bool
+ReachFan::IsReusable(const AGeoPoint origin, const RoutePolars &rpolars,
+                     const RasterMap *terrain,
+                     const bool do_solve) const noexcept
+{
+  if (root.IsEmpty() || do_solve != last_do_solve ||
+      terrain != last_terrain ||
+      (terrain != nullptr && terrain->GetSerial() != last_terrain_serial) ||
+      !rpolars.HasSamePerformance(last_rpolars))
+    return false;
+
+  /* glide from the new origin back to the previous one */
+  const RouteLink link(RoutePoint(projection.ProjectInteger(last_origin),
+                                  (int)last_origin.altitude),
+                       RoutePoint(projection.ProjectInteger(origin),
+                                  (int)origin.altitude),
+                       projection);
+  if (link.d > MAX_REUSE_DISTANCE)
+    return false;
+
+  const int arrival = link.second.altitude - (int)rpolars.CalcVHeight(link);
+  if (arrival < link.first.altitude ||
+      arrival > link.first.altitude + MAX_REUSE_HEIGHT_MARGIN)
+    return false;
+
+  return terrain == nullptr ||
+    !rpolars.CheckClearance(link, *terrain, projection);
+}
+
 std::optional<ReachResult>
 ReachFan::FindPositiveArrival(const AGeoPoint dest,
                               const RoutePolars &rpolars) const noexcept
@@ -4,11 +4,13 @@
 #pragma once
 
 #include "Geo/Flat/FlatProjection.hpp"
+#include "Geo/GeoPoint.hpp"
 #include "FlatTriangleFanTree.hpp"
+#include "RoutePolars.hpp"
+#include "util/Serial.hpp"
 
 #include <optional>
 
-class RoutePolars;
 class RasterMap;
 class GeoBounds;
 struct ReachResult;
@@ -19,6 +21,15 @@ class ReachFan
   FlatTriangleFanTree root;
   int terrain_base = 0;
 
+  /**
+   * The parameters of the last Solve() call, for IsReusable().
+   */
+  AGeoPoint last_origin;
+  RoutePolars last_rpolars;
+  const RasterMap *last_terrain = nullptr;
+  Serial last_terrain_serial;
+  bool last_do_solve = false;
+
 public:
   friend class PrintHelper;
 
@@ -35,6 +46,22 @@ public:
   bool Solve(const AGeoPoint origin, const RoutePolars &rpolars,
              const RasterMap *terrain, const bool do_solve = true) noexcept;
 
+  /**
+   * Can this fan be used instead of calling Solve() with the given
+   * parameters?  This is the case if the performance model and the
+   * terrain have not changed, and if the aircraft is close to the
+   * previous origin and can glide there, arriving at (or slightly
+   * above) the previous altitude.  Everything reachable from the
+   * previous origin is then reachable from the new one, i.e. the
+   * result is conservative.
+   *
+   * The caller must hold the terrain lock.
+   */
+  [[gnu::pure]]
+  bool IsReusable(const AGeoPoint origin, const RoutePolars &rpolars,
+                  const RasterMap *terrain,
+                  const bool do_solve = true) const noexcept;
+
   /**
    * Find arrival height at destination.
    *
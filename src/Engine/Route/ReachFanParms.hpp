@@ -4,6 +4,10 @@
 #pragma once
 
 #include "Route/RoutePolars.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Terrain/Height.hpp"
+
+#include <vector>
 
 class FlatProjection;
 class RasterMap;
@@ -18,6 +22,13 @@ struct ReachFanParms {
   unsigned vertex_counter = 0;
   unsigned char set_depth = 0;
 
+  /**
+   * Scratch buffers for RasterMap::GetHeights(), kept here to avoid
+   * allocating them for each fan.
+   */
+  std::vector<GeoPoint> terrain_locations;
+  std::vector<TerrainHeight> terrain_heights;
+
   ReachFanParms(const RoutePolars& _rpolars,
                 const FlatProjection &_projection,
                 const short _terrain_base,
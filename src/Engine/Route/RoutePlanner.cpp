@@ -17,8 +17,7 @@ RoutePlanner::Reset() noexcept
   destination_last = AFlatGeoPoint(0, 0, 0);
   dirty = true;
   solution_route.clear();
-  planner.Clear();
-  unique_links.clear();
+  CancelSolve();
   h_min = -1;
   h_max = 0;
   search_hull.clear();
@@ -26,8 +25,14 @@ RoutePlanner::Reset() noexcept
 
 bool
 RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
-                    const RoutePlannerConfig &config, const int h_ceiling) noexcept
+                    const RoutePlannerConfig &config, const int h_ceiling,
+                    const unsigned max_steps) noexcept
 {
+  if (solving)
+    /* resume the suspended search; its projection, end points and
+       performance model must not change */
+    return ContinueSolve(max_steps);
+
   OnSolve(origin, destination);
   rpolars_route.SetConfig(config, std::max(destination.altitude, origin.altitude),
                           h_ceiling);
@@ -53,12 +58,12 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
     h_max = rpolars_route.cruise_altitude;
   }
 
-  solution_route.clear();
-  solution_route.push_back(origin);
-  solution_route.push_back(destination);
-
-  if (!rpolars_route.IsTerrainEnabled() && !rpolars_route.IsAirspaceEnabled())
+  if (!rpolars_route.IsTerrainEnabled() && !rpolars_route.IsAirspaceEnabled()) {
+    solution_route.clear();
+    solution_route.push_back(origin);
+    solution_route.push_back(destination);
     return false; // trivial
+  }
 
   search_hull.clear();
   search_hull.emplace_back(origin_last, projection);
@@ -67,17 +72,36 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
   astar_goal = destination_last;
 
   RouteLink e_test(start, astar_goal, projection);
-  if (e_test.IsShort())
-    return false;
-  if (!rpolars_route.IsAchievable(e_test))
+  if (e_test.IsShort() || !rpolars_route.IsAchievable(e_test)) {
+    solution_route.clear();
+    solution_route.push_back(origin);
+    solution_route.push_back(destination);
     return false;
+  }
 
-  bool retval = false;
+  /* the previous solution remains visible until this search is
+     finished */
+  solve_origin = origin;
+  solve_destination = destination;
+  solving = true;
   planner.Restart(start);
 
+  return ContinueSolve(max_steps);
+}
+
+bool
+RoutePlanner::ContinueSolve(unsigned max_steps) noexcept
+{
+  assert(solving);
+
+  bool retval = false;
   unsigned best_d = UINT_MAX;
 
   while (!planner.IsEmpty()) {
+    if (max_steps-- == 0)
+      // out of time; suspend the search
+      return false;
+
     const RoutePoint node = planner.Pop();
 
     h_min = std::min(h_min, node.altitude);
@@ -121,22 +145,29 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
     for (auto &i : solution_route) {
       FlatGeoPoint p(projection.ProjectInteger(i));
       if (p == origin_last) {
-        i = AGeoPoint(origin, i.altitude);
+        i = AGeoPoint(solve_origin, i.altitude);
       } else if (p == destination_last) {
-        i = AGeoPoint(destination, i.altitude);
+        i = AGeoPoint(solve_destination, i.altitude);
       }
     }
 
   } else {
     solution_route.clear();
-    solution_route.push_back(origin);
-    solution_route.push_back(destination);
+    solution_route.push_back(solve_origin);
+    solution_route.push_back(solve_destination);
   }
 
+  CancelSolve();
+  return retval;
+}
+
+void
+RoutePlanner::CancelSolve() noexcept
+{
+  solving = false;
   planner.Clear();
   unique_links.clear();
   // m_search_hull.clear();
-  return retval;
 }
 
 unsigned
@@ -314,6 +345,11 @@ RoutePlanner::UpdatePolar(const GlideSettings &settings,
                           const GlidePolar &task_polar,
                           const SpeedVector &wind) noexcept
 {
+  if (solving)
+    /* keep the configuration and ceiling of the suspended search;
+       the next search will see the new model */
+    return;
+
   rpolars_route.SetConfig(config);
   rpolars_route.Initialise(settings, task_polar, wind);
 }
@@ -49,6 +49,11 @@ class GlidePolar;
  * Failures of the solver result in the route reverting to direct flight from
  * origin to destination.
  *
+ * A search may be split into several time slices by limiting the
+ * number of nodes expanded per Solve() call.  An interrupted search
+ * is resumed by the next Solve() call; meanwhile, GetSolution()
+ * returns the previous solution.
+ *
  * See AirspaceRoute for an extension of RoutePlanner which avoids terrain as
  * well as airspace.
  */
@@ -118,6 +123,15 @@ private:
   /** Destination at last call to solve() */
   AFlatGeoPoint destination_last;
 
+  /**
+   * The origin and destination of the search in progress (exact
+   * values, not rounded to the #projection).
+   */
+  AGeoPoint solve_origin, solve_destination;
+
+  /** Is a search in progress?  See IsSolving() */
+  bool solving = false;
+
 protected:
   RoutePoint astar_goal;
 
@@ -140,12 +154,34 @@ public:
    * @param destination The end of the search (current aircraft location)
    * @param config Control parameters for performance model constraints
    * @param h_ceiling Imposed absolute ceiling (m)
+   * @param max_steps the maximum number of search nodes to be
+   * expanded by this call; if the search is not finished after that,
+   * it is suspended and will be resumed by the next call (see
+   * IsSolving()), which ignores all other parameters and keeps
+   * using the configuration and ceiling of the first call
    *
    * @return True if new solution was found
    */
   bool Solve(const AGeoPoint &origin, const AGeoPoint &destination,
              const RoutePlannerConfig &config,
-             int h_ceiling = INT_MAX) noexcept;
+             int h_ceiling = INT_MAX,
+             unsigned max_steps = UINT_MAX) noexcept;
+
+  /**
+   * Was the last Solve() call suspended because it exceeded its
+   * "max_steps" budget?  If yes, the next Solve() call resumes this
+   * search instead of starting a new one, and its origin and
+   * destination are ignored.
+   */
+  bool IsSolving() const noexcept {
+    return solving;
+  }
+
+  /**
+   * Abandon the search in progress (if any).  The next Solve() call
+   * will start a new search.
+   */
+  void CancelSolve() noexcept;
 
   /**
    * Retrieve current solution.  If solver failed previously,
@@ -156,7 +192,8 @@ public:
   }
 
   /**
-   * Update aircraft performance model used for path planning.
+   * Update aircraft performance model used for path planning.  This
+   * is ignored while a search is suspended (see IsSolving()).
    *
    * @param polar Glide performance model used for route planning
    * @param wind Wind estimate
@@ -280,6 +317,14 @@ protected:
   bool IsHullExtended(const RoutePoint &p) noexcept;
 
 private:
+  /**
+   * Expand up to the given number of nodes of the search started by
+   * Solve().
+   *
+   * @return True if new solution was found
+   */
+  bool ContinueSolve(unsigned max_steps) noexcept;
+
   /**
    * Backtrack solution from A* internal structure to construct a
    * Route.
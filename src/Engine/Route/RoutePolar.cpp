@@ -35,7 +35,9 @@ RoutePolar::Initialise(const GlideSettings &settings, const GlidePolar& polar,
       RoutePolarPoint point(res.time_elapsed.count(), res.height_glide);
       points[i] = point;
     } else
-      points[i].valid = false;
+      /* clear all attributes, not just "valid", to allow comparing
+         with operator== */
+      points[i] = {};
   }
 }
 
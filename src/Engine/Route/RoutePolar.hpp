@@ -40,6 +40,8 @@ class RoutePolar
 
     RoutePolarPoint() = default;
 
+    bool operator==(const RoutePolarPoint &) const noexcept = default;
+
     RoutePolarPoint(double _slowness, double _gradient)
       :slowness(_slowness), gradient(_gradient), valid(true)
     {
@@ -53,6 +55,8 @@ class RoutePolar
   RoutePolarPoint points[ROUTEPOLAR_POINTS];
 
 public:
+  bool operator==(const RoutePolar &) const noexcept = default;
+
   /**
    * Populate internal structure with performance data.
    * To be called when the glide polar settings or wind changes.
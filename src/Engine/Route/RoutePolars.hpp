@@ -109,6 +109,20 @@ public:
   RouteLink NeighbourLink(const RoutePoint &start, const RoutePoint &end,
                           const FlatProjection &proj, int sign) const noexcept;
 
+  /**
+   * Do both objects describe the same aircraft performance and
+   * configuration?  The cruise altitude and the climb ceiling are
+   * not compared, because they follow the aircraft altitude.
+   */
+  [[gnu::pure]]
+  bool HasSamePerformance(const RoutePolars &other) const noexcept {
+    return polar_glide == other.polar_glide &&
+      polar_cruise == other.polar_cruise &&
+      inv_mc == other.inv_mc &&
+      height_min_working == other.height_min_working &&
+      config == other.config;
+  }
+
   /** Whether climbs are possible/allowed */
   [[gnu::pure]]
   bool CanClimb() const noexcept;
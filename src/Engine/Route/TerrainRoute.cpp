@@ -18,8 +18,15 @@ TerrainRoute::UpdatePolar(const GlideSettings &settings,
 
   switch (config.reach_polar_mode) {
   case RoutePlannerConfig::Polar::TASK:
-    rpolars_reach = rpolars_route;
-    // make copy to avoid waste
+    if (!IsSolving()) {
+      rpolars_reach = rpolars_route;
+      // make copy to avoid waste
+      break;
+    }
+
+    /* #rpolars_route is frozen during a suspended search */
+    rpolars_reach.SetConfig(config);
+    rpolars_reach.Initialise(settings, task_polar, wind);
     break;
   case RoutePlannerConfig::Polar::SAFETY:
     rpolars_reach.SetConfig(config);
@@ -47,6 +54,20 @@ TerrainRoute::SolveReach(const AGeoPoint &origin,
   return reach;
 }
 
+bool
+TerrainRoute::IsReachReusable(const ReachFan &previous,
+                              const AGeoPoint &origin,
+                              const RoutePlannerConfig &config,
+                              const int h_ceiling,
+                              const bool do_solve,
+                              const bool working) const noexcept
+{
+  RoutePolars rpolars = working ? rpolars_reach_working : rpolars_reach;
+  rpolars.SetConfig(config, origin.altitude, h_ceiling);
+
+  return previous.IsReusable(origin, rpolars, terrain, do_solve);
+}
+
 /*
   @todo:
   - check wind directions are correct
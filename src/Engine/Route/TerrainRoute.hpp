@@ -61,6 +61,17 @@ public:
                       int h_ceiling, bool do_solve,
                       bool working) noexcept;
 
+  /**
+   * Can the given result of a previous SolveReach() call be used
+   * instead of solving again?  See ReachFan::IsReusable().
+   */
+  [[gnu::pure]]
+  bool IsReachReusable(const ReachFan &previous,
+                       const AGeoPoint &origin,
+                       const RoutePlannerConfig &config,
+                       int h_ceiling, bool do_solve,
+                       bool working) const noexcept;
+
   /**
    * Determine if intersection with terrain occurs in forwards direction from
    * origin to destination, with cruise-climb and glide segments.
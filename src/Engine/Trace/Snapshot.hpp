@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Trace.hpp"
+#include "Vector.hpp"
+
+#include <span>
+
+/**
+ * An immutable copy of a #Trace.  The owner of the #Trace creates a
+ * new one after each modification and shares it with other threads
+ * (e.g. via std::shared_ptr), which may then read it without locking
+ * the #Trace.
+ */
+class TraceSnapshot {
+  TracePointVector points;
+
+  TaskProjection projection;
+
+  /**
+   * The Trace::GetAppendSerial() value of the #Trace this snapshot
+   * was copied from.
+   */
+  Serial serial;
+
+public:
+  explicit TraceSnapshot(const Trace &trace) noexcept
+    :projection(trace.GetProjection()),
+     serial(trace.GetAppendSerial())
+  {
+    trace.GetPoints(points);
+  }
+
+  TraceSnapshot(const TraceSnapshot &) = delete;
+  TraceSnapshot &operator=(const TraceSnapshot &) = delete;
+
+  /**
+   * Compare this value with the one of a previous snapshot to check
+   * whether the trace has been modified in between.
+   */
+  const Serial &GetSerial() const noexcept {
+    return serial;
+  }
+
+  bool empty() const noexcept {
+    return points.empty();
+  }
+
+  /**
+   * Returns all points in chronological order.
+   */
+  std::span<const TracePoint> GetPoints() const noexcept {
+    return points;
+  }
+
+  /**
+   * See Trace::GetPoints().
+   */
+  void GetPoints(TracePointVector &v, std::chrono::duration<unsigned> min_time,
+                 const GeoPoint &location, double resolution) const noexcept {
+    Trace::GetPoints(points, projection, v, min_time, location, resolution);
+  }
+};
@@ -3,18 +3,266 @@
 
 #include "Trace.hpp"
 #include "Vector.hpp"
-#include "util/GlobalSliceAllocator.hxx"
 
 #include <algorithm>
-#include <iterator>
+#include <cstdlib>
+
+namespace {
+
+using Time = TracePoint::Time;
+
+/**
+ * Calculate error distance, between last through this to next,
+ * if this node is removed.  This metric provides for Douglas-Peuker
+ * thinning.
+ *
+ * @param last Point previous in time to this node
+ * @param node This node
+ * @param next Point succeeding this node
+ *
+ * @return Distance error if this node is thinned
+ */
+[[gnu::pure]]
+unsigned
+DistanceMetric(const TracePoint &last, const TracePoint &node,
+               const TracePoint &next) noexcept
+{
+  const int d_this = last.FlatDistanceTo(node) + node.FlatDistanceTo(next);
+  const int d_rem = last.FlatDistanceTo(next);
+  return abs(d_this - d_rem);
+}
+
+/**
+ * Calculate error time, between last through this to next,
+ * if this node is removed.  This metric provides for fair thinning
+ * (tendency to to result in equal time steps)
+ *
+ * @param last Point previous in time to this node
+ * @param node This node
+ * @param next Point succeeding this node
+ *
+ * @return Time delta if this node is thinned
+ */
+constexpr Time
+TimeMetric(const TracePoint &last, const TracePoint &node,
+           const TracePoint &next) noexcept
+{
+  return next.DeltaTime(last)
+    - std::min(next.DeltaTime(node), node.DeltaTime(last));
+}
+
+/**
+ * The state of one EraseDelta() pass: a chronological list of the
+ * surviving points (as index links) and a binary min-heap of the
+ * points which may be removed, ranked by their elimination metrics.
+ *
+ * All indices are relative to the first point of the #Trace.  The
+ * first and the last point ("edges") are never removed.
+ */
+class DeltaQueue {
+  static constexpr unsigned NOT_QUEUED = ~0u;
+
+  struct Item {
+    Time elim_time;
+    unsigned elim_distance;
+
+    unsigned previous, next;
+
+    /**
+     * The index of this item in #heap or #NOT_QUEUED.
+     */
+    unsigned heap_position;
+  };
+
+  const std::span<const TracePoint> points;
+
+  /**
+   * See Trace::delta_distances.
+   */
+  unsigned *const delta_distances;
+
+  AllocatedArray<Item> items;
+  AllocatedArray<unsigned> heap;
+  unsigned heap_size = 0;
+
+public:
+  /**
+   * @param recent_time points at or after this time are not queued
+   */
+  DeltaQueue(std::span<const TracePoint> _points,
+             unsigned *_delta_distances, Time recent_time) noexcept
+    :points(_points), delta_distances(_delta_distances),
+     items(points.size()), heap(points.size())
+  {
+    const unsigned n = points.size();
+    assert(n > 2);
+
+    for (unsigned i = 0; i < n; ++i) {
+      Item &item = items[i];
+      item.previous = i - 1;
+      item.next = i + 1;
+      item.heap_position = NOT_QUEUED;
+
+      if (i > 0 && i < n - 1) {
+        UpdateMetrics(i);
+
+        if (points[i].GetTime() < recent_time) {
+          item.heap_position = heap_size;
+          heap[heap_size++] = i;
+        }
+      }
+    }
+
+    for (unsigned i = heap_size / 2; i-- > 0;)
+      SiftDown(i);
+  }
+
+  bool empty() const noexcept {
+    return heap_size == 0;
+  }
+
+  /**
+   * Remove the best candidate from the trace.
+   */
+  void EraseTop() noexcept {
+    assert(!empty());
+
+    const unsigned i = heap[0];
+    RemoveFromHeap(0);
+
+    const unsigned previous = items[i].previous;
+    const unsigned next = items[i].next;
+    items[previous].next = next;
+    items[next].previous = previous;
+
+    /* the predecessor of "previous" is unchanged, therefore its delta
+       distance is, too */
+    if (previous > 0) {
+      UpdateMetrics(previous);
+      Reposition(previous);
+    }
+
+    if (next < points.size() - 1) {
+      UpdateMetrics(next);
+      delta_distances[next] = points[next].FlatDistanceTo(points[previous]);
+      Reposition(next);
+    }
+  }
+
+  /**
+   * Invoke a function for each surviving point index in
+   * chronological order.
+   */
+  template<typename F>
+  void ForEach(F &&f) const noexcept {
+    for (unsigned i = 0; i < points.size(); i = items[i].next)
+      f(i);
+  }
+
+private:
+  void UpdateMetrics(unsigned i) noexcept {
+    Item &item = items[i];
+    const TracePoint &previous = points[item.previous];
+    const TracePoint &next = points[item.next];
+
+    item.elim_time = TimeMetric(previous, points[i], next);
+    item.elim_distance = DistanceMetric(previous, points[i], next);
+  }
+
+  /**
+   * Ranking is primarily by distance delta; for equal distances, rank
+   * by time delta, and finally by age.  This is like a modified
+   * Douglas-Peuker algorithm.
+   */
+  [[gnu::pure]]
+  bool IsBetter(unsigned a, unsigned b) const noexcept {
+    const Item &x = items[a], &y = items[b];
+
+    // distance is king
+    if (x.elim_distance != y.elim_distance)
+      return x.elim_distance < y.elim_distance;
+
+    // distance is equal, so go by time error
+    if (x.elim_time != y.elim_time)
+      return x.elim_time < y.elim_time;
+
+    // all else fails, go by age (indices are chronological)
+    return a < b;
+  }
+
+  void Place(unsigned position, unsigned i) noexcept {
+    heap[position] = i;
+    items[i].heap_position = position;
+  }
+
+  void SiftUp(unsigned position) noexcept {
+    const unsigned i = heap[position];
+    while (position > 0) {
+      const unsigned parent = (position - 1) / 2;
+      if (!IsBetter(i, heap[parent]))
+        break;
+
+      Place(position, heap[parent]);
+      position = parent;
+    }
+
+    Place(position, i);
+  }
+
+  void SiftDown(unsigned position) noexcept {
+    const unsigned i = heap[position];
+    while (true) {
+      unsigned child = 2 * position + 1;
+      if (child >= heap_size)
+        break;
+
+      if (child + 1 < heap_size && IsBetter(heap[child + 1], heap[child]))
+        ++child;
+
+      if (!IsBetter(heap[child], i))
+        break;
+
+      Place(position, heap[child]);
+      position = child;
+    }
+
+    Place(position, i);
+  }
+
+  void RemoveFromHeap(unsigned position) noexcept {
+    items[heap[position]].heap_position = NOT_QUEUED;
+
+    if (--heap_size == position)
+      return;
+
+    const unsigned i = heap[heap_size];
+    Place(position, i);
+    SiftUp(position);
+    SiftDown(items[i].heap_position);
+  }
+
+  /**
+   * Restore the heap order after the metrics of a point have changed.
+   */
+  void Reposition(unsigned i) noexcept {
+    const unsigned position = items[i].heap_position;
+    if (position == NOT_QUEUED)
+      return;
+
+    SiftUp(position);
+    SiftDown(items[i].heap_position);
+  }
+};
+
+} // anonymous namespace
 
 Trace::Trace(const Time _no_thin_time, const Time max_time,
              const unsigned max_size) noexcept
-  :cached_size(0),
-   max_time(max_time),
+  :max_time(max_time),
    no_thin_time(_no_thin_time),
    max_size(max_size),
-   opt_size((3 * max_size) / 4)
+   opt_size((3 * max_size) / 4),
+   average_delta_time{}, average_delta_distance(0)
 {
   assert(max_size >= 4);
 }
@@ -22,18 +270,10 @@ Trace::Trace(const Time _no_thin_time, const Time max_time,
 void
 Trace::clear() noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   average_delta_distance = 0;
   average_delta_time = {};
 
-  delta_list.clear();
-  chronological_list.clear_and_dispose(MakeDisposer());
-  cached_size = 0;
-
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
+  head = tail = 0;
 
   ++modify_serial;
   ++append_serial;
@@ -52,102 +292,55 @@ Trace::GetRecentTime(const Time t) const noexcept
   return {};
 }
 
-void
-Trace::UpdateDelta(TraceDelta &td) noexcept
-{
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
-  if (&td == &chronological_list.front() ||
-      &td == &chronological_list.back())
-    return;
-
-  const auto ci = chronological_list.iterator_to(td);
-  const TraceDelta &previous = *std::prev(ci);
-  const TraceDelta &next = *std::next(ci);
-
-  delta_list.erase(delta_list.iterator_to(td));
-  td.Update(previous.point, next.point);
-  delta_list.insert(td);
-}
-
-void
-Trace::EraseInside(DeltaList::iterator it) noexcept
-{
-  assert(cached_size > 0);
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-  assert(it != delta_list.end());
-
-  const TraceDelta &td = *it;
-  assert(!td.IsEdge());
-
-  const auto ci = chronological_list.iterator_to(td);
-  TraceDelta &previous = const_cast<TraceDelta &>(*std::prev(ci));
-  TraceDelta &next = const_cast<TraceDelta &>(*std::next(ci));
-
-  // now delete the item
-  chronological_list.erase(chronological_list.iterator_to(td));
-  delta_list.erase_and_dispose(it, MakeDisposer());
-  --cached_size;
-
-  // and update the deltas
-  UpdateDelta(previous);
-  UpdateDelta(next);
-}
-
 bool
 Trace::EraseDelta(const unsigned target_size, const Time recent) noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   if (size() <= 2)
     return false;
 
-  bool modified = false;
-
-  const Time recent_time = GetRecentTime(recent);
+  DeltaQueue queue(GetSpan(), delta_distances.data() + head,
+                   GetRecentTime(recent));
 
-  auto candidate = delta_list.begin();
-  while (size() > target_size) {
-    const TraceDelta &td = *candidate;
-    if (!td.IsEdge() && td.point.GetTime() < recent_time) {
-      EraseInside(candidate);
-      candidate = delta_list.begin(); // find new top
-      modified = true;
-    } else {
-      ++candidate;
-      // suppressed removal, skip it.
-    }
+  /* suppressed candidates (the edges and the recent points) are not
+     in the queue; if it runs empty, the recent time is obeyed even if
+     the target size is missed */
+  unsigned n = size();
+  while (n > target_size && !queue.empty()) {
+    queue.EraseTop();
+    --n;
   }
 
-  return modified;
+  if (n == size())
+    return false;
+
+  /* move the surviving points together; the destination never
+     overtakes the source */
+  unsigned dest = head;
+  queue.ForEach([this, &dest](unsigned i){
+    points[dest] = points[head + i];
+    delta_distances[dest] = delta_distances[head + i];
+    ++dest;
+  });
+
+  assert(dest == head + n);
+  tail = dest;
+  return true;
 }
 
 bool
 Trace::EraseEarlierThan(const Time p_time) noexcept
 {
-  if (p_time == Time{} || empty() || GetFront().point.GetTime() >= p_time)
+  if (p_time == Time{} || empty() || front().GetTime() >= p_time)
     // there will be nothing to remove
     return false;
 
-  do {
-    auto ci = chronological_list.begin();
-    TraceDelta &td = *ci;
-    chronological_list.erase(ci);
-
-    auto i = delta_list.find(td);
-    assert(i != delta_list.end());
-    delta_list.erase_and_dispose(i, MakeDisposer());
-
-    --cached_size;
-  } while (!empty() && GetFront().point.GetTime() < p_time);
-
-  // need to set deltas for first point, only one of these
-  // will occur (have to search for this point)
-  if (!empty())
-    EraseStart(GetFront());
+  const auto i = std::partition_point(begin(), end(),
+                                      [p_time](const TracePoint &p){
+                                        return p.GetTime() < p_time;
+                                      });
+  head = i - points.data();
+  if (empty())
+    head = tail = 0;
 
   ++modify_serial;
   ++append_serial;
@@ -160,44 +353,52 @@ Trace::EraseLaterThan(const Time min_time) noexcept
   assert(min_time.count() > 0);
   assert(!empty());
 
-  while (!empty() && GetBack().point.GetTime() > min_time) {
-    TraceDelta &td = GetBack();
-
-    chronological_list.erase(chronological_list.iterator_to(td));
+  const auto i = std::partition_point(begin(), end(),
+                                      [min_time](const TracePoint &p){
+                                        return p.GetTime() <= min_time;
+                                      });
+  tail = i - points.data();
+  if (empty())
+    head = tail = 0;
+}
 
-    auto i = delta_list.find(td);
-    assert(i != delta_list.end());
-    delta_list.erase_and_dispose(i, MakeDisposer());
+void
+Trace::Compact() noexcept
+{
+  assert(head > 0);
 
-    --cached_size;
-  }
+  std::copy(points.data() + head, points.data() + tail, points.data());
+  std::copy(delta_distances.data() + head, delta_distances.data() + tail,
+            delta_distances.data());
+  tail -= head;
+  head = 0;
 
-  /* need to set deltas for first point, only one of these will occur
-     (have to search for this point) */
-  if (!empty())
-    EraseStart(GetBack());
+  ++modify_serial;
 }
 
-/**
- * Update start node (and neighbour) after min time pruning
- */
 void
-Trace::EraseStart(TraceDelta &td) noexcept
+Trace::MakeRoom() noexcept
 {
-  delta_list.erase(delta_list.iterator_to(td));
+  assert(tail == points.size());
+  assert(size() < max_size);
 
-  td.elim_distance = null_delta;
-  td.elim_time = null_time;
+  /* grow only if at most half of the array has been erased by
+     EraseEarlierThan(); otherwise reuse that space */
+  if (points.size() < max_size && 2 * head <= tail) {
+    const unsigned new_size = tail < max_size / 2
+      ? std::max(2 * tail, std::min(64U, max_size))
+      : max_size;
 
-  delta_list.insert(td);
+    points.GrowPreserve(new_size, tail);
+    delta_distances.GrowPreserve(new_size, tail);
+    ++modify_serial;
+  } else
+    Compact();
 }
 
 void
 Trace::push_back(const TracePoint &point) noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   const Time min_delta = std::chrono::seconds{2};
 
   if (empty()) {
@@ -230,17 +431,19 @@ Trace::push_back(const TracePoint &point) noexcept
 
   assert(size() < max_size);
 
-  TraceDelta *td = allocator.allocate(1);
-  std::allocator_traits<Allocator>::construct(allocator, td, point);
-  td->point.Project(task_projection);
+  if (tail == points.size())
+    MakeRoom();
 
-  delta_list.insert(*td);
-  chronological_list.push_back(*td);
+  points[tail] = point;
+  points[tail].Project(task_projection);
+  delta_distances[tail] = 0;
+  ++tail;
 
-  ++cached_size;
-
-  if (td != &chronological_list.front())
-    UpdateDelta(*std::prev(chronological_list.iterator_to(*td)));
+  /* the previous point is not an edge anymore (unless it is the
+     first one) */
+  if (size() > 2)
+    delta_distances[tail - 2] =
+      points[tail - 2].FlatDistanceTo(points[tail - 3]);
 
   ++append_serial;
 }
@@ -252,10 +455,9 @@ Trace::CalcAverageDeltaDistance(const Time no_thin) const noexcept
   unsigned acc = 0;
   unsigned counter = 0;
 
-  const auto end = chronological_list.end();
-  for (auto it = chronological_list.begin();
-       it != end && it->point.GetTime() < r; ++it, ++counter)
-    acc += it->delta_distance;
+  for (unsigned i = head; i < tail && points[i].GetTime() < r;
+       ++i, ++counter)
+    acc += delta_distances[i];
 
   if (counter)
     return acc / counter;
@@ -267,23 +469,19 @@ Trace::Time
 Trace::CalcAverageDeltaTime(const Time no_thin) const noexcept
 {
   const Time r = GetRecentTime(no_thin);
-  unsigned counter = 0;
 
   /* find the last item before the "r" timestamp */
-  const auto end = chronological_list.end();
-  ChronologicalList::const_iterator it;
-  for (it = chronological_list.begin(); it != end && it->point.GetTime() < r; ++it)
-    ++counter;
+  unsigned i = head;
+  while (i < tail && points[i].GetTime() < r)
+    ++i;
 
+  const unsigned counter = i - head;
   if (counter < 2)
     return {};
 
-  --it;
-  --counter;
-
   Time start_time = front().GetTime();
-  Time end_time = it->point.GetTime();
-  return (end_time - start_time) / counter;
+  Time end_time = points[i - 1].GetTime();
+  return (end_time - start_time) / (counter - 1);
 }
 
 void
@@ -323,8 +521,6 @@ Trace::Thin2() noexcept
 void
 Trace::Thin() noexcept
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
   assert(size() == max_size);
 
   Thin2();
@@ -341,56 +537,16 @@ Trace::Thin() noexcept
 void
 Trace::GetPoints(TracePointVector& iov) const noexcept
 {
-  iov.clear();
-  iov.reserve(size());
-  std::copy(begin(), end(), std::back_inserter(iov));
+  iov.assign(begin(), end());
 }
 
-template<typename I>
-class PointerIterator {
-  I i;
-
-public:
-  typedef typename I::iterator_category iterator_category;
-  typedef typename I::pointer value_type;
-  typedef typename I::pointer *pointer;
-  typedef value_type &reference;
-  typedef typename I::difference_type difference_type;
-
-  PointerIterator() = default;
-  explicit PointerIterator(I _i) noexcept:i(_i) {}
-
-  PointerIterator<I> &operator--() noexcept {
-    --i;
-    return *this;
-  }
-
-  PointerIterator<I> &operator++() noexcept {
-    ++i;
-    return *this;
-  }
-
-  typename I::pointer operator*() noexcept {
-    return &*i;
-  }
-
-  bool operator==(const PointerIterator<I> &other) const noexcept {
-    return i == other.i;
-  }
-
-  bool operator!=(const PointerIterator<I> &other) const noexcept {
-    return i != other.i;
-  }
-};
-
 void
 Trace::GetPoints(TracePointerVector &v) const noexcept
 {
   v.clear();
   v.reserve(size());
-  std::copy(PointerIterator<decltype(begin())>(begin()),
-            PointerIterator<decltype(end())>(end()),
-            std::back_inserter(v));
+  for (const TracePoint &p : GetSpan())
+    v.push_back(&p);
 }
 
 bool
@@ -403,42 +559,40 @@ Trace::SyncPoints(TracePointerVector &v) const noexcept
     return false;
 
   v.reserve(size());
+  for (const TracePoint &p : GetSpan().subspan(v.size()))
+    v.push_back(&p);
 
-  PointerIterator<decltype(end())> e(end());
-  std::copy(std::prev(e, size() - v.size()), e,
-            std::back_inserter(v));
   assert(v.size() == size());
   return true;
 }
 
 void
-Trace::GetPoints(TracePointVector &v, const Time min_time,
+Trace::GetPoints(std::span<const TracePoint> src,
+                 const TaskProjection &projection,
+                 TracePointVector &v, const Time min_time,
                  const GeoPoint &location,
-                 double min_distance) const noexcept
+                 double min_distance) noexcept
 {
   /* skip the trace points that are before min_time */
-  Trace::const_iterator i = begin(), end = this->end();
-  unsigned skipped = 0;
-  while (true) {
-    if (i == end)
-      /* nothing left */
-      return;
+  auto i = std::partition_point(src.begin(), src.end(),
+                                [min_time](const TracePoint &p){
+                                  return p.GetTime() < min_time;
+                                });
+  if (i == src.end())
+    /* nothing left */
+    return;
 
-    if (i->GetTime() >= min_time)
-      /* found the first point that is within range */
-      break;
+  v.reserve(src.end() - i);
+  const unsigned range =
+    projection.ProjectRangeInteger(location, min_distance);
+  const unsigned sq_range = range * range;
 
-    ++i;
-    ++skipped;
+  const TracePoint *previous = &*i;
+  v.push_back(*previous);
+  for (++i; i != src.end(); ++i) {
+    if (i->FlatSquareDistanceTo(*previous) >= sq_range) {
+      v.push_back(*i);
+      previous = &*i;
+    }
   }
-
-  assert(skipped < size());
-
-  v.reserve(size() - skipped);
-  const unsigned range = ProjectRange(location, min_distance);
-  const unsigned sq_range = range * range;
-  do {
-    v.push_back(*i);
-    i.NextSquareRange(sq_range, end);
-  } while (i != end);
 }
@@ -4,19 +4,14 @@
 #pragma once
 
 #include "Point.hpp"
+#include "util/AllocatedArray.hxx"
 #include "util/NonCopyable.hpp"
-#include "util/Sanitizer.hxx"
-#include "util/SliceAllocator.hxx"
 #include "util/Serial.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 #include "time/Stamp.hpp"
 
-#include <boost/intrusive/list.hpp>
-#include <boost/intrusive/set.hpp>
-#include <algorithm>
 #include <cassert>
-#include <type_traits>
-#include <stdlib.h>
+#include <span>
 
 class TracePointVector;
 class TracePointerVector;
@@ -30,153 +25,32 @@ class TracePointerVector;
  * the candidate point removed.  In this version, time differences is also a
  * secondary factor, such that thinning attempts to remove points such that,
  * for equal distance ranking, smaller time step details are removed first.
+ *
+ * The points are stored in one contiguous array in chronological
+ * order, which grows geometrically up to #max_size elements.
+ * Pointers to points remain valid until #modify_serial changes.  The
+ * elimination ranking is only needed while thinning, and is built in
+ * a separate (temporary) heap by EraseDelta().
  */
 class Trace : private NonCopyable
 {
   using Time = TracePoint::Time;
 
-  struct TraceDelta
-    : boost::intrusive::set_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
-      boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>> {
-
-    /**
-     * Function used to points for sorting by deltas.
-     * Ranking is primarily by distance delta; for equal distances, rank by
-     * time delta.
-     * This is like a modified Douglas-Peuker algorithm
-     */
-    [[gnu::pure]]
-    static constexpr bool DeltaRank(const TraceDelta &x,
-                                    const TraceDelta &y) noexcept {
-      // distance is king
-      if (x.elim_distance < y.elim_distance)
-        return true;
-
-      if (x.elim_distance > y.elim_distance)
-        return false;
-
-      // distance is equal, so go by time error
-      if (x.elim_time < y.elim_time)
-        return true;
-
-      if (x.elim_time > y.elim_time)
-        return false;
-
-      // all else fails, go by age
-      if (x.point.IsOlderThan(y.point))
-        return true;
-
-      if (x.point.IsNewerThan(y.point))
-        return false;
-
-      return false;
-    }
-
-    struct DeltaRankOp {
-      constexpr bool operator()(const TraceDelta &s1,
-                                const TraceDelta &s2) const noexcept {
-        return DeltaRank(s1, s2);
-      }
-    };
-
-    TracePoint point;
-
-    Time elim_time;
-    unsigned elim_distance;
-    unsigned delta_distance;
-
-    explicit TraceDelta(const TracePoint &p) noexcept
-      :point(p),
-       elim_time(null_time), elim_distance(null_delta),
-       delta_distance(0) {}
-
-    TraceDelta(const TracePoint &p_last, const TracePoint &p,
-               const TracePoint &p_next) noexcept
-      :point(p),
-       elim_time(TimeMetric(p_last, p, p_next)),
-       elim_distance(DistanceMetric(p_last, p, p_next)),
-       delta_distance(p.FlatDistanceTo(p_last))
-    {
-      assert(elim_distance != null_delta);
-    }
-
-    /**
-     * Is this the first or the last point?
-     */
-    constexpr bool IsEdge() const noexcept {
-      return elim_time == null_time;
-    }
-
-    void Update(const TracePoint &p_last, const TracePoint &p_next) noexcept {
-      elim_time = TimeMetric(p_last, point, p_next);
-      elim_distance = DistanceMetric(p_last, point, p_next);
-      delta_distance = point.FlatDistanceTo(p_last);
-    }
-
-    /**
-     * Calculate error distance, between last through this to next,
-     * if this node is removed.  This metric provides for Douglas-Peuker
-     * thinning.
-     *
-     * @param last Point previous in time to this node
-     * @param node This node
-     * @param next Point succeeding this node
-     *
-     * @return Distance error if this node is thinned
-     */
-    [[gnu::pure]]
-    static unsigned DistanceMetric(const TracePoint &last,
-                                   const TracePoint &node,
-                                   const TracePoint &next) noexcept {
-      const int d_this = last.FlatDistanceTo(node) + node.FlatDistanceTo(next);
-      const int d_rem = last.FlatDistanceTo(next);
-      return abs(d_this - d_rem);
-    }
-
-    /**
-     * Calculate error time, between last through this to next,
-     * if this node is removed.  This metric provides for fair thinning
-     * (tendency to to result in equal time steps)
-     *
-     * @param last Point previous in time to this node
-     * @param node This node
-     * @param next Point succeeding this node
-     *
-     * @return Time delta if this node is thinned
-     */
-    static constexpr Time TimeMetric(const TracePoint &last,
-                                     const TracePoint &node,
-                                     const TracePoint &next) noexcept {
-      return next.DeltaTime(last)
-        - std::min(next.DeltaTime(node), node.DeltaTime(last));
-    }
-  };
-
-  /* using multiset, not because we need multiple values (we don't),
-     but to avoid set's overhead for duplicate elimination */
-  typedef boost::intrusive::multiset<TraceDelta,
-                                     boost::intrusive::compare<TraceDelta::DeltaRankOp>,
-                                     boost::intrusive::constant_time_size<false>> DeltaList;
-
-  typedef boost::intrusive::list<TraceDelta,
-                                 boost::intrusive::constant_time_size<false>> ChronologicalList;
-
   /**
-   * Use a SliceAllocator for allocating TraceDelta instances.  This
-   * reduces a lot of allocation overhead (both CPU and memory),
-   * because there will be lots of these objects.  Fall back to
-   * std::allocator when compiled with AddressSanitizer, because that
-   * avoids hiding memory errors.
+   * All points in chronological order.  Only the range [#head,
+   * #tail) is used; the elements before #head have been erased by
+   * EraseEarlierThan(), and are reclaimed lazily by Compact().
    */
-  using Allocator = std::conditional_t<HaveAddressSanitizer(),
-                                       std::allocator<TraceDelta>,
-                                       SliceAllocator<TraceDelta, 128u>>;
+  AllocatedArray<TracePoint> points;
 
-  Allocator allocator;
+  /**
+   * The flat distance of each point in #points to its predecessor
+   * (same index), updated whenever the predecessor changes.  This is
+   * zero for the first point and for the most recent one.
+   */
+  AllocatedArray<unsigned> delta_distances;
 
-  DeltaList delta_list;
-  ChronologicalList chronological_list;
-  unsigned cached_size;
+  unsigned head = 0, tail = 0;
 
   TaskProjection task_projection;
 
@@ -190,25 +64,6 @@ class Trace : private NonCopyable
 
   Serial append_serial, modify_serial;
 
-  template<typename Alloc>
-  struct Disposer {
-    Alloc &alloc;
-
-    void operator()(typename std::allocator_traits<Alloc>::pointer td) {
-      std::allocator_traits<Alloc>::destroy(alloc, td);
-      alloc.deallocate(td, 1);
-    }
-  };
-
-  template<typename Alloc>
-  static Disposer<Alloc> MakeDisposer(Alloc &alloc) {
-    return {alloc};
-  }
-
-  Disposer<decltype(allocator)> MakeDisposer() {
-    return MakeDisposer(allocator);
-  }
-
 public:
   /**
    * Constructor.  Task projection is updated after first call to append().
@@ -222,10 +77,6 @@ public:
                  const Time max_time = null_time,
                  const unsigned max_size = 1000) noexcept;
 
-  ~Trace() noexcept {
-    clear();
-  }
-
 protected:
   /**
    * Find recent time after which points should not be culled
@@ -238,27 +89,6 @@ protected:
   [[gnu::pure]]
   Time GetRecentTime(Time t) const noexcept;
 
-  /**
-   * Update delta values for specified item in the delta list and the
-   * tree.  This repositions the item after into its sorted position.
-   *
-   * @param it Item to update
-   * @param tree Tree containing leaf
-   *
-   * @return Iterator to updated item
-   */
-  void UpdateDelta(TraceDelta &td) noexcept;
-
-  /**
-   * Erase a non-edge item from delta list and tree, updating
-   * deltas in the process.  This Invalidates the calling iterator.
-   *
-   * @param it Item to erase
-   * @param tree Tree to remove from
-   *
-   */
-  void EraseInside(DeltaList::iterator it) noexcept;
-
   /**
    * Erase elements based on delta metric until the size is
    * equal to the target size.  Wont remove elements more recent than
@@ -268,7 +98,6 @@ protected:
    * fail to set the target size.
    *
    * @param target_size Size of desired list.
-   * @param tree Tree to remove from
    * @param recent Time window for which to not remove points
    *
    * @return True if items were erased
@@ -277,11 +106,10 @@ protected:
                   Time recent = {}) noexcept;
 
   /**
-   * Erase elements older than specified time from delta and tree,
-   * and update earliest item to become the new start
+   * Erase elements older than specified time, and let the earliest
+   * remaining item become the new start.
    *
    * @param p_time Time to remove
-   * @param tree Tree to remove from
    *
    * @return True if items were erased
    */
@@ -293,11 +121,6 @@ protected:
    */
   void EraseLaterThan(Time min_time) noexcept;
 
-  /**
-   * Update start node (and neighbour) after min time pruning
-   */
-  void EraseStart(TraceDelta &td_start) noexcept;
-
 public:
   /**
    * Add trace to internal store.  Call optimise() periodically
@@ -331,7 +154,7 @@ public:
    * @return Number of traces in tree
    */
   unsigned size() const noexcept {
-    return cached_size;
+    return tail - head;
   }
 
   /**
@@ -340,7 +163,7 @@ public:
    * @return True if no traces stored
    */
   bool empty() const noexcept {
-    return cached_size == 0;
+    return tail == head;
   }
 
   /**
@@ -390,18 +213,33 @@ public:
    * resolution #min_distance.
    */
   void GetPoints(TracePointVector &v, Time min_time,
-                 const GeoPoint &location, double resolution) const noexcept;
+                 const GeoPoint &location, double resolution) const noexcept {
+    GetPoints(GetSpan(), task_projection, v, min_time, location, resolution);
+  }
+
+  /**
+   * Implementation of the above, for a copy of the points (see
+   * #TraceSnapshot).
+   *
+   * @param projection the projection which was used to calculate the
+   * flat locations of #src
+   */
+  static void GetPoints(std::span<const TracePoint> src,
+                        const TaskProjection &projection,
+                        TracePointVector &v, Time min_time,
+                        const GeoPoint &location,
+                        double resolution) noexcept;
 
   const TracePoint &front() const noexcept {
     assert(!empty());
 
-    return chronological_list.front().point;
+    return points[head];
   }
 
   const TracePoint &back() const noexcept {
     assert(!empty());
 
-    return chronological_list.back().point;
+    return points[tail - 1];
   }
 
 private:
@@ -428,17 +266,19 @@ private:
    */
   void Thin() noexcept;
 
-  TraceDelta &GetFront() noexcept {
-    assert(!empty());
-
-    return chronological_list.front();
-  }
-
-  TraceDelta &GetBack() noexcept {
-    assert(!empty());
+  /**
+   * Move the points to the beginning of the array, to make room for
+   * new ones after EraseEarlierThan().  This invalidates all
+   * pointers.
+   */
+  void Compact() noexcept;
 
-    return chronological_list.back();
-  }
+  /**
+   * Make room for one more point at #tail, either by growing the
+   * arrays (up to #max_size) or by Compact().  This invalidates all
+   * pointers.
+   */
+  void MakeRoom() noexcept;
 
   [[gnu::pure]]
   unsigned CalcAverageDeltaDistance(Time no_thin) const noexcept;
@@ -446,8 +286,6 @@ private:
   [[gnu::pure]]
   Time CalcAverageDeltaTime(Time no_thin) const noexcept;
 
-  static constexpr unsigned null_delta = 0 - 1;
-
 public:
   static constexpr auto null_time = TracePoint::INVALID_TIME;
 
@@ -460,53 +298,22 @@ public:
   }
 
 public:
-  class const_iterator : public ChronologicalList::const_iterator {
-    friend class Trace;
-
-    const_iterator(ChronologicalList::const_iterator &&_iterator) noexcept
-      :ChronologicalList::const_iterator(std::move(_iterator)) {}
-
-  public:
-    using ChronologicalList::const_iterator::iterator_category;
-    using ChronologicalList::const_iterator::difference_type;
-    typedef const TracePoint value_type;
-    typedef const TracePoint *pointer;
-    typedef const TracePoint &reference;
-
-    const_iterator() = default;
-
-    const TracePoint &operator*() const noexcept {
-      const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-      return td.point;
-    }
-
-    const TracePoint *operator->() const noexcept {
-      const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-      return &td.point;
-    }
-
-    const_iterator &NextSquareRange(unsigned sq_resolution,
-                                    const const_iterator &end) noexcept {
-      const TracePoint &previous = **this;
-      while (true) {
-        ++*this;
-
-        if (*this == end)
-          return *this;
-
-        const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-        if (td.point.FlatSquareDistanceTo(previous) >= sq_resolution)
-          return *this;
-      }
-    }
-  };
+  using const_iterator = const TracePoint *;
 
   const_iterator begin() const noexcept {
-    return chronological_list.begin();
+    return points.data() + head;
   }
 
   const_iterator end() const noexcept {
-    return chronological_list.end();
+    return points.data() + tail;
+  }
+
+  /**
+   * Returns all points in chronological order.  The span is
+   * invalidated by any modification.
+   */
+  std::span<const TracePoint> GetSpan() const noexcept {
+    return {begin(), end()};
   }
 
   const TaskProjection &GetProjection() const noexcept {
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "InternedString.hpp"
+#include "thread/Mutex.hxx"
+#include "util/IntrusiveHashSet.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <new>
+
+struct InternedString::Item final : IntrusiveHashSetHook<> {
+  mutable std::atomic_uint refs{1};
+
+  const unsigned length;
+
+  explicit Item(unsigned _length) noexcept
+    :length(_length) {}
+
+  Item(const Item &) = delete;
+  Item &operator=(const Item &) = delete;
+
+  /* the characters are allocated right after this object */
+
+  TCHAR *GetData() noexcept {
+    return reinterpret_cast<TCHAR *>(this + 1);
+  }
+
+  const TCHAR *GetData() const noexcept {
+    return reinterpret_cast<const TCHAR *>(this + 1);
+  }
+
+  tstring_view GetValue() const noexcept {
+    return {GetData(), length};
+  }
+
+  static Item *Create(tstring_view value) noexcept {
+    void *p = ::operator new(sizeof(Item) +
+                             (value.size() + 1) * sizeof(TCHAR));
+    Item *item = new(p) Item(value.size());
+    *std::copy(value.begin(), value.end(), item->GetData()) = _T('\0');
+    return item;
+  }
+
+  void Destroy() noexcept {
+    this->~Item();
+    ::operator delete(this);
+  }
+
+  struct GetKey {
+    [[gnu::pure]]
+    tstring_view operator()(const Item &item) const noexcept {
+      return item.GetValue();
+    }
+  };
+};
+
+/**
+ * Protects #pool and all #Item::refs transitions from and to zero.
+ *
+ * The Windows #Mutex implementation cannot be constant-initialised,
+ * and strings may be interned during static construction, so this
+ * is constructed on first use.  It is never destroyed.
+ */
+static Mutex &
+GetPoolMutex() noexcept
+{
+  static Mutex &pool_mutex = *new Mutex;
+  return pool_mutex;
+}
+
+/**
+ * We build with -fno-threadsafe-statics, so the first GetPoolMutex()
+ * call must not race with another one; this forces it to happen
+ * during static initialisation, before any thread is started.
+ */
+[[maybe_unused]]
+static Mutex &pool_mutex_init = GetPoolMutex();
+
+/**
+ * All #Item instances which are currently referenced.  It is
+ * zero-initialised, so it is usable during static construction.
+ */
+static constinit IntrusiveHashSet<InternedString::Item, 4096,
+                                  IntrusiveHashSetOperators<std::hash<tstring_view>,
+                                                            std::equal_to<tstring_view>,
+                                                            InternedString::Item::GetKey>,
+                                  IntrusiveHashSetBaseHookTraits<InternedString::Item>,
+                                  IntrusiveHashSetOptions{.zero_initialized = true}> pool;
+
+InternedString::InternedString(tstring_view value) noexcept
+{
+  if (value.empty())
+    return;
+
+  const std::scoped_lock lock{GetPoolMutex()};
+
+  auto [i, inserted] = pool.insert_check(value);
+  if (inserted) {
+    Item *new_item = Item::Create(value);
+    pool.insert_commit(i, *new_item);
+    item = new_item;
+  } else {
+    /* refs cannot be zero here, because the last reference is only
+       released while holding the mutex, and the item is removed
+       from the pool right away */
+    assert(i->refs > 0);
+    ++i->refs;
+    item = &*i;
+  }
+}
+
+const InternedString::Item *
+InternedString::Ref(const Item *item) noexcept
+{
+  if (item != nullptr) {
+    /* the caller holds a reference, so this cannot race with the
+       removal from the pool */
+    assert(item->refs > 0);
+    item->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return item;
+}
+
+void
+InternedString::Unref(const Item *item) noexcept
+{
+  if (item == nullptr)
+    return;
+
+  /* fast path: this is not the last reference */
+  unsigned refs = item->refs.load(std::memory_order_relaxed);
+  while (refs > 1)
+    if (item->refs.compare_exchange_weak(refs, refs - 1,
+                                         std::memory_order_acq_rel))
+      return;
+
+  /* this may be the last reference: check again with the mutex held,
+     because another thread may have found this item in the pool in
+     the meantime */
+  const std::scoped_lock lock{GetPoolMutex()};
+
+  if (--item->refs == 0) {
+    Item &i = const_cast<Item &>(*item);
+    pool.erase(pool.iterator_to(i));
+    i.Destroy();
+  }
+}
+
+std::size_t
+InternedString::size() const noexcept
+{
+  return item != nullptr ? item->length : 0;
+}
+
+const TCHAR *
+InternedString::c_str() const noexcept
+{
+  return item != nullptr ? item->GetData() : _T("");
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "util/tstring_view.hxx"
+
+#include <tchar.h>
+#include <utility>
+
+/**
+ * An immutable string which shares its buffer with all other
+ * #InternedString instances of the same value.  This is meant for
+ * #Waypoint attributes like comments and file names which are often
+ * repeated many times in a large waypoint file; each distinct value
+ * is allocated only once, and an instance is just one pointer.
+ *
+ * The empty string does not allocate anything.
+ *
+ * This class is thread-safe: once static initialisation is complete,
+ * instances may be created, copied and destroyed in any thread.
+ * Before that (i.e. in static constructors), only one thread may use
+ * it.
+ */
+class InternedString {
+public:
+  /* implementation detail */
+  struct Item;
+
+private:
+  const Item *item = nullptr;
+
+public:
+  InternedString() noexcept = default;
+
+  explicit InternedString(tstring_view value) noexcept;
+
+  InternedString(const InternedString &src) noexcept
+    :item(Ref(src.item)) {}
+
+  InternedString(InternedString &&src) noexcept
+    :item(std::exchange(src.item, nullptr)) {}
+
+  ~InternedString() noexcept {
+    Unref(item);
+  }
+
+  InternedString &operator=(const InternedString &src) noexcept {
+    Unref(std::exchange(item, Ref(src.item)));
+    return *this;
+  }
+
+  InternedString &operator=(InternedString &&src) noexcept {
+    std::swap(item, src.item);
+    return *this;
+  }
+
+  InternedString &operator=(tstring_view value) noexcept {
+    return *this = InternedString{value};
+  }
+
+  void assign(tstring_view value) noexcept {
+    *this = value;
+  }
+
+  constexpr bool empty() const noexcept {
+    return item == nullptr;
+  }
+
+  [[gnu::pure]]
+  std::size_t size() const noexcept;
+
+  /**
+   * Returns a pointer to the null-terminated value.
+   */
+  [[gnu::pure]]
+  const TCHAR *c_str() const noexcept;
+
+  operator tstring_view() const noexcept {
+    return {c_str(), size()};
+  }
+
+  /**
+   * Equal values always share the same buffer, so this is just a
+   * pointer comparison.
+   */
+  constexpr bool operator==(const InternedString &other) const noexcept {
+    return item == other.item;
+  }
+
+  bool operator==(tstring_view other) const noexcept {
+    return tstring_view{*this} == other;
+  }
+
+private:
+  static const Item *Ref(const Item *item) noexcept;
+  static void Unref(const Item *item) noexcept;
+};
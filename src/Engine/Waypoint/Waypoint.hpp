@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Origin.hpp"
+#include "InternedString.hpp"
 #include "util/tstring.hpp"
 #include "Geo/GeoPoint.hpp"
 #include "Geo/Flat/FlatGeoPoint.hpp"
@@ -84,15 +85,21 @@ struct Waypoint {
 
   /** Name of waypoint */
   tstring name;
+
+  /*
+   * The following attributes are often empty or repeated across
+   * many waypoints of a file, therefore they are interned.
+   */
+
   /** Additional comment text for waypoint */
-  tstring comment;
+  InternedString comment;
   /** Airfield or additional (long) details */
-  tstring details;
+  InternedString details;
   /** Additional files to be displayed in the WayointDetails dialog */
-  std::forward_list<tstring> files_embed;
+  std::forward_list<InternedString> files_embed;
 #ifdef HAVE_RUN_FILE
   /** Additional files to be opened by external programs */
-  std::forward_list<tstring> files_external;
+  std::forward_list<InternedString> files_external;
 #endif
 
   /** Unique id */
@@ -305,7 +305,7 @@ Waypoints::Replace(const WaypointPtr &orig, Waypoint &&replacement) noexcept
       ScheduleOptimise();
   }
 
-  WaypointPtr new_ptr(new Waypoint(std::move(replacement)));
+  auto new_ptr = std::make_shared<const Waypoint>(std::move(replacement));
   name_tree.Add(new_ptr);
 
   auto f = waypoint_tree.FindNearestIf(waypoint_tree.GetPosition(orig), 0,
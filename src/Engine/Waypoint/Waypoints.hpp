@@ -85,6 +85,15 @@ public:
     return serial;
   }
 
+  /**
+   * Returns the id which will be assigned to the next appended
+   * waypoint.  Ids are assigned in ascending order, so this can be
+   * used to find the waypoints appended after this call.
+   */
+  unsigned GetNextId() const noexcept {
+    return next_id;
+  }
+
   /**
    * Add this waypoint to internal store.
    * Optimise() must be called after inserting waypoints prior to
@@ -102,7 +111,7 @@ public:
    * @param wp Waypoint to add to internal store
    */
   WaypointPtr Append(Waypoint &&wp) noexcept {
-    WaypointPtr ptr(new Waypoint(std::move(wp)));
+    auto ptr = std::make_shared<const Waypoint>(std::move(wp));
     Append(ptr);
     return ptr;
   }
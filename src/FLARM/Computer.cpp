@@ -3,22 +3,32 @@
 
 #include "Computer.hpp"
 #include "Details.hpp"
+#include "List.hpp"
+#include "Store.hpp"
 #include "NMEA/Info.hpp"
 #include "Geo/GeoVector.hpp"
 #include "time/Cast.hxx"
 
 void
-FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
+FlarmComputer::Process(FlarmData &flarm,
+                       std::span<const TrafficList *const> sources,
                        const NMEAInfo &basic) noexcept
 {
   // Cleanup old calculation instances
   if (basic.time_available)
     flarm_calculations.CleanUp(basic.time);
 
+  /* always build a new snapshot, because readers may still hold the
+     previous one */
+  store = std::make_shared<TrafficStore>();
+
   // if (FLARM data is available)
   if (!flarm.IsDetected())
     return;
 
+  for (const TrafficList *source : sources)
+    store->Complement(*source);
+
   double north_to_latitude(0);
   double east_to_longitude(0);
 
@@ -43,7 +53,7 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
   }
 
   // for each item in traffic
-  for (auto &traffic : flarm.traffic.list) {
+  for (auto &traffic : store->GetList()) {
     // if we don't know the target's name yet
     if (!traffic.HasName()) {
       // lookup the name of this target's id
@@ -85,8 +95,9 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
       continue;
 
     // Check if the target has been seen before in the last seconds
-    const FlarmTraffic *last_traffic =
-      last_flarm.traffic.FindTraffic(traffic.id);
+    const FlarmTraffic *last_traffic = last_fix_store != nullptr
+      ? last_fix_store->FindTraffic(traffic.id)
+      : nullptr;
     if (last_traffic == NULL || !last_traffic->valid)
       continue;
 
@@ -136,4 +147,18 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
         traffic.speed = last_traffic->speed;
     }
   }
+
+  store->UpdateIndex();
+
+  /* copy the results to the merged (but size-limited) list in
+     #NMEAInfo */
+  for (auto &i : flarm.traffic.list)
+    if (const FlarmTraffic *t = store->FindTraffic(i.id))
+      i = *t;
+}
+
+void
+FlarmComputer::SaveLastFix() noexcept
+{
+  last_fix_store = store;
 }
@@ -5,17 +5,54 @@
 
 #include "Calculations.hpp"
 
+#include <memory>
+#include <span>
+
 struct FlarmData;
 struct NMEAInfo;
+struct TrafficList;
+class TrafficStore;
 
 class FlarmComputer {
   FlarmCalculations flarm_calculations;
 
+  /**
+   * The merged traffic of all sources, built by Process().
+   */
+  std::shared_ptr<TrafficStore> store;
+
+  /**
+   * The #store snapshot at the time of the last GPS fix, see
+   * SaveLastFix().
+   */
+  std::shared_ptr<const TrafficStore> last_fix_store;
+
 public:
   /**
-   * Calculates location, altitude, average climb speed and
-   * looks up the callsign of each target
+   * Merges the traffic of all sources into a new #TrafficStore and
+   * calculates location, altitude, average climb speed and looks up
+   * the callsign of each target.  The results are also copied to
+   * the targets in FlarmData::traffic.
+   *
+   * @param sources the traffic lists of all devices which were
+   * merged into #basic
    */
-  void Process(FlarmData &flarm, const FlarmData &last_flarm,
+  void Process(FlarmData &flarm,
+               std::span<const TrafficList *const> sources,
                const NMEAInfo &basic) noexcept;
+
+  /**
+   * Remember the current traffic for the calculations at the next
+   * GPS fix.
+   */
+  void SaveLastFix() noexcept;
+
+  /**
+   * Returns the snapshot built by the last Process() call (or
+   * nullptr before the first one).  The caller must not modify it;
+   * the next Process() call builds a new one.
+   */
+  std::shared_ptr<const TrafficStore> GetTraffic() const noexcept {
+    return store;
+  }
 };
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <compare> // for the defaulted spaceship operator
 
@@ -39,6 +40,12 @@ public:
   friend constexpr auto operator<=>(const FlarmId &,
                                     const FlarmId &) noexcept = default;
 
+  struct Hash {
+    constexpr std::size_t operator()(FlarmId id) const noexcept {
+      return id.value;
+    }
+  };
+
   static FlarmId Parse(const char *input, char **endptr_r) noexcept;
 #ifdef _UNICODE
   static FlarmId Parse(const TCHAR *input, TCHAR **endptr_r) noexcept;
@@ -7,15 +7,46 @@
 #include "NMEA/Validity.hpp"
 #include "util/TrivialArray.hxx"
 
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <type_traits>
 
 /**
  * This class keeps track of the traffic objects received from a
- * FLARM.
+ * FLARM (or another traffic source).
+ *
+ * Traffic is looked up by #FlarmId with a small hash table which
+ * lives inside the object (no heap allocations), because it is
+ * copied around with #NMEAInfo.  The traffic of all devices is
+ * merged into a #TrafficStore, which has no size limit.
  */
 struct TrafficList {
-  static constexpr size_t MAX_COUNT = 25;
+  /**
+   * The maximum number of traffic objects.
+   *
+   * This determines the size of this object (roughly 100 bytes per
+   * target) and therefore of #NMEAInfo, which is copied by value
+   * several times per received NMEA buffer and lives on the stack in
+   * a few places.  This is the limit per device; the #TrafficStore
+   * merges all devices.
+   */
+  static constexpr size_t MAX_COUNT = 64;
+
+private:
+  static constexpr unsigned ID_TABLE_BITS = 7;
 
+  /**
+   * The size of #id_table.  Keeping it at least twice as large as
+   * #MAX_COUNT keeps the probe sequences short.
+   */
+  static constexpr std::size_t ID_TABLE_SIZE = std::size_t(1) << ID_TABLE_BITS;
+  static_assert(ID_TABLE_SIZE >= 2 * MAX_COUNT);
+
+  static constexpr uint16_t NO_INDEX = 0xffff;
+  static_assert(MAX_COUNT < NO_INDEX);
+
+public:
   /**
    * Time stamp of the latest modification to this object.
    */
@@ -29,10 +60,20 @@ struct TrafficList {
   /** Flarm traffic information */
   TrivialArray<FlarmTraffic, MAX_COUNT> list;
 
+private:
+  /**
+   * An open addressing hash table (with linear probing) which maps
+   * the #FlarmId of each #list item to its index.  Unused slots are
+   * #NO_INDEX.
+   */
+  std::array<uint16_t, ID_TABLE_SIZE> id_table;
+
+public:
   constexpr void Clear() noexcept {
     modified.Clear();
     new_traffic.Clear();
     list.clear();
+    id_table.fill(NO_INDEX);
   }
 
   constexpr bool IsEmpty() const noexcept {
@@ -54,13 +95,14 @@ struct TrafficList {
       /* don't bother merging the two lists, we can simply memcpy()
          it */
       list = add.list;
+      id_table = add.id_table;
       return;
     }
 
     // Add unique traffic from 'add' list
     for (auto &traffic : add.list) {
       if (FindTraffic(traffic.id) == nullptr) {
-        FlarmTraffic * new_traffic = AllocateTraffic();
+        FlarmTraffic * new_traffic = AllocateTraffic(traffic.id);
         if (new_traffic == nullptr)
           return;
         *new_traffic = traffic;
@@ -72,9 +114,17 @@ struct TrafficList {
     modified.Expire(clock, std::chrono::minutes(5));
     new_traffic.Expire(clock, std::chrono::minutes(1));
 
-    for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
+    bool removed = false;
+    for (unsigned i = list.size(); i-- > 0;) {
+      if (!list[i].Refresh(clock)) {
         list.quick_remove(i);
+        removed = true;
+      }
+    }
+
+    if (removed)
+      /* quick_remove() has moved items around */
+      RebuildIdTable();
   }
 
   constexpr unsigned GetActiveTrafficCount() const noexcept {
@@ -88,11 +138,8 @@ struct TrafficList {
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
   constexpr FlarmTraffic *FindTraffic(FlarmId id) noexcept {
-    for (auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+    const uint16_t i = FindIndex(id);
+    return i != NO_INDEX ? &list[i] : nullptr;
   }
 
   /**
@@ -102,11 +149,8 @@ struct TrafficList {
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
   constexpr const FlarmTraffic *FindTraffic(FlarmId id) const noexcept {
-    for (const auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
+    const uint16_t i = FindIndex(id);
+    return i != NO_INDEX ? &list[i] : nullptr;
   }
 
   /**
@@ -138,14 +182,24 @@ struct TrafficList {
   }
 
   /**
-   * Allocates a new FLARM_TRAFFIC object from the array.
+   * Allocates a new FLARM_TRAFFIC object from the array.  Its
+   * attributes are cleared, except for the id.  The caller must
+   * verify that there is no item with this id yet.
    *
    * @return the FLARM_TRAFFIC pointer, NULL if the array is full
    */
-  constexpr FlarmTraffic *AllocateTraffic() noexcept {
-    return list.full()
-      ? NULL
-      : &list.append();
+  constexpr FlarmTraffic *AllocateTraffic(FlarmId id) noexcept {
+    assert(FindTraffic(id) == nullptr);
+
+    if (list.full())
+      return nullptr;
+
+    const uint16_t i = list.size();
+    FlarmTraffic &traffic = list.append();
+    traffic.Clear();
+    traffic.id = id;
+    InsertIntoIdTable(id, i);
+    return &traffic;
   }
 
   /**
@@ -195,6 +249,47 @@ struct TrafficList {
    * Is set if traffic is present and closer than 4Km.
    */
   bool InCloseRange() const noexcept;
+
+private:
+  [[gnu::const]]
+  static constexpr std::size_t GetIdTableStart(FlarmId id) noexcept {
+    /* Fibonacci hashing: FLARM and ICAO ids are often assigned
+       sequentially, so mix all bits into the table index */
+    return (uint32_t(FlarmId::Hash{}(id)) * 2654435769U)
+      >> (32 - ID_TABLE_BITS);
+  }
+
+  [[gnu::const]]
+  static constexpr std::size_t GetNextIdTableSlot(std::size_t i) noexcept {
+    return (i + 1) % ID_TABLE_SIZE;
+  }
+
+  /**
+   * @return the index of the item with the given id in #list or
+   * #NO_INDEX
+   */
+  constexpr uint16_t FindIndex(FlarmId id) const noexcept {
+    /* this loop terminates because #id_table is never full */
+    for (std::size_t i = GetIdTableStart(id);; i = GetNextIdTableSlot(i)) {
+      const uint16_t index = id_table[i];
+      if (index == NO_INDEX || list[index].id == id)
+        return index;
+    }
+  }
+
+  constexpr void InsertIntoIdTable(FlarmId id, uint16_t index) noexcept {
+    std::size_t i = GetIdTableStart(id);
+    while (id_table[i] != NO_INDEX)
+      i = GetNextIdTableSlot(i);
+
+    id_table[i] = index;
+  }
+
+  constexpr void RebuildIdTable() noexcept {
+    id_table.fill(NO_INDEX);
+    for (std::size_t i = 0; i < list.size(); ++i)
+      InsertIntoIdTable(list[i].id, i);
+  }
 };
 
 static_assert(std::is_trivial<TrafficList>::value, "type is not trivial");
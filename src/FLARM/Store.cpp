@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Store.hpp"
+#include "List.hpp"
+
+/**
+ * Is #a a more critical alert than #b?
+ */
+[[gnu::pure]]
+static bool
+IsMoreCritical(const FlarmTraffic &a, const FlarmTraffic &b) noexcept
+{
+  return (unsigned)a.alarm_level > (unsigned)b.alarm_level ||
+    (a.alarm_level == b.alarm_level &&
+     /* if the levels match -> let the distance decide (smaller
+        distance wins) */
+     a.distance < b.distance);
+}
+
+void
+TrafficStore::Clear() noexcept
+{
+  modified.Clear();
+  new_traffic.Clear();
+  list.clear();
+  ids.clear();
+  grid.clear();
+  alerts.clear();
+  nearest = NO_INDEX;
+}
+
+void
+TrafficStore::Complement(const TrafficList &add) noexcept
+{
+  if (add.modified.Modified(modified))
+    modified = add.modified;
+
+  if (add.new_traffic.Modified(new_traffic))
+    new_traffic = add.new_traffic;
+
+  for (const auto &traffic : add.list)
+    if (ids.try_emplace(traffic.id, list.size()).second)
+      list.push_back(traffic);
+}
+
+void
+TrafficStore::UpdateIndex() noexcept
+{
+  grid.clear();
+  alerts.clear();
+  nearest = NO_INDEX;
+
+  min_row = 0x7fff;
+  max_row = -0x8000;
+
+  for (unsigned i = 0; i < list.size(); ++i) {
+    const FlarmTraffic &traffic = list[i];
+
+    const int row = ToCell(traffic.relative_north);
+    min_row = std::min(min_row, row);
+    max_row = std::max(max_row, row);
+    grid.push_back({MakeCellKey(row, ToCell(traffic.relative_east)), i});
+
+    if (nearest == NO_INDEX || traffic.distance < list[nearest].distance)
+      nearest = i;
+
+    if (traffic.HasAlarm())
+      alerts.push_back(i);
+  }
+
+  std::sort(grid.begin(), grid.end(), [](const auto &a, const auto &b){
+    return a.key < b.key;
+  });
+
+  std::sort(alerts.begin(), alerts.end(), [this](unsigned a, unsigned b){
+    return IsMoreCritical(list[a], list[b]);
+  });
+}
+
+const FlarmTraffic *
+TrafficStore::FindTraffic(FlarmId id) const noexcept
+{
+  const auto i = ids.find(id);
+  return i != ids.end() ? &list[i->second] : nullptr;
+}
+
+bool
+TrafficStore::InCloseRange() const noexcept
+{
+  const FlarmTraffic *traffic = FindNearest();
+  return traffic != nullptr && traffic->distance < (RoughDistance)4000;
+}
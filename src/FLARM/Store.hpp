@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Traffic.hpp"
+#include "NMEA/Validity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+struct TrafficList;
+
+/**
+ * The traffic of all sources, merged into one list.  Unlike
+ * #TrafficList (the fixed-size slot of one device inside
+ * #NMEAInfo), this object lives on the heap and has no size limit.
+ *
+ * It is built by FlarmComputer::Process() and then published as an
+ * immutable snapshot (see BaseBlackboard::GetTraffic()).  Traffic is
+ * looked up by #FlarmId with a hash table, and UpdateIndex() sorts
+ * the targets into a grid of square cells around the own aircraft,
+ * so the renderers can visit only the targets in the area they
+ * draw.
+ */
+class TrafficStore {
+public:
+  /**
+   * The edge length of a grid cell [m].
+   */
+  static constexpr double CELL_SIZE = 2000;
+
+  /**
+   * Time stamp of the latest modification of one of the sources.
+   */
+  Validity modified;
+
+  /**
+   * When was the last new traffic received?
+   */
+  Validity new_traffic;
+
+private:
+  static constexpr unsigned NO_INDEX = ~0U;
+
+  std::vector<FlarmTraffic> list;
+
+  /**
+   * Maps the #FlarmId of each #list item to its index.
+   */
+  std::unordered_map<FlarmId, unsigned, FlarmId::Hash> ids;
+
+  struct GridItem {
+    /**
+     * The cell, see MakeCellKey().
+     */
+    uint32_t key;
+
+    /**
+     * The index in #list.
+     */
+    unsigned index;
+  };
+
+  /**
+   * All targets sorted by their grid cell.  Built by UpdateIndex().
+   */
+  std::vector<GridItem> grid;
+
+  /**
+   * The range of grid rows which contain targets (only valid if
+   * #grid is not empty).
+   */
+  int min_row, max_row;
+
+  /**
+   * The #list indices of all targets with an alarm, the most
+   * critical one first.  Built by UpdateIndex().
+   */
+  std::vector<unsigned> alerts;
+
+  /**
+   * The index of the nearest target or #NO_INDEX.  Calculated by
+   * UpdateIndex().
+   */
+  unsigned nearest = NO_INDEX;
+
+public:
+  void Clear() noexcept;
+
+  bool IsEmpty() const noexcept {
+    return list.empty();
+  }
+
+  unsigned GetActiveTrafficCount() const noexcept {
+    return list.size();
+  }
+
+  std::span<const FlarmTraffic> GetList() const noexcept {
+    return list;
+  }
+
+  /**
+   * Returns the list for modification.  Call UpdateIndex() when
+   * done.
+   */
+  std::span<FlarmTraffic> GetList() noexcept {
+    return list;
+  }
+
+  /**
+   * Adds the traffic from the specified list which is not already
+   * present in this one.
+   */
+  void Complement(const TrafficList &add) noexcept;
+
+  /**
+   * Rebuild the grid, the alert list and the nearest target.  This
+   * must be called after adding traffic and after changing the
+   * position, distance or alarm level of a target.
+   */
+  void UpdateIndex() noexcept;
+
+  /**
+   * Looks up an item in the traffic list.
+   *
+   * @param id FLARM id
+   * @return the FlarmTraffic pointer, nullptr if not found
+   */
+  [[gnu::pure]]
+  const FlarmTraffic *FindTraffic(FlarmId id) const noexcept;
+
+  unsigned TrafficIndex(const FlarmTraffic *t) const noexcept {
+    return t - list.data();
+  }
+
+  const FlarmTraffic *PreviousTraffic(const FlarmTraffic *t) const noexcept {
+    return t > list.data() ? t - 1 : nullptr;
+  }
+
+  const FlarmTraffic *NextTraffic(const FlarmTraffic *t) const noexcept {
+    return t + 1 < list.data() + list.size() ? t + 1 : nullptr;
+  }
+
+  const FlarmTraffic *FirstTraffic() const noexcept {
+    return list.empty() ? nullptr : &list.front();
+  }
+
+  const FlarmTraffic *LastTraffic() const noexcept {
+    return list.empty() ? nullptr : &list.back();
+  }
+
+  /**
+   * Finds the nearest target.  Returns nullptr if the list is empty.
+   */
+  const FlarmTraffic *FindNearest() const noexcept {
+    return nearest != NO_INDEX ? &list[nearest] : nullptr;
+  }
+
+  /**
+   * Finds the most critical alert.  Returns nullptr if there is no
+   * alert.
+   */
+  const FlarmTraffic *FindMaximumAlert() const noexcept {
+    return alerts.empty() ? nullptr : &list[alerts.front()];
+  }
+
+  /**
+   * Invoke the visitor for each target with an alarm, the most
+   * critical one first.
+   */
+  template<typename V>
+  void VisitAlerts(V &&visitor) const {
+    for (const unsigned i : alerts)
+      visitor(list[i]);
+  }
+
+  /**
+   * Is set if traffic is present and closer than 4Km.
+   */
+  [[gnu::pure]]
+  bool InCloseRange() const noexcept;
+
+  /**
+   * Invoke the visitor for each target within the given circle
+   * (relative to the own aircraft, like
+   * FlarmTraffic::relative_north and FlarmTraffic::relative_east).
+   * This looks only at the grid cells which overlap the circle.
+   */
+  template<typename V>
+  void VisitWithin(double north, double east, double radius,
+                   V &&visitor) const {
+    if (grid.empty())
+      return;
+
+    const int first_row = std::max(ToCell(north - radius), min_row);
+    const int last_row = std::min(ToCell(north + radius), max_row);
+    const int first_column = ToCell(east - radius);
+    const int last_column = ToCell(east + radius);
+
+    for (int row = first_row; row <= last_row; ++row) {
+      const uint32_t end = MakeCellKey(row, last_column);
+
+      for (auto i = std::lower_bound(grid.begin(), grid.end(),
+                                     MakeCellKey(row, first_column),
+                                     [](const GridItem &item, uint32_t key){
+                                       return item.key < key;
+                                     });
+           i != grid.end() && i->key <= end; ++i) {
+        const FlarmTraffic &traffic = list[i->index];
+        if (std::hypot(traffic.relative_north - north,
+                       traffic.relative_east - east) <= radius)
+          visitor(traffic);
+      }
+    }
+  }
+
+private:
+  /**
+   * Convert a relative position [m] to a grid row or column.
+   */
+  [[gnu::const]]
+  static int ToCell(double value) noexcept {
+    return int(std::clamp(std::floor(value / CELL_SIZE), -32768., 32767.));
+  }
+
+  /**
+   * Combine row and column to a key whose order matches the row
+   * order first and then the column order.
+   */
+  [[gnu::const]]
+  static constexpr uint32_t MakeCellKey(int row, int column) noexcept {
+    return (uint32_t(row + 0x8000) << 16) | uint32_t(column + 0x8000);
+  }
+};
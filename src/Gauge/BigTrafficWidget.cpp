@@ -45,7 +45,8 @@ protected:
   void CalcAutoZoom();
 
 public:
-  void Update(Angle new_direction, const TrafficList &new_data,
+  void Update(Angle new_direction,
+              std::shared_ptr<const TrafficStore> new_data,
               const TeamCodeSettings &new_settings);
   void UpdateTaskDirection(bool show_task_direction, Angle bearing);
 
@@ -179,12 +180,11 @@ FlarmTrafficControl::CalcAutoZoom()
   bool warning_mode = WarningMode();
   RoughDistance zoom_dist = 0;
 
-  for (auto it = data.list.begin(), end = data.list.end();
-      it != end; ++it) {
-    if (warning_mode && !it->HasAlarm())
+  for (const auto &traffic : data->GetList()) {
+    if (warning_mode && !traffic.HasAlarm())
       continue;
 
-    zoom_dist = std::max(it->distance, zoom_dist);
+    zoom_dist = std::max(traffic.distance, zoom_dist);
   }
 
   double zoom_dist2 = zoom_dist;
@@ -197,10 +197,12 @@ FlarmTrafficControl::CalcAutoZoom()
 }
 
 void
-FlarmTrafficControl::Update(Angle new_direction, const TrafficList &new_data,
+FlarmTrafficControl::Update(Angle new_direction,
+                            std::shared_ptr<const TrafficStore> new_data,
                             const TeamCodeSettings &new_settings)
 {
-  FlarmTrafficWindow::Update(new_direction, new_data, new_settings);
+  FlarmTrafficWindow::Update(new_direction, std::move(new_data),
+                             new_settings);
 
   if (enable_auto_zoom || WarningMode())
     CalcAutoZoom();
@@ -474,7 +476,7 @@ FlarmTrafficControl::PaintTrafficInfo(Canvas &canvas) const
     return;
 
   // Shortcut to the selected traffic
-  FlarmTraffic traffic = data.list[WarningMode() ? warning : selection];
+  FlarmTraffic traffic = data->GetList()[WarningMode() ? warning : selection];
   assert(traffic.IsDefined());
 
   const unsigned padding = Layout::GetTextPadding();
@@ -736,9 +738,10 @@ TrafficWidget::Update() noexcept
 {
   const NMEAInfo &basic = CommonInterface::Basic();
   const DerivedInfo &calculated = CommonInterface::Calculated();
+  const auto &traffic = CommonInterface::GetTraffic();
 
   if (CommonInterface::GetUISettings().traffic.auto_close_dialog &&
-      basic.flarm.traffic.IsEmpty() &&
+      (traffic == nullptr || traffic->IsEmpty()) &&
       /* auto-close only really closes the FLARM radar if the
          "restored" page has no FLARM radar */
       PageActions::GetConfiguredLayout().main != PageLayout::Main::FLARM_RADAR) {
@@ -750,7 +753,7 @@ TrafficWidget::Update() noexcept
   }
 
   windows->view.Update(basic.track,
-               basic.flarm.traffic,
+               traffic,
                CommonInterface::GetComputerSettings().team_code);
 
   windows->view.UpdateTaskDirection(calculated.task_stats.task_valid &&
@@ -875,9 +878,10 @@ void
 TrafficWidget::UpdateButtons() noexcept
 {
   const bool unlocked = !windows->view.WarningMode();
-  const TrafficList &traffic = CommonInterface::Basic().flarm.traffic;
-  const bool not_empty = !traffic.IsEmpty();
-  const bool two_or_more = traffic.GetActiveTrafficCount() >= 2;
+  const TrafficStore *traffic = CommonInterface::GetTraffic().get();
+  const bool not_empty = traffic != nullptr && !traffic->IsEmpty();
+  const bool two_or_more = traffic != nullptr &&
+    traffic->GetActiveTrafficCount() >= 2;
 
   windows->zoom_in_button.SetEnabled(unlocked && windows->view.CanZoomIn());
   windows->zoom_out_button.SetEnabled(unlocked && windows->view.CanZoomOut());
@@ -29,17 +29,17 @@ FlarmTrafficWindow::FlarmTrafficWindow(const FlarmTrafficLook &_look,
                                        bool _small) noexcept
   :look(_look),
    radar_renderer(_h_padding, _v_padding),
-   small(_small)
+   small(_small),
+   data(std::make_shared<const TrafficStore>())
 {
-  data.Clear();
 }
 
 bool
 FlarmTrafficWindow::WarningMode() const noexcept
 {
-  assert(warning < (int)data.list.size());
-  assert(warning < 0 || data.list[warning].IsDefined());
-  assert(warning < 0 || data.list[warning].HasAlarm());
+  assert(warning < (int)data->GetList().size());
+  assert(warning < 0 || data->GetList()[warning].IsDefined());
+  assert(warning < 0 || data->GetList()[warning].HasAlarm());
 
   return warning >= 0;
 }
@@ -55,8 +55,8 @@ FlarmTrafficWindow::OnResize(PixelSize new_size) noexcept
 void
 FlarmTrafficWindow::SetTarget(int i) noexcept
 {
-  assert(i < (int)data.list.size());
-  assert(i < 0 || data.list[i].IsDefined());
+  assert(i < (int)data->GetList().size());
+  assert(i < 0 || data->GetList()[i].IsDefined());
 
   if (selection == i)
     return;
@@ -75,16 +75,16 @@ FlarmTrafficWindow::NextTarget() noexcept
   if (WarningMode())
     return;
 
-  assert(selection < (int)data.list.size());
+  assert(selection < (int)data->GetList().size());
 
   const FlarmTraffic *traffic;
   if (selection >= 0)
-    traffic = data.NextTraffic(&data.list[selection]);
+    traffic = data->NextTraffic(&data->GetList()[selection]);
   else
     traffic = NULL;
 
   if (traffic == NULL)
-    traffic = data.FirstTraffic();
+    traffic = data->FirstTraffic();
 
   SetTarget(traffic);
 }
@@ -99,16 +99,16 @@ FlarmTrafficWindow::PrevTarget() noexcept
   if (WarningMode())
     return;
 
-  assert(selection < (int)data.list.size());
+  assert(selection < (int)data->GetList().size());
 
   const FlarmTraffic *traffic;
   if (selection >= 0)
-    traffic = data.PreviousTraffic(&data.list[selection]);
+    traffic = data->PreviousTraffic(&data->GetList()[selection]);
   else
     traffic = NULL;
 
   if (traffic == NULL)
-    traffic = data.LastTraffic();
+    traffic = data->LastTraffic();
 
   SetTarget(traffic);
 }
@@ -137,15 +137,15 @@ FlarmTrafficWindow::UpdateSelector(const FlarmId id,
 }
 
 /**
- * Iterates through the traffic array, finds the target with the highest
- * alarm level and saves it to "warning".
+ * Finds the target with the highest alarm level and saves it to
+ * "warning".
  */
 void
 FlarmTrafficWindow::UpdateWarnings() noexcept
 {
-  const FlarmTraffic *alert = data.FindMaximumAlert();
+  const FlarmTraffic *alert = data->FindMaximumAlert();
   warning = alert != NULL
-    ? (int)data.TrafficIndex(alert)
+    ? (int)data->TrafficIndex(alert)
     : - 1;
 }
 
@@ -153,20 +153,25 @@ FlarmTrafficWindow::UpdateWarnings() noexcept
  * This should be called when the radar needs to be repainted
  */
 void
-FlarmTrafficWindow::Update(Angle new_direction, const TrafficList &new_data,
+FlarmTrafficWindow::Update(Angle new_direction,
+                           std::shared_ptr<const TrafficStore> new_data,
                            const TeamCodeSettings &new_settings) noexcept
 {
+  if (new_data == nullptr)
+    /* no traffic has been merged yet */
+    new_data = std::make_shared<const TrafficStore>();
+
   static constexpr Angle min_heading_delta = Angle::Degrees(2);
-  if (new_data.modified == data.modified &&
+  if (new_data->modified == data->modified &&
       (heading - new_direction).Absolute() < min_heading_delta)
     /* no change - don't redraw */
     return;
 
   FlarmId selection_id;
   PixelPoint pt;
-  if (!small && selection >= 0) {
-    selection_id = data.list[selection].id;
-    pt = sc[selection];
+  if (!small && selection >= 0 && sc[selection]) {
+    selection_id = data->GetList()[selection].id;
+    pt = *sc[selection];
   } else {
     selection_id.Clear();
     pt.x = -100;
@@ -176,7 +181,8 @@ FlarmTrafficWindow::Update(Angle new_direction, const TrafficList &new_data,
   heading = new_direction;
   fr = -heading;
   fir = heading;
-  data = new_data;
+  data = std::move(new_data);
+  sc.assign(data->GetList().size(), std::nullopt);
   settings = new_settings;
 
   UpdateWarnings();
@@ -280,8 +286,11 @@ FlarmTrafficWindow::PaintRadarTarget(Canvas &canvas,
 
   // Calculate screen coordinates
   const auto radar_mid = radar_renderer.GetCenter();
-  sc[i].x = radar_mid.x + iround(p.x * scale);
-  sc[i].y = radar_mid.y + iround(p.y * scale);
+  const PixelPoint pt{
+    radar_mid.x + iround(p.x * scale),
+    radar_mid.y + iround(p.y * scale),
+  };
+  sc[i] = pt;
 
   const Color *text_color;
   const Pen *target_pen, *circle_pen;
@@ -347,9 +356,9 @@ FlarmTrafficWindow::PaintRadarTarget(Canvas &canvas,
   if (circles > 0) {
     canvas.SelectHollowBrush();
     canvas.Select(*circle_pen);
-    canvas.DrawCircle(sc[i], Layout::FastScale(small ? 8 : 16));
+    canvas.DrawCircle(pt, Layout::FastScale(small ? 8 : 16));
     if (circles == 2)
-      canvas.DrawCircle(sc[i], Layout::FastScale(small ? 10 : 19));
+      canvas.DrawCircle(pt, Layout::FastScale(small ? 10 : 19));
   }
 
   // Create an arrow polygon
@@ -375,7 +384,7 @@ FlarmTrafficWindow::PaintRadarTarget(Canvas &canvas,
   }
 
   // Rotate and shift the arrow
-  PolygonRotateShift(Arrow, sc[i],
+  PolygonRotateShift(Arrow, pt,
                      traffic.track - (enable_north_up ?
                                       Angle::Zero() : heading),
                      Layout::Scale(100u));
@@ -392,7 +401,7 @@ FlarmTrafficWindow::PaintRadarTarget(Canvas &canvas,
 
   if (small) {
     if (!WarningMode() || traffic.HasAlarm())
-      PaintTargetInfoSmall(canvas, traffic, i, *text_color, *arrow_brush);
+      PaintTargetInfoSmall(canvas, traffic, pt, *text_color, *arrow_brush);
 
     return;
   }
@@ -422,8 +431,8 @@ FlarmTrafficWindow::PaintRadarTarget(Canvas &canvas,
 
   PixelSize sz = canvas.CalcTextSize(tmp);
   const PixelPoint tp{
-    sc[i].x + int(Layout::FastScale(11u)),
-    sc[i].y - int(sz.height / 2),
+    pt.x + int(Layout::FastScale(11u)),
+    pt.y - int(sz.height / 2),
   };
 
   // Draw vertical speed shadow
@@ -441,7 +450,7 @@ FlarmTrafficWindow::PaintRadarTarget(Canvas &canvas,
 void
 FlarmTrafficWindow::PaintTargetInfoSmall(Canvas &canvas,
                                          const FlarmTraffic &traffic,
-                                         unsigned i,
+                                         PixelPoint pt,
                                          const Color &text_color,
                                          const Brush &arrow_brush) noexcept
 {
@@ -467,7 +476,7 @@ FlarmTrafficWindow::PaintTargetInfoSmall(Canvas &canvas,
   unsigned dist = Layout::FastScale(traffic.HasAlarm() ? 12 : 8);
 
   // Draw string
-  canvas.DrawText(sc[i].At(dist, -int(tsize.height / 2)), relalt_s);
+  canvas.DrawText(pt.At(dist, -int(tsize.height / 2)), relalt_s);
 
   // Set target_brush for the up/down arrow
   canvas.Select(arrow_brush);
@@ -492,7 +501,7 @@ FlarmTrafficWindow::PaintTargetInfoSmall(Canvas &canvas,
     triangle[j].x = Layout::FastScale(triangle[j].x);
     triangle[j].y = Layout::FastScale(triangle[j].y);
 
-    triangle[j] = sc[i].At(dist + triangle[j].x + int(tsize.width / 2),
+    triangle[j] = pt.At(dist + triangle[j].x + int(tsize.width / 2),
                            flip * (triangle[j].y - int(tsize.height / 2)));
   }
   triangle[3].x = triangle[0].x;
@@ -510,22 +519,24 @@ FlarmTrafficWindow::PaintTargetInfoSmall(Canvas &canvas,
 void
 FlarmTrafficWindow::PaintRadarTraffic(Canvas &canvas) noexcept
 {
-  if (data.IsEmpty()) {
+  std::fill(sc.begin(), sc.end(), std::nullopt);
+
+  if (data->IsEmpty()) {
     PaintRadarNoTraffic(canvas);
     return;
   }
 
-  // Iterate through the traffic (normal traffic)
-  for (unsigned i = 0; i < data.list.size(); ++i) {
-    const FlarmTraffic &traffic = data.list[i];
+  // Normal traffic: only the targets inside the radar circle
+  data->VisitWithin(0, 0, distance, [this, &canvas](const FlarmTraffic &traffic){
+    const unsigned i = data->TrafficIndex(&traffic);
 
     if (!traffic.HasAlarm() &&
         static_cast<unsigned> (selection) != i)
       PaintRadarTarget(canvas, traffic, i);
-  }
+  });
 
   if (selection >= 0) {
-    const FlarmTraffic &traffic = data.list[selection];
+    const FlarmTraffic &traffic = data->GetList()[selection];
 
     if (!traffic.HasAlarm())
       PaintRadarTarget(canvas, traffic, selection);
@@ -534,13 +545,10 @@ FlarmTrafficWindow::PaintRadarTraffic(Canvas &canvas) noexcept
   if (!WarningMode())
     return;
 
-  // Iterate through the traffic (alarm traffic)
-  for (unsigned i = 0; i < data.list.size(); ++i) {
-    const FlarmTraffic &traffic = data.list[i];
-
-    if (traffic.HasAlarm())
-      PaintRadarTarget(canvas, traffic, i);
-  }
+  // Alarm traffic
+  data->VisitAlerts([this, &canvas](const FlarmTraffic &traffic){
+    PaintRadarTarget(canvas, traffic, data->TrafficIndex(&traffic));
+  });
 }
 
 /**
@@ -677,11 +685,11 @@ FlarmTrafficWindow::PaintRadarBackground(Canvas &canvas) const noexcept
 void
 FlarmTrafficWindow::Paint(Canvas &canvas) noexcept
 {
-  assert(selection < (int)data.list.size());
-  assert(selection < 0 || data.list[selection].IsDefined());
-  assert(warning < (int)data.list.size());
-  assert(warning < 0 || data.list[warning].IsDefined());
-  assert(warning < 0 || data.list[warning].HasAlarm());
+  assert(selection < (int)data->GetList().size());
+  assert(selection < 0 || data->GetList()[selection].IsDefined());
+  assert(warning < (int)data->GetList().size());
+  assert(warning < 0 || data->GetList()[warning].IsDefined());
+  assert(warning < 0 || data->GetList()[warning].HasAlarm());
 
   PaintRadarBackground(canvas);
   PaintRadarTraffic(canvas);
@@ -715,12 +723,12 @@ FlarmTrafficWindow::SelectNearTarget(PixelPoint p, int max_distance) noexcept
   int min_distance = 99999;
   int min_id = -1;
 
-  for (unsigned i = 0; i < data.list.size(); ++i) {
-    // If FLARM target does not exist -> next one
-    if (!data.list[i].IsDefined())
+  for (unsigned i = 0; i < sc.size(); ++i) {
+    // If FLARM target was not painted -> next one
+    if (!sc[i])
       continue;
 
-    int distance_sq = (p - sc[i]).MagnitudeSquared();
+    int distance_sq = (p - *sc[i]).MagnitudeSquared();
 
     if (distance_sq > min_distance
         || distance_sq > max_distance * max_distance)
@@ -5,11 +5,14 @@
 
 #include "ui/window/PaintWindow.hpp"
 #include "Renderer/RadarRenderer.hpp"
-#include "FLARM/List.hpp"
+#include "FLARM/Store.hpp"
 #include "TeamCode/Settings.hpp"
 #include "Math/FastRotation.hpp"
 
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
 
 class Color;
 class Brush;
@@ -34,13 +37,17 @@ protected:
 
   const bool small;
 
-  PixelPoint sc[TrafficList::MAX_COUNT];
+  /**
+   * The screen position of each #data item, or std::nullopt if it
+   * was not painted.
+   */
+  std::vector<std::optional<PixelPoint>> sc;
 
   bool enable_north_up = false;
   Angle heading = Angle::Zero();
   FastRotation fr;
   FastIntegerRotation fir;
-  TrafficList data;
+  std::shared_ptr<const TrafficStore> data;
   TeamCodeSettings settings;
 
 public:
@@ -60,18 +67,18 @@ public:
 
   const FlarmTraffic *GetTarget() const noexcept {
     return selection >= 0
-      ? &data.list[selection]
+      ? &data->GetList()[selection]
       : NULL;
   }
 
   void SetTarget(int i) noexcept;
 
   void SetTarget(const FlarmTraffic *traffic) noexcept {
-    SetTarget(traffic != NULL ? (int)data.TrafficIndex(traffic) : -1);
+    SetTarget(traffic != NULL ? (int)data->TrafficIndex(traffic) : -1);
   }
 
   void SetTarget(const FlarmId &id) noexcept {
-    SetTarget(data.FindTraffic(id));
+    SetTarget(data->FindTraffic(id));
   }
 
   void NextTarget() noexcept;
@@ -91,7 +98,8 @@ protected:
 
   void UpdateSelector(FlarmId id, PixelPoint pt) noexcept;
   void UpdateWarnings() noexcept;
-  void Update(Angle new_direction, const TrafficList &new_data,
+  void Update(Angle new_direction,
+              std::shared_ptr<const TrafficStore> new_data,
               const TeamCodeSettings &new_settings) noexcept;
   void PaintRadarNoTraffic(Canvas &canvas) const noexcept;
   void PaintRadarTarget(Canvas &canvas, const FlarmTraffic &traffic,
@@ -99,7 +107,7 @@ protected:
   void PaintRadarTraffic(Canvas &canvas) noexcept;
 
   void PaintTargetInfoSmall(Canvas &canvas, const FlarmTraffic &traffic,
-                            unsigned i,
+                            PixelPoint pt,
                             const Color &text_color,
                             const Brush &arrow_brush) noexcept;
 
@@ -21,6 +21,7 @@ public:
                      const WindowStyle style=WindowStyle()) noexcept;
 
   void Update(const NMEAInfo &gps_info,
+              std::shared_ptr<const TrafficStore> traffic,
               const TeamCodeSettings &settings) noexcept;
 
 private:
@@ -51,9 +52,10 @@ SmallTrafficWindow::SmallTrafficWindow(ContainerWindow &parent,
 
 void
 SmallTrafficWindow::Update(const NMEAInfo &gps_info,
+                           std::shared_ptr<const TrafficStore> traffic,
                            const TeamCodeSettings &settings) noexcept
 {
-  FlarmTrafficWindow::Update(gps_info.track, gps_info.flarm.traffic, settings);
+  FlarmTrafficWindow::Update(gps_info.track, std::move(traffic), settings);
 }
 
 void
@@ -167,5 +169,6 @@ void
 GaugeFLARM::Update(const NMEAInfo &basic) noexcept
 {
   SmallTrafficWindow &window = (SmallTrafficWindow &)GetWindow();
-  window.Update(basic, blackboard.GetComputerSettings().team_code);
+  window.Update(basic, blackboard.GetTraffic(),
+                blackboard.GetComputerSettings().team_code);
 }
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FlatRangeBounds.hpp"
+
+void
+FlatRangeBounds::Resize(std::size_t n) noexcept
+{
+  n_points = n;
+
+  const unsigned n_levels = n > 0 ? std::bit_width(n) : 0;
+  table.ResizeDiscard(n_levels * n);
+}
+
+void
+FlatRangeBounds::BuildLevels() noexcept
+{
+  for (std::size_t width = 1, level = 1; width * 2 <= n_points;
+       width *= 2, ++level) {
+    const FlatBoundingBox *src = table.data() + (level - 1) * n_points;
+    FlatBoundingBox *dest = table.data() + level * n_points;
+
+    /* each box of this level is the union of two adjacent boxes of
+       the previous level */
+    for (std::size_t i = 0; i + width * 2 <= n_points; ++i) {
+      dest[i] = src[i];
+      dest[i].Merge(src[i + width]);
+    }
+  }
+}
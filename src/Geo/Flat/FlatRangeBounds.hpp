@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "FlatBoundingBox.hpp"
+#include "util/AllocatedArray.hxx"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * An index over a sequence of #FlatGeoPoint which calculates the
+ * bounding box of any range of consecutive points in constant time.
+ * This is used by branch-and-bound searches which split index ranges
+ * over and over and need an upper bound for each of them.
+ *
+ * This is a "sparse table": level k stores the bounding box of the
+ * 2^k points starting at each index.  A query merges the two
+ * (possibly overlapping) boxes of the largest level which fits into
+ * the range.
+ */
+class FlatRangeBounds {
+  /**
+   * All levels, each one with #n_points elements; the last 2^k-1
+   * elements of level k are unused.
+   */
+  AllocatedArray<FlatBoundingBox> table;
+
+  std::size_t n_points = 0;
+
+public:
+  /**
+   * Rebuild the index.
+   *
+   * @param get_point a function which returns the #FlatGeoPoint for
+   * an index in the range [0, n)
+   */
+  template<typename F>
+  void Update(std::size_t n, F &&get_point) noexcept {
+    Resize(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+      table[i] = FlatBoundingBox(get_point(i));
+
+    BuildLevels();
+  }
+
+  void Clear() noexcept {
+    n_points = 0;
+  }
+
+  /**
+   * Calculate the bounding box of the points in the index range
+   * [begin, end), which must not be empty.
+   */
+  [[gnu::pure]]
+  FlatBoundingBox Get(std::size_t begin, std::size_t end) const noexcept {
+    assert(begin < end);
+    assert(end <= n_points);
+
+    const unsigned level = std::bit_width(end - begin) - 1;
+    const FlatBoundingBox *row = table.data() + level * n_points;
+
+    FlatBoundingBox box = row[begin];
+    box.Merge(row[end - (std::size_t(1) << level)]);
+    return box;
+  }
+
+private:
+  void Resize(std::size_t n) noexcept;
+
+  /**
+   * Fill all levels above level 0.
+   */
+  void BuildLevels() noexcept;
+};
@@ -15,16 +15,17 @@ FlatRay::Magnitude() const noexcept
 }
 
 std::pair<int, int>
-FlatRay::IntersectsRatio(const FlatRay &that) const noexcept
+FlatRay::IntersectsRatio(const FlatGeoPoint that_point,
+                         const FlatGeoPoint that_vector) const noexcept
 {
   std::pair<int, int> r;
-  r.second = vector.CrossProduct(that.vector);
+  r.second = vector.CrossProduct(that_vector);
   if (r.second == 0)
     // lines are parallel
     return r;
 
-  const FlatGeoPoint delta = that.point - point;
-  r.first = delta.CrossProduct(that.vector);
+  const FlatGeoPoint delta = that_point - point;
+  r.first = delta.CrossProduct(that_vector);
   if (sgn(r.first) * sgn(r.second) < 0 || abs(r.first) > abs(r.second)) {
     // outside first line
     r.second = 0;
@@ -72,7 +73,14 @@ FlatRay::IntersectsDistinct(const FlatRay &that) const noexcept
 double
 FlatRay::DistinctIntersection(const FlatRay &that) const noexcept
 {
-  std::pair<int, int> r = IntersectsRatio(that);
+  return DistinctIntersection(that.point, that.point + that.vector);
+}
+
+double
+FlatRay::DistinctIntersection(const FlatGeoPoint from,
+                              const FlatGeoPoint to) const noexcept
+{
+  std::pair<int, int> r = IntersectsRatio(from, to - from);
   if (r.second != 0 &&
       sgn(r.second) * r.first > 0 &&
       abs(r.first) < abs(r.second)) {
@@ -70,6 +70,15 @@ public:
   [[gnu::pure]]
   double DistinctIntersection(const FlatRay &that) const noexcept;
 
+  /**
+   * Like DistinctIntersection(const FlatRay &), but the other ray is
+   * specified by its end points.  This avoids the divisions done by
+   * the #FlatRay constructor.
+   */
+  [[gnu::pure]]
+  double DistinctIntersection(FlatGeoPoint from,
+                              FlatGeoPoint to) const noexcept;
+
 private:
   /**
    * Checks whether two lines intersect or not
@@ -78,5 +87,11 @@ private:
    * adapted from line_line_intersection
    */
   [[gnu::pure]]
-  std::pair<int, int> IntersectsRatio(const FlatRay &that) const noexcept;
+  std::pair<int, int> IntersectsRatio(FlatGeoPoint that_point,
+                                      FlatGeoPoint that_vector) const noexcept;
+
+  [[gnu::pure]]
+  std::pair<int, int> IntersectsRatio(const FlatRay &that) const noexcept {
+    return IntersectsRatio(that.point, that.vector);
+  }
 };
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "PolygonEdgeArray.hpp"
+#include "SearchPointVector.hpp"
+#include "Math/Line2D.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+void
+PolygonEdgeArray::Update(const SearchPointVector &border) noexcept
+{
+  n_vertices = border.size();
+  projected = false;
+
+  longitude.ResizeDiscard(n_vertices);
+  latitude.ResizeDiscard(n_vertices);
+  x.ResizeDiscard(n_vertices);
+  y.ResizeDiscard(n_vertices);
+
+  for (std::size_t i = 0; i < n_vertices; ++i) {
+    const GeoPoint &p = border[i].GetLocation();
+    longitude[i] = p.longitude.Native();
+    latitude[i] = p.latitude.Native();
+  }
+
+  const std::size_t n_edges = n_vertices > 0 ? n_vertices - 1 : 0;
+  blocks.ResizeDiscard((n_edges + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+  for (std::size_t b = 0; b < blocks.size(); ++b) {
+    /* include the end point of the block's last edge */
+    const std::size_t begin = b * BLOCK_SIZE;
+    const std::size_t end = std::min(begin + BLOCK_SIZE, n_edges) + 1;
+    const auto [min, max] = std::minmax_element(latitude.begin() + begin,
+                                                latitude.begin() + end);
+    blocks[b].latitude_min = *min;
+    blocks[b].latitude_max = *max;
+  }
+}
+
+void
+PolygonEdgeArray::Project(const SearchPointVector &border) noexcept
+{
+  assert(border.size() == n_vertices);
+
+  for (std::size_t i = 0; i < n_vertices; ++i) {
+    const FlatGeoPoint &p = border[i].GetFlatLocation();
+    x[i] = p.x;
+    y[i] = p.y;
+  }
+
+  const std::size_t n_edges = n_vertices > 0 ? n_vertices - 1 : 0;
+  for (std::size_t b = 0; b < blocks.size(); ++b) {
+    const std::size_t begin = b * BLOCK_SIZE;
+    const std::size_t end = std::min(begin + BLOCK_SIZE, n_edges) + 1;
+
+    FlatBoundingBox &box = blocks[b].flat;
+    box = FlatBoundingBox(FlatGeoPoint(x[begin], y[begin]));
+    for (std::size_t i = begin + 1; i < end; ++i)
+      box.Expand(FlatGeoPoint(x[i], y[i]));
+  }
+
+  projected = true;
+}
+
+bool
+PolygonEdgeArray::IsInside(const GeoPoint &p) const noexcept
+{
+  /* this is the winding number algorithm from PolygonInterior(),
+     with the same arithmetic, so the results are identical */
+
+  if (n_vertices < 3)
+    return false;
+
+  using Point = Point2D<double>;
+  const Point pt{p.longitude.Native(), p.latitude.Native()};
+
+  const std::size_t n_edges = n_vertices - 1;
+  int wn = 0;
+
+  for (std::size_t b = 0; b < blocks.size(); ++b) {
+    /* edges which don't cross the horizontal line through the point
+       don't affect the winding number */
+    if (blocks[b].latitude_min > pt.y || blocks[b].latitude_max <= pt.y)
+      continue;
+
+    const std::size_t begin = b * BLOCK_SIZE;
+    const std::size_t end = std::min(begin + BLOCK_SIZE, n_edges);
+    for (std::size_t i = begin; i < end; ++i) {
+      const double y0 = latitude[i], y1 = latitude[i + 1];
+      if (y0 <= pt.y) {
+        if (y1 > pt.y) {
+          // an upward crossing
+          const Line2D<Point> edge{{longitude[i], y0}, {longitude[i + 1], y1}};
+          if (edge.LocatePoint(pt) > 0)
+            ++wn;
+        }
+      } else {
+        if (y1 <= pt.y) {
+          // a downward crossing
+          const Line2D<Point> edge{{longitude[i], y0}, {longitude[i + 1], y1}};
+          if (edge.LocatePoint(pt) < 0)
+            --wn;
+        }
+      }
+    }
+  }
+
+  return wn != 0;
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Flat/FlatBoundingBox.hpp"
+#include "Flat/FlatRay.hpp"
+#include "util/AllocatedArray.hxx"
+
+#include <algorithm>
+#include <cstddef>
+
+struct GeoPoint;
+class SearchPointVector;
+
+/**
+ * A copy of the vertices of a closed polygon (see #SearchPointVector)
+ * in a "structure of arrays" layout, optimised for the point-in-polygon
+ * and the segment intersection tests which are done over and over by
+ * the airspace warning code.
+ *
+ * The edges are grouped in blocks of #BLOCK_SIZE; for each block, the
+ * geodetic latitude range and the flat bounding box are stored, which
+ * allows skipping most of the edges of large polygons without
+ * touching their vertices.
+ */
+class PolygonEdgeArray {
+public:
+  static constexpr std::size_t BLOCK_SIZE = 16;
+
+private:
+  struct Block {
+    /**
+     * The latitude range of all vertices of this block (including
+     * the end point of the last edge), in Angle::Native() units.
+     */
+    double latitude_min, latitude_max;
+
+    /**
+     * The flat bounding box of all vertices of this block.  Only
+     * valid if #PolygonEdgeArray::projected is set.
+     */
+    FlatBoundingBox flat;
+  };
+
+  /**
+   * The geodetic vertices in Angle::Native() units.  The last vertex
+   * equals the first one.
+   */
+  AllocatedArray<double> longitude, latitude;
+
+  /**
+   * The projected vertices.
+   */
+  AllocatedArray<int> x, y;
+
+  AllocatedArray<Block> blocks;
+
+  /**
+   * The number of vertices; the number of edges is one less.
+   */
+  std::size_t n_vertices = 0;
+
+  bool projected = false;
+
+public:
+  /**
+   * Copy the geodetic locations from the given (closed) polygon.
+   * The flat locations are invalidated; call Project() afterwards.
+   */
+  void Update(const SearchPointVector &border) noexcept;
+
+  /**
+   * Copy the flat locations from the given polygon, which must be
+   * the one passed to Update() and must have been projected.
+   */
+  void Project(const SearchPointVector &border) noexcept;
+
+  /**
+   * Equivalent to SearchPointVector::IsInside(const GeoPoint &).
+   */
+  [[gnu::pure]]
+  bool IsInside(const GeoPoint &p) const noexcept;
+
+  /**
+   * Invoke a function for each edge which intersects the given ray
+   * (see FlatRay::DistinctIntersection()).  Edges are visited in the
+   * polygon order.
+   *
+   * @param f a function accepting the ray parameter of the
+   * intersection
+   */
+  template<typename F>
+  void VisitIntersections(const FlatRay &ray, F &&f) const noexcept {
+    if (!projected || n_vertices < 2)
+      return;
+
+    FlatBoundingBox ray_box(ray.point);
+    ray_box.Expand(ray.point + ray.vector);
+
+    const std::size_t n_edges = n_vertices - 1;
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+      if (!ray_box.Overlaps(blocks[b].flat))
+        continue;
+
+      const std::size_t begin = b * BLOCK_SIZE;
+      const std::size_t end = std::min(begin + BLOCK_SIZE, n_edges);
+      for (std::size_t i = begin; i < end; ++i) {
+        const auto t =
+          ray.DistinctIntersection(FlatGeoPoint(x[i], y[i]),
+                                   FlatGeoPoint(x[i + 1], y[i + 1]));
+        if (t >= 0)
+          f(t);
+      }
+    }
+  }
+};
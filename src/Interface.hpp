@@ -49,6 +49,18 @@ Basic() noexcept
   return Private::blackboard.Basic();
 }
 
+/**
+ * Returns the merged traffic of all devices (may be nullptr).
+ */
+[[gnu::const]]
+static inline const std::shared_ptr<const TrafficStore> &
+GetTraffic() noexcept
+{
+  assert(InMainThread());
+
+  return Private::blackboard.GetTraffic();
+}
+
 /**
  * Returns InterfaceBlackboard.Calculated (DERIVED_INFO) (read-only)
  * @return InterfaceBlackboard.Calculated
@@ -201,6 +213,14 @@ ReadBlackboardBasic(const MoreData &nmea_info) noexcept
   Private::blackboard.ReadBlackboardBasic(nmea_info);
 }
 
+static inline void
+ReadTraffic(const std::shared_ptr<const TrafficStore> &traffic) noexcept
+{
+  assert(InMainThread());
+
+  Private::blackboard.ReadTraffic(traffic);
+}
+
 static inline void
 ReadBlackboardCalculated(const DerivedInfo &derived_info) noexcept
 {
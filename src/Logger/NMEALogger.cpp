@@ -56,3 +56,19 @@ NMEALogger::Log(const char *text) noexcept
   } catch (...) {
   }
 }
+
+void
+NMEALogger::Log(std::span<const char *const> lines) noexcept
+{
+  if (!enabled)
+    return;
+
+  const std::lock_guard lock{mutex};
+
+  try {
+    Start();
+    for (const char *line : lines)
+      WriteLine(*file, line);
+  } catch (...) {
+  }
+}
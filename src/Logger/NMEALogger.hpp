@@ -6,6 +6,7 @@
 #include "thread/Mutex.hxx"
 
 #include <memory>
+#include <span>
 
 class FileOutputStream;
 
@@ -37,6 +38,11 @@ public:
    */
   void Log(const char *line) noexcept;
 
+  /**
+   * Logs several NMEA strings at once (locking the mutex only once).
+   */
+  void Log(std::span<const char *const> lines) noexcept;
+
 private:
   void Start();
 };
@@ -34,6 +34,7 @@
 #include "UIReceiveBlackboard.hpp"
 #include "UISettings.hpp"
 #include "Interface.hpp"
+#include "FLARM/Store.hpp"
 #include "Components.hpp"
 #include "BackendComponents.hpp"
 
@@ -1142,11 +1143,12 @@ void
 MainWindow::UpdateTrafficGaugeVisibility() noexcept
 {
   const FlarmData &flarm = CommonInterface::Basic().flarm;
+  const TrafficStore *traffic = CommonInterface::GetTraffic().get();
 
   bool traffic_visible =
     (force_traffic_gauge ||
      (CommonInterface::GetUISettings().traffic.enable_gauge &&
-      !flarm.traffic.IsEmpty())) &&
+      traffic != nullptr && !traffic->IsEmpty())) &&
     !CommonInterface::GetUIState().screen_blanked &&
     /* hide the traffic gauge while the traffic widget is visible, to
        avoid showing the same information twice */
@@ -1164,7 +1166,7 @@ MainWindow::UpdateTrafficGaugeVisibility() noexcept
     if (HasDialog())
       return;
 
-    if (!flarm.traffic.InCloseRange())
+    if (traffic == nullptr || !traffic->InCloseRange())
       return;
 
     if (!traffic_gauge.IsDefined())
@@ -108,6 +108,7 @@ GlueMapWindow::ExchangeBlackboard() noexcept
     const std::lock_guard lock{device_blackboard.mutex};
     ReadBlackboard(device_blackboard.Basic(),
                    device_blackboard.Calculated());
+    ReadTraffic(device_blackboard.GetTraffic());
   }
 
 #ifndef ENABLE_OPENGL
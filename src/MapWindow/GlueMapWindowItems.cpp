@@ -80,7 +80,8 @@ GlueMapWindow::ShowMapItems(const GeoPoint &location,
     builder.AddWeatherStations(*noaa_store);
 #endif
 
-  builder.AddTraffic(basic.flarm.traffic);
+  if (const auto &traffic = CommonInterface::GetTraffic())
+    builder.AddTraffic(*traffic);
 
 #ifdef HAVE_SKYLINES_TRACKING
   builder.AddSkyLinesTraffic();
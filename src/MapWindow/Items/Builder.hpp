@@ -17,7 +17,7 @@ class Waypoints;
 struct MoreData;
 struct DerivedInfo;
 class ProtectedTaskManager;
-struct TrafficList;
+class TrafficStore;
 struct ThermalLocatorInfo;
 struct NMEAInfo;
 class RasterTerrain;
@@ -46,7 +46,7 @@ public:
                           const AirspaceRendererSettings &renderer_settings,
                           const MoreData &basic, const DerivedInfo &calculated);
   void AddTaskOZs(const ProtectedTaskManager &task);
-  void AddTraffic(const TrafficList &flarm);
+  void AddTraffic(const TrafficStore &flarm);
   void AddSkyLinesTraffic();
   void AddThermals(const ThermalLocatorInfo &thermals,
                    const MoreData &basic, const DerivedInfo &calculated);
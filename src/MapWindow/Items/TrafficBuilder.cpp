@@ -4,7 +4,7 @@
 #include "Builder.hpp"
 #include "MapItem.hpp"
 #include "List.hpp"
-#include "FLARM/List.hpp"
+#include "FLARM/Store.hpp"
 #include "FLARM/Friends.hpp"
 #include "Tracking/SkyLines/Data.hpp"
 #include "Tracking/TrackingGlue.hpp"
@@ -12,9 +12,9 @@
 #include "NetComponents.hpp"
 
 void
-MapItemListBuilder::AddTraffic(const TrafficList &flarm)
+MapItemListBuilder::AddTraffic(const TrafficStore &flarm)
 {
-  for (const auto &t : flarm.list) {
+  for (const auto &t : flarm.GetList()) {
     if (list.full())
       break;
 
@@ -3,6 +3,7 @@
 
 #include "MapWindowBlackboard.hpp"
 #include "FLARM/Friends.hpp"
+#include "FLARM/Store.hpp"
 
 void
 MapWindowBlackboard::ReadComputerSettings(const ComputerSettings &settings) noexcept
@@ -26,7 +27,8 @@ IsFriend(FlarmId id) noexcept
 static void
 UpdateFadingTraffic(bool fade_traffic,
                     std::map<FlarmId, FlarmTraffic> &dest,
-                    const TrafficList &old_list, const TrafficList &new_list,
+                    const TrafficStore *old_store,
+                    const TrafficStore *new_store,
                     TimeStamp now) noexcept
 {
   if (!fade_traffic) {
@@ -34,17 +36,20 @@ UpdateFadingTraffic(bool fade_traffic,
     return;
   }
 
-  if (new_list.modified.Modified(old_list.modified)||true) {
-    /* first add all items from the old list */
-    for (const auto &traffic : old_list.list)
-      if (traffic.location_available)
+  if (old_store != nullptr && new_store != nullptr &&
+      new_store != old_store) {
+    /* first add all items from the old list which have disappeared
+       from the new list */
+    for (const auto &traffic : old_store->GetList())
+      if (traffic.location_available &&
+          new_store->FindTraffic(traffic.id) == nullptr)
         dest.try_emplace(traffic.id, traffic);
 
-    /* now remove all items that are in the new list; now only items
-       remain that have disappeared */
-    for (const auto &traffic : new_list.list)
-      if (auto i = dest.find(traffic.id); i != dest.end())
-        dest.erase(i);
+    /* now remove all fading items which have reappeared */
+    if (!dest.empty())
+      for (const auto &traffic : new_store->GetList())
+        if (auto i = dest.find(traffic.id); i != dest.end())
+          dest.erase(i);
   }
 
   /* remove all items that havn't been seen again for too long */
@@ -62,12 +67,17 @@ void
 MapWindowBlackboard::ReadBlackboard(const MoreData &nmea_info,
 				    const DerivedInfo &derived_info) noexcept
 {
-  UpdateFadingTraffic(settings_map.fade_traffic,
-                      fading_flarm_traffic, gps_info.flarm.traffic,
-                      nmea_info.flarm.traffic,
-                      nmea_info.clock);
-
   gps_info = nmea_info;
   calculated_info = derived_info;
 }
 
+void
+MapWindowBlackboard::ReadTraffic(std::shared_ptr<const TrafficStore> _traffic) noexcept
+{
+  UpdateFadingTraffic(settings_map.fade_traffic,
+                      fading_flarm_traffic, traffic.get(), _traffic.get(),
+                      gps_info.clock);
+
+  traffic = std::move(_traffic);
+}
+
@@ -31,8 +31,6 @@ class MapWindowBlackboard:
 
 protected:
   MapWindowBlackboard() noexcept {
-    /* this needs to be initialised because ReadBlackboard() uses the
-       previous FLARM traffic list */
     gps_info.Reset();
   }
 
@@ -78,6 +76,12 @@ protected:
 
   void ReadBlackboard(const MoreData &nmea_info,
                       const DerivedInfo &derived_info) noexcept;
+
+  /**
+   * Replace the traffic snapshot and update the fading traffic.
+   * Call this after ReadBlackboard().
+   */
+  void ReadTraffic(std::shared_ptr<const TrafficStore> _traffic) noexcept;
   void ReadComputerSettings(const ComputerSettings &settings) noexcept;
   void ReadMapSettings(const MapSettings &settings) noexcept;
 
@@ -9,6 +9,8 @@
 #include "Renderer/TextInBox.hpp"
 #include "Renderer/TrafficRenderer.hpp"
 #include "FLARM/Friends.hpp"
+#include "FLARM/Store.hpp"
+#include "Geo/GeoVector.hpp"
 #include "Tracking/SkyLines/Data.hpp"
 #include "util/StringCompare.hxx"
 
@@ -83,7 +85,9 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
     return;
 
   // Return if FLARM data is not available
-  const TrafficList &flarm = Basic().flarm.traffic;
+  const TrafficStore *flarm = GetTraffic().get();
+  if (flarm == nullptr)
+    return;
 
   const WindowProjection &projection = render_projection;
 
@@ -95,13 +99,22 @@ MapWindow::DrawFLARMTraffic(Canvas &canvas,
 
   canvas.Select(*traffic_look.font);
 
-  // Circle through the FLARM targets
-  for (const auto &traffic : flarm.list) {
-    if (!traffic.location_available)
-      continue;
-
-    DrawFlarmTraffic(canvas, projection, traffic_look, false,
-                     aircraft_pos, traffic);
+  /* the target locations are calculated from the own location, so
+     this lookup needs it, too */
+  const MoreData &basic = Basic();
+  if (basic.location_available) {
+    // Circle through the FLARM targets around the screen center
+    const GeoVector center =
+      basic.location.DistanceBearing(projection.GetGeoScreenCenter());
+
+    flarm->VisitWithin(center.distance * center.bearing.cos(),
+                       center.distance * center.bearing.sin(),
+                       projection.GetScreenDistanceMeters(),
+                       [&](const FlarmTraffic &traffic){
+      if (traffic.location_available)
+        DrawFlarmTraffic(canvas, projection, traffic_look, false,
+                         aircraft_pos, traffic);
+    });
   }
 
   if (const auto &fading = GetFadingFlarmTraffic(); !fading.empty()) {
@@ -44,7 +44,8 @@ MergeThread::Process() noexcept
                    device_blackboard.Calculated());
 
   flarm_computer.Process(device_blackboard.SetBasic().flarm,
-                         last_fix.flarm, basic);
+                         device_blackboard.GetTrafficSources(), basic);
+  device_blackboard.SetTraffic(flarm_computer.GetTraffic());
 }
 
 void
@@ -88,8 +89,10 @@ MergeThread::Tick() noexcept
     /* update last_fix only when a new GPS fix was received */
     if ((basic.time_available &&
          (!last_fix.time_available || basic.time != last_fix.time)) ||
-        basic.location_available != last_fix.location_available)
+        basic.location_available != last_fix.location_available) {
       last_fix = basic;
+      flarm_computer.SaveLastFix();
+    }
   }
 
 #ifdef HAVE_PCM_PLAYER
@@ -9,6 +9,35 @@
 #include <cstdio>
 #include <cstdint>
 
+/* XOR is associative and commutative: folding the eight bytes of
+   the accumulated word yields the same result as the byte-wise loop,
+   regardless of the byte order (and the compiler may vectorise the
+   word loop even further) */
+uint8_t
+FastNMEAChecksum(std::string_view src) noexcept
+{
+  if (!src.empty() && (src.front() == '$' || src.front() == '!'))
+    src.remove_prefix(1);
+
+  uint64_t word_checksum = 0;
+  while (src.size() >= sizeof(word_checksum)) {
+    uint64_t word;
+    memcpy(&word, src.data(), sizeof(word));
+    word_checksum ^= word;
+    src.remove_prefix(sizeof(word));
+  }
+
+  word_checksum ^= word_checksum >> 32;
+  word_checksum ^= word_checksum >> 16;
+  word_checksum ^= word_checksum >> 8;
+
+  auto checksum = static_cast<uint8_t>(word_checksum);
+  for (char ch : src)
+    checksum ^= static_cast<uint8_t>(ch);
+
+  return checksum;
+}
+
 bool
 VerifyNMEAChecksum(const char *p) noexcept
 {
@@ -28,7 +57,7 @@ VerifyNMEAChecksum(const char *p) noexcept
 #if defined(__APPLE__) && (!defined(TARGET_OS_IPHONE) || !TARGET_OS_IPHONE)
   uint8_t CalcCheckSum = NMEAChecksum(p);
 #else
-  uint8_t CalcCheckSum = NMEAChecksum({p, asterisk});
+  uint8_t CalcCheckSum = FastNMEAChecksum({p, asterisk});
 #endif
 
   return CalcCheckSum == ReadCheckSum;
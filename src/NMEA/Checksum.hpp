@@ -59,6 +59,15 @@ NMEAChecksum(std::string_view src) noexcept
   return checksum;
 }
 
+/**
+ * Like NMEAChecksum(std::string_view), but combines eight characters
+ * at a time.  This is the implementation used by
+ * VerifyNMEAChecksum().
+ */
+[[nodiscard]] [[gnu::pure]]
+uint8_t
+FastNMEAChecksum(std::string_view src) noexcept;
+
 /**
  * Verify the NMEA checksum at the end of the specified string,
  * separated with an asterisk ('*').
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+template<typename Handler>
+struct NMEASentenceHandler {
+  /**
+   * The sentence name, e.g. "GGA" or "$PFLAA".  It must not be
+   * empty.
+   */
+  std::string_view name;
+
+  Handler handler;
+};
+
+/**
+ * Maps NMEA sentence names to handlers.  It uses a perfect hash
+ * function which is found at compile time, so looking up a name
+ * costs one hash calculation and one string comparison, no matter
+ * how many sentences there are.
+ *
+ * Construct it with MakeNMEASentenceTable().
+ */
+template<typename Handler, std::size_t N>
+class NMEASentenceTable {
+  using Entry = NMEASentenceHandler<Handler>;
+
+  /**
+   * At least twice as many slots as entries, so a seed without
+   * collisions is found quickly.
+   */
+  static constexpr std::size_t SIZE = std::bit_ceil(2 * N);
+  static constexpr unsigned BITS = std::countr_zero(SIZE);
+
+  uint32_t seed = 0;
+
+  /**
+   * Unused slots have an empty name.
+   */
+  std::array<Entry, SIZE> slots{};
+
+public:
+  consteval explicit NMEASentenceTable(const Entry (&entries)[N]) {
+    for (unsigned i = 0; i < 0x10000; ++i, ++seed)
+      if (Fill(entries))
+        return;
+
+    /* cannot be evaluated at compile time: this is a compile-time
+       error message */
+    throw std::logic_error("No perfect hash found");
+  }
+
+  /**
+   * @return a pointer to the handler or nullptr if there is none
+   * for this sentence
+   */
+  [[gnu::pure]]
+  constexpr const Handler *Find(std::string_view name) const noexcept {
+    const Entry &slot = slots[Hash(name, seed)];
+    return !name.empty() && slot.name == name
+      ? &slot.handler
+      : nullptr;
+  }
+
+private:
+  /**
+   * An FNV-1a variant whose upper bits (which are mixed best)
+   * select the slot.
+   */
+  [[gnu::pure]]
+  static constexpr std::size_t Hash(std::string_view name,
+                                    uint32_t seed) noexcept {
+    uint32_t hash = 2166136261U ^ seed;
+    for (const char ch : name)
+      hash = (hash ^ static_cast<uint8_t>(ch)) * 16777619U;
+
+    return (hash * 2654435769U) >> (32 - BITS);
+  }
+
+  /**
+   * Try to fill #slots with the current #seed.
+   *
+   * @return false on collision
+   */
+  constexpr bool Fill(const Entry (&entries)[N]) noexcept {
+    slots = {};
+
+    for (const Entry &entry : entries) {
+      Entry &slot = slots[Hash(entry.name, seed)];
+      if (!slot.name.empty())
+        return false;
+
+      slot = entry;
+    }
+
+    return true;
+  }
+};
+
+/**
+ * Build a #NMEASentenceTable at compile time.  Example:
+ *
+ *   static constexpr auto table = MakeNMEASentenceTable<Handler>({
+ *     {"$PFLAU", HandlePFLAU},
+ *     {"$PFLAA", HandlePFLAA},
+ *   });
+ */
+template<typename Handler, std::size_t N>
+consteval auto
+MakeNMEASentenceTable(const NMEASentenceHandler<Handler> (&entries)[N])
+{
+  return NMEASentenceTable<Handler, N>{entries};
+}
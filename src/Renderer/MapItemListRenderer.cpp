@@ -31,7 +31,7 @@
 #include "FLARM/Details.hpp"
 #include "FLARM/FlarmNetRecord.hpp"
 #include "Weather/Features.hpp"
-#include "FLARM/List.hpp"
+#include "FLARM/Store.hpp"
 #include "time/RoughTime.hpp"
 #include "time/BrokenDateTime.hpp"
 
@@ -301,7 +301,7 @@ Draw(Canvas &canvas, PixelRect rc,
      const TrafficMapItem &item,
      const TwoTextRowsRenderer &row_renderer,
      const TrafficLook &traffic_look,
-     const TrafficList *traffic_list)
+     const TrafficStore *traffic_list)
 {
   const unsigned line_height = rc.GetHeight();
   const unsigned text_padding = Layout::GetTextPadding();
@@ -428,7 +428,7 @@ Draw(Canvas &canvas, PixelRect rc,
 void
 MapItemListRenderer::Draw(Canvas &canvas, const PixelRect rc,
                           const MapItem &item,
-                          const TrafficList *traffic_list)
+                          const TrafficStore *traffic_list)
 {
   switch (item.type) {
   case MapItem::Type::LOCATION:
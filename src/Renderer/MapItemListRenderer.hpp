@@ -14,7 +14,7 @@ struct MapLook;
 struct TrafficLook;
 struct FinalGlideBarLook;
 struct MapSettings;
-struct TrafficList;
+class TrafficStore;
 
 class MapItemListRenderer {
   const MapLook &look;
@@ -38,5 +38,5 @@ public:
   unsigned CalculateLayout(const DialogLook &dialog_look);
 
   void Draw(Canvas &canvas, const PixelRect rc, const MapItem &item,
-            const TrafficList *traffic_list=nullptr);
+            const TrafficStore *traffic_list=nullptr);
 };
@@ -18,7 +18,7 @@ bool
 TrailRenderer::LoadTrace(const TraceComputer &trace_computer) noexcept
 {
   trace.clear();
-  trace_computer.LockedCopyTo(trace);
+  trace_computer.CopyTo(trace);
   return !trace.empty();
 }
 
@@ -28,10 +28,10 @@ TrailRenderer::LoadTrace(const TraceComputer &trace_computer,
                          const WindowProjection &projection) noexcept
 {
   trace.clear();
-  trace_computer.LockedCopyTo(trace,
-                              min_time.Cast<std::chrono::duration<unsigned>>(),
-                              projection.GetGeoScreenCenter(),
-                              projection.DistancePixelsToMeters(3));
+  trace_computer.CopyTo(trace,
+                        min_time.Cast<std::chrono::duration<unsigned>>(),
+                        projection.GetGeoScreenCenter(),
+                        projection.DistancePixelsToMeters(3));
   return !trace.empty();
 }
 
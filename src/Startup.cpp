@@ -90,11 +90,13 @@
 #include "Units/Units.hpp"
 #include "Formatter/UserGeoPointFormatter.hpp"
 #include "thread/Debug.hpp"
+#include "thread/ThreadPool.hpp"
 
 #include "lua/StartFile.hpp"
 #include "lua/Background.hpp"
 
 #include "util/ScopeExit.hxx"
+#include "util/StaticString.hxx"
 
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/Globals.hpp"
@@ -108,6 +110,36 @@
 #include "Android/NativeView.hpp"
 #endif
 
+/**
+ * An #OperationEnvironment for a job which runs in a worker thread
+ * during startup.  Progress is discarded, and the first error message
+ * is recorded, to be shown by the main thread after the job has
+ * finished.
+ */
+class DeferredErrorOperationEnvironment final
+  : public NullOperationEnvironment {
+  StaticString<256> error;
+
+public:
+  DeferredErrorOperationEnvironment() noexcept {
+    error.clear();
+  }
+
+  bool HasError() const noexcept {
+    return !error.empty();
+  }
+
+  const TCHAR *GetError() const noexcept {
+    return error.c_str();
+  }
+
+  /* virtual methods from class OperationEnvironment */
+  void SetErrorMessage(const TCHAR *text) noexcept override {
+    if (error.empty())
+      error = text;
+  }
+};
+
 static TaskManager *task_manager;
 static GlideComputerEvents *glide_computer_events;
 static AllMonitors *all_monitors;
@@ -414,57 +446,89 @@ Startup(UI::Display &display)
                          CommonInterface::SetComputerSettings(), gp);
   task_manager->SetGlidePolar(gp);
 
-  // Read the topography file(s)
+  /* topography, RASP and airspace do not depend on the waypoints
+     (or on each other); load them in worker threads while this
+     thread loads the waypoints */
   data_components->topography = std::make_unique<TopographyStore>();
-  {
-    LogString("Loading Topography File...");
-    operation.SetText(_("Loading Topography File..."));
-    LoadConfiguredTopography(*data_components->topography);
-    operation.SetProgressPosition(256);
-  }
+  std::shared_ptr<RaspStore> rasp;
+  DeferredErrorOperationEnvironment airspace_env;
 
-  // Read the waypoint files
-  LogString("ReadWaypoints");
   {
-    SubOperationEnvironment sub_env(operation, 256, 512);
-    sub_env.SetText(_("Loading Waypoints..."));
-    WaypointGlue::LoadWaypoints(*data_components->waypoints,
-                                data_components->terrain.get(),
-                                sub_env);
-  }
+    std::unique_ptr<ThreadPool> pool;
+    try {
+      pool = std::make_unique<ThreadPool>("Startup", 3);
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to start loader threads");
+    }
 
-  // Read and parse the airfield info file
-  try {
-    SubOperationEnvironment sub_env(operation, 512, 768);
-    sub_env.SetText(_("Loading Airfield Details File..."));
-    WaypointDetails::ReadFileFromProfile(*data_components->waypoints, sub_env);
-  } catch (...) {
-    LogError(std::current_exception());
-  }
+    /* without worker threads, everything is loaded in this thread */
+    const auto submit = [&pool](std::function<void()> &&job){
+      if (pool)
+        pool->Submit(std::move(job));
+      else
+        job();
+    };
+
+    submit([&topography = *data_components->topography]{
+      LogString("Loading Topography File...");
+      LoadConfiguredTopography(topography, file_cache);
+    });
+
+    submit([&rasp]{
+      LogString("RASP load");
+      rasp = LoadConfiguredRasp();
+    });
+
+    submit([&airspaces = *data_components->airspaces,
+                 pressure = computer_settings.pressure, &airspace_env]{
+      try {
+        ReadAirspace(airspaces, file_cache, pressure, airspace_env);
+      } catch (...) {
+        LogError(std::current_exception(), "Failed to load airspaces");
+        airspaces.Clear();
+      }
+    });
+
+    // Read the waypoint files
+    LogString("ReadWaypoints");
+    {
+      SubOperationEnvironment sub_env(operation, 0, 512);
+      sub_env.SetText(_("Loading Waypoints..."));
+      WaypointGlue::LoadWaypoints(*data_components->waypoints, file_cache,
+                                  data_components->terrain.get(),
+                                  sub_env);
+    }
 
-  // Set the home waypoint
-  WaypointGlue::SetHome(*data_components->waypoints,
-                        data_components->terrain.get(),
-                        CommonInterface::SetComputerSettings().poi,
-                        CommonInterface::SetComputerSettings().team_code,
-                        backend_components->device_blackboard.get(),
-                        false);
+    // Read and parse the airfield info file
+    try {
+      SubOperationEnvironment sub_env(operation, 512, 768);
+      sub_env.SetText(_("Loading Airfield Details File..."));
+      WaypointDetails::ReadFileFromProfile(*data_components->waypoints, sub_env);
+    } catch (...) {
+      LogError(std::current_exception());
+    }
 
-  // ReSynchronise the blackboards here since SetHome touches them
-  backend_components->device_blackboard->Merge();
-  CommonInterface::ReadBlackboardBasic(backend_components->device_blackboard->Basic());
+    // Set the home waypoint
+    WaypointGlue::SetHome(*data_components->waypoints,
+                          data_components->terrain.get(),
+                          CommonInterface::SetComputerSettings().poi,
+                          CommonInterface::SetComputerSettings().team_code,
+                          backend_components->device_blackboard.get(),
+                          false);
+
+    // ReSynchronise the blackboards here since SetHome touches them
+    backend_components->device_blackboard->Merge();
+    CommonInterface::ReadBlackboardBasic(backend_components->device_blackboard->Basic());
+
+    /* the pool destructor waits for the worker threads */
+    operation.SetText(_("Loading Airspace File..."));
+    operation.SetProgressPosition(768);
+  }
 
-  // Scan for weather forecast
-  LogString("RASP load");
-  auto rasp = LoadConfiguredRasp();
+  operation.SetProgressPosition(1024);
 
-  // Reads the airspace files
-  {
-    SubOperationEnvironment sub_env(operation, 768, 1024);
-    ReadAirspace(*data_components->airspaces,
-                 computer_settings.pressure,
-                 sub_env);
-  }
+  if (airspace_env.HasError())
+    operation.SetErrorMessage(airspace_env.GetError());
 
   if (data_components->terrain)
     SetAirspaceGroundLevels(*data_components->airspaces,
@@ -70,7 +70,7 @@ DeserialiseWaypoint(const ConstDataNode &node, const Waypoints *waypoints)
 
   const char *comment = node.GetAttribute("comment");
   if (comment != nullptr)
-    wp->comment = UTF8ToWideConverter{comment};
+    wp->comment = UTF8ToWideConverter{comment}.c_str();
 
   if (node.GetAttribute("altitude", wp->elevation))
     wp->has_elevation = true;
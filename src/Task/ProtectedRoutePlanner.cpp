@@ -4,6 +4,8 @@
 #include "ProtectedRoutePlanner.hpp"
 #include "Engine/Route/ReachResult.hpp"
 
+#include <optional>
+
 void
 ProtectedRoutePlanner::SetTerrain(const RasterTerrain *terrain) noexcept
 {
@@ -28,11 +30,17 @@ void
 ProtectedRoutePlanner::SolveRoute(const AGeoPoint &dest,
                                   const AGeoPoint &start,
                                   const RoutePlannerConfig &config,
-                                  const int h_ceiling) noexcept
+                                  const int h_ceiling,
+                                  const unsigned max_steps) noexcept
 {
   const std::scoped_lock lock{route_mutex};
-  route_planner.Synchronise(airspaces, warnings, dest, start);
-  route_planner.Solve(dest, start, config, h_ceiling);
+
+  /* don't replace the airspace copy while a suspended search is
+     still using its projection */
+  if (!route_planner.IsSolving())
+    route_planner.Synchronise(airspaces, warnings, dest, start);
+
+  route_planner.Solve(dest, start, config, h_ceiling, max_steps);
 }
 
 void
@@ -42,21 +50,32 @@ ProtectedRoutePlanner::SolveReach(const AGeoPoint &origin,
                                   const bool do_solve) noexcept
 {
   /* these local variables help avoid locking both mutexes at the same
-     time */
-  ReachFan rt, rw;
+     time; they remain empty if the previous fan can be reused */
+  std::optional<ReachFan> rt, rw;
 
   {
     const std::scoped_lock lock{route_mutex};
-    rt = route_planner.SolveReach(origin, config, h_ceiling, do_solve, false);
-    rw = route_planner.SolveReach(origin, config, h_ceiling, do_solve, true);
+
+    /* the "reach" fields are only modified by this thread, so
+       reading them without reach_mutex is safe here */
+    if (!route_planner.IsReachReusable(reach_terrain, origin, config,
+                                       h_ceiling, do_solve, false))
+      rt = route_planner.SolveReach(origin, config, h_ceiling, do_solve, false);
+
+    if (!route_planner.IsReachReusable(reach_working, origin, config,
+                                       h_ceiling, do_solve, true))
+      rw = route_planner.SolveReach(origin, config, h_ceiling, do_solve, true);
+
     rpolars_reach = route_planner.GetReachPolar();
   }
 
   /* we lock this mutex not during the expensive reach calculation,
      but only for moving the result to the mutex-protected fields */
   const std::scoped_lock lock{reach_mutex};
-  reach_terrain = std::move(rt);
-  reach_working = std::move(rw);
+  if (rt)
+    reach_terrain = std::move(*rt);
+  if (rw)
+    reach_working = std::move(*rw);
 }
 
 const FlatProjection
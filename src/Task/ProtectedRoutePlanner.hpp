@@ -70,9 +70,31 @@ public:
                  const SpeedVector &wind,
                  int height_min_working) noexcept;
 
+  /**
+   * Solve the route, or resume the search which was suspended by the
+   * previous call.  See RoutePlanner::Solve().
+   */
   void SolveRoute(const AGeoPoint &dest, const AGeoPoint &start,
                   const RoutePlannerConfig &config,
-                  int h_ceiling) noexcept;
+                  int h_ceiling, unsigned max_steps = UINT_MAX) noexcept;
+
+  /**
+   * Was the last SolveRoute() call suspended?  See
+   * RoutePlanner::IsSolving().
+   */
+  [[gnu::pure]]
+  bool IsSolvingRoute() const noexcept {
+    const std::scoped_lock lock{route_mutex};
+    return route_planner.IsSolving();
+  }
+
+  /**
+   * Abandon a suspended route search.
+   */
+  void CancelRoute() noexcept {
+    const std::scoped_lock lock{route_mutex};
+    route_planner.CancelSolve();
+  }
 
   void SolveReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
                   int h_ceiling, bool do_solve) noexcept;
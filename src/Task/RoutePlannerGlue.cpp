@@ -39,10 +39,10 @@ bool
 RoutePlannerGlue::Solve(const AGeoPoint &origin,
                         const AGeoPoint &destination,
                         const RoutePlannerConfig &config,
-                        const int h_ceiling)
+                        const int h_ceiling, const unsigned max_steps)
 {
   RasterTerrain::Lease lease(*terrain);
-  return planner.Solve(origin, destination, config, h_ceiling);
+  return planner.Solve(origin, destination, config, h_ceiling, max_steps);
 }
 
 ReachFan
@@ -59,6 +59,23 @@ RoutePlannerGlue::SolveReach(const AGeoPoint &origin,
   }
 }
 
+bool
+RoutePlannerGlue::IsReachReusable(const ReachFan &previous,
+                                  const AGeoPoint &origin,
+                                  const RoutePlannerConfig &config,
+                                  const int h_ceiling, const bool do_solve,
+                                  const bool working) const noexcept
+{
+  if (terrain) {
+    RasterTerrain::Lease lease(*terrain);
+    return planner.IsReachReusable(previous, origin, config, h_ceiling,
+                                   do_solve, working);
+  } else {
+    return planner.IsReachReusable(previous, origin, config, h_ceiling,
+                                   do_solve, working);
+  }
+}
+
 GeoPoint
 RoutePlannerGlue::Intersection(const AGeoPoint &origin,
                                const AGeoPoint &destination) const
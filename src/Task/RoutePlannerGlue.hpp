@@ -37,7 +37,15 @@ public:
 
   bool Solve(const AGeoPoint &origin, const AGeoPoint &destination,
              const RoutePlannerConfig &config,
-             int h_ceiling);
+             int h_ceiling, unsigned max_steps = UINT_MAX);
+
+  bool IsSolving() const noexcept {
+    return planner.IsSolving();
+  }
+
+  void CancelSolve() noexcept {
+    planner.CancelSolve();
+  }
 
   const Route &GetSolution() const {
     return planner.GetSolution();
@@ -47,6 +55,12 @@ public:
   ReachFan SolveReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
                       int h_ceiling, bool do_solve, bool working) noexcept;
 
+  [[gnu::pure]]
+  bool IsReachReusable(const ReachFan &previous, const AGeoPoint &origin,
+                       const RoutePlannerConfig &config,
+                       int h_ceiling, bool do_solve,
+                       bool working) const noexcept;
+
   const auto &GetReachPolar() const noexcept {
     return planner.GetReachPolar();
   }
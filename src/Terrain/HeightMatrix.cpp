@@ -3,6 +3,7 @@
 
 #include "HeightMatrix.hpp"
 #include "RasterMap.hpp"
+#include "ui/dim/Rect.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
@@ -11,6 +12,9 @@
 #endif
 
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 
 void
 HeightMatrix::SetSize(std::size_t _size) noexcept
@@ -58,6 +62,36 @@ HeightMatrix::Fill(const RasterMap &map, const GeoBounds &bounds,
   }
 }
 
+void
+HeightMatrix::FillRect(const RasterMap &map, const GeoBounds &bounds,
+                       PixelRect rect, bool interpolate) noexcept
+{
+  assert(rect.left >= 0 && rect.right <= (int)size.x);
+  assert(rect.top >= 0 && rect.bottom <= (int)size.y);
+  assert(size.x >= 2);
+
+  /* RasterMap::ScanLine() needs at least two cells; scan the
+     neighbour again if necessary */
+  if (rect.GetWidth() < 2) {
+    if (rect.right < (int)size.x)
+      ++rect.right;
+    else
+      --rect.left;
+  }
+
+  const Angle delta_x = bounds.GetWidth() / size.x;
+  const Angle delta_y = bounds.GetHeight() / size.y;
+  const Angle west = bounds.GetWest() + delta_x * rect.left;
+  const Angle east = bounds.GetWest() + delta_x * rect.right;
+
+  for (int y = rect.top; y < rect.bottom; ++y) {
+    const Angle latitude = bounds.GetNorth() - delta_y * y;
+    map.ScanLine(GeoPoint(west, latitude), GeoPoint(east, latitude),
+                 data.data() + y * size.x + rect.left, rect.GetWidth(),
+                 interpolate);
+  }
+}
+
 #else
 
 void
@@ -77,4 +111,63 @@ HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
   }
 }
 
+void
+HeightMatrix::FillRect(const RasterMap &map, const WindowProjection &projection,
+                       unsigned quantisation_pixels, PixelPoint offset,
+                       PixelRect rect, bool interpolate) noexcept
+{
+  assert(rect.left >= 0 && rect.right <= (int)size.x);
+  assert(rect.top >= 0 && rect.bottom <= (int)size.y);
+  assert(size.x >= 2);
+
+  /* RasterMap::ScanLine() needs at least two cells; scan the
+     neighbour again if necessary */
+  if (rect.GetWidth() < 2) {
+    if (rect.right < (int)size.x)
+      ++rect.right;
+    else
+      --rect.left;
+  }
+
+  /* the horizontal cell size may be fractional, see Fill() */
+  const double cell_width =
+    double(projection.GetScreenSize().width) / size.x;
+  const int left = (int)std::lround((rect.left - offset.x) * cell_width);
+  const int right = (int)std::lround((rect.right - offset.x) * cell_width);
+
+  for (int y = rect.top; y < rect.bottom; ++y) {
+    const int screen_y = (y - offset.y) * (int)quantisation_pixels;
+    map.ScanLine(projection.ScreenToGeo({left, screen_y}),
+                 projection.ScreenToGeo({right, screen_y}),
+                 data.data() + y * size.x + rect.left, rect.GetWidth(),
+                 interpolate);
+  }
+}
+
 #endif
+
+void
+HeightMatrix::Shift(int dx, int dy) noexcept
+{
+  assert(unsigned(std::abs(dx)) < size.x);
+  assert(unsigned(std::abs(dy)) < size.y);
+
+  const unsigned n = size.x - std::abs(dx);
+  const unsigned src_x = dx < 0 ? -dx : 0, dest_x = dx > 0 ? dx : 0;
+
+  const auto MoveRow = [this, n, src_x, dest_x](unsigned dest_y,
+                                                unsigned src_y){
+    auto *row = data.data();
+    std::memmove(row + dest_y * size.x + dest_x,
+                 row + src_y * size.x + src_x,
+                 n * sizeof(TerrainHeight));
+  };
+
+  if (dy > 0) {
+    for (unsigned y = size.y - 1; y >= unsigned(dy); --y)
+      MoveRow(y, y - dy);
+  } else {
+    for (unsigned y = 0; y < size.y - unsigned(-dy); ++y)
+      MoveRow(y, y - dy);
+  }
+}
@@ -8,6 +8,8 @@
 #include "util/AllocatedArray.hxx"
 
 class RasterMap;
+struct PixelPoint;
+struct PixelRect;
 
 #ifdef ENABLE_OPENGL
 class GeoBounds;
@@ -38,14 +40,40 @@ public:
    */
   void Fill(const RasterMap &map, const GeoBounds &bounds,
             UnsignedPoint2D _size, bool interpolate) noexcept;
+
+  /**
+   * Like Fill(), but update only the given rectangle of cells.  The
+   * size is not changed, and #bounds must describe the area covered
+   * by the whole buffer.
+   */
+  void FillRect(const RasterMap &map, const GeoBounds &bounds,
+                PixelRect rect, bool interpolate) noexcept;
 #else
   /**
    * @param interpolate true enables interpolation of sub-pixel values
    */
   void Fill(const RasterMap &map, const WindowProjection &map_projection,
             unsigned quantisation_pixels, bool interpolate) noexcept;
+
+  /**
+   * Like Fill(), but update only the given rectangle of cells.  The
+   * size is not changed.
+   *
+   * @param offset the position of the buffer relative to the
+   * screen of the given projection (in cells)
+   */
+  void FillRect(const RasterMap &map, const WindowProjection &map_projection,
+                unsigned quantisation_pixels, PixelPoint offset,
+                PixelRect rect, bool interpolate) noexcept;
 #endif
 
+  /**
+   * Move all values by the given number of cells.  Values which are
+   * moved out of the buffer are discarded, and the cells which become
+   * exposed are undefined; they need to be filled with FillRect().
+   */
+  void Shift(int dx, int dy) noexcept;
+
   UnsignedPoint2D GetSize() const noexcept {
     return size;
   }
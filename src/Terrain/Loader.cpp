@@ -3,10 +3,13 @@
 
 #include "Loader.hpp"
 #include "RasterTileCache.hpp"
+#include "RasterTileStore.hpp"
 #include "RasterProjection.hpp"
 #include "ZzipStream.hpp"
 #include "WorldFile.hpp"
 #include "Operation/Operation.hpp"
+#include "Operation/Cancelled.hpp"
+#include "thread/ThreadPool.hpp"
 #include "system/ConvertPathName.hpp"
 #include "util/ScopeExit.hxx"
 
@@ -18,14 +21,24 @@ extern "C" {
 
 #include <string.h>
 
+inline bool
+TerrainLoader::IsTileWanted(unsigned tile) const noexcept
+{
+  if (only_tile != unsigned(-1))
+    return tile == only_tile;
+
+  return raster_tile_cache.tiles.GetLinear(tile).IsRequested();
+}
+
 long
 TerrainLoader::SkipMarkerSegment(long file_offset) const
 {
   if (env.IsCancelled())
     return -1;
 
-  if (scan_overview)
-    /* use all segments when loading the overview */
+  if (scan_overview || store_writer != nullptr)
+    /* use all segments when loading the overview or when converting
+       all tiles */
     return 0;
 
   if (remaining_segments > 0) {
@@ -40,8 +53,7 @@ TerrainLoader::SkipMarkerSegment(long file_offset) const
     return 0;
 
   long skip_to = segment->file_offset;
-  while (segment->IsTileSegment() &&
-         !raster_tile_cache.tiles.GetLinear(segment->tile).IsRequested()) {
+  while (segment->IsTileSegment() && !IsTileWanted(segment->tile)) {
     ++segment;
     if (segment >= raster_tile_cache.segments.end())
       /* last segment is hidden; shouldn't happen either, because we
@@ -164,6 +176,9 @@ TerrainLoader::PutTileData(unsigned index,
     const std::lock_guard lock{mutex};
     raster_tile_cache.PutTileData(index, m);
   }
+
+  if (store_writer != nullptr)
+    store_writer->PutTile(index, m);
 }
 
 /**
@@ -213,7 +228,9 @@ LoadJPG2000(jas_stream_t *in, void *loader)
   /* allow really large maps, but specify a reasonable limit */
   opts.max_samples = size_t(1) << 31;
 
-  jpc_initluts();
+  /* initialise the global lookup tables only once, because this
+     function may be called by several threads at a time */
+  [[maybe_unused]] static const bool luts_initialized = (jpc_initluts(), true);
 
   const auto dec = jpc_dec_create(&opts, in);
   if (dec == nullptr)
@@ -236,6 +253,15 @@ TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path)
   ::LoadJPG2000(in, this);
 }
 
+inline void
+TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path,
+                           Mutex &zzip_mutex)
+{
+  const auto in = OpenJasperZzipStream(dir, path, zzip_mutex);
+  AtScopeExit(in) { jas_stream_close(in); };
+  ::LoadJPG2000(in, this);
+}
+
 static bool
 LoadWorldFile(RasterTileCache &tile_cache,
               struct zzip_dir *dir, const char *path)
@@ -289,9 +315,33 @@ LoadTerrainOverview(struct zzip_dir *dir,
   loader.LoadOverview(dir, path, world_file);
 }
 
+inline void
+TerrainLoader::LoadTilesParallel(struct zzip_dir *dir, const char *path,
+                                 ThreadPool &pool)
+{
+  RasterTileCache::RequestedTiles requested;
+  raster_tile_cache.GetRequestedTiles(requested);
+
+  if (requested.size() < 2) {
+    /* no point in parallelizing */
+    LoadJPG2000(dir, path);
+    return;
+  }
+
+  /* all decoders share the same zzip_dir, which is not thread-safe */
+  Mutex zzip_mutex;
+
+  pool.ForEach(requested.size(), [&](unsigned i){
+    TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
+    loader.only_tile = requested[i];
+    loader.LoadJPG2000(dir, path, zzip_mutex);
+  });
+}
+
 inline void
 TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
-                           SignedRasterLocation p, unsigned radius)
+                           SignedRasterLocation p, unsigned radius,
+                           ThreadPool *pool)
 {
   assert(!scan_overview);
 
@@ -306,31 +356,69 @@ TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
   }
 
   AtScopeExit(this) { raster_tile_cache.FinishTileUpdate(); };
+
+  if (pool != nullptr)
+    LoadTilesParallel(dir, path, *pool);
+  else
+    LoadJPG2000(dir, path);
+}
+
+inline void
+TerrainLoader::ConvertTiles(struct zzip_dir *dir, const char *path)
+{
+  assert(!scan_overview);
+  assert(store_writer != nullptr);
+
   LoadJPG2000(dir, path);
+
+  if (env.IsCancelled())
+    throw OperationCancelled{};
+
+  store_writer->Finish();
+}
+
+void
+ConvertTerrainTiles(struct zzip_dir *dir, const char *path,
+                    RasterTileCache &raster_tile_cache,
+                    BufferedOutputStream &os,
+                    OperationEnvironment &env)
+{
+  if (!raster_tile_cache.IsValid())
+    throw std::runtime_error("Terrain invalid");
+
+  RasterTileStoreWriter writer(os, raster_tile_cache.GetTileCount());
+
+  /* fake a mutex - the RasterTileCache is not modified */
+  SharedMutex mutex;
+
+  TerrainLoader loader(mutex, raster_tile_cache, false, false, env, &writer);
+  loader.ConvertTiles(dir, path);
 }
 
 void
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
-                   SignedRasterLocation p, unsigned radius)
+                   SignedRasterLocation p, unsigned radius,
+                   ThreadPool *pool)
 {
   if (!raster_tile_cache.IsValid())
     return;
 
   NullOperationEnvironment env;
   TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
-  loader.UpdateTiles(dir, path, p, radius);
+  loader.UpdateTiles(dir, path, p, radius, pool);
 }
 
 void
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
-                   const GeoPoint &location, double radius)
+                   const GeoPoint &location, double radius,
+                   ThreadPool *pool)
 {
   const auto raster_location = projection.ProjectCoarse(location);
 
   UpdateTerrainTiles(dir, path, raster_tile_cache, mutex,
                      raster_location,
-                     projection.DistancePixelsCoarse(radius));
+                     projection.DistancePixelsCoarse(radius), pool);
 }
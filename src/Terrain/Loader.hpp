@@ -5,13 +5,17 @@
 
 #include "RasterLocation.hpp"
 #include "thread/SharedMutex.hpp"
+#include "thread/Mutex.hxx"
 
 #include <cstdint>
 
 struct zzip_dir;
 struct GeoPoint;
 class RasterTileCache;
+class RasterTileStoreWriter;
 class RasterProjection;
+class BufferedOutputStream;
+class ThreadPool;
 class OperationEnvironment;
 
 class TerrainLoader {
@@ -23,6 +27,19 @@ class TerrainLoader {
 
   OperationEnvironment &env;
 
+  /**
+   * If this is set, then all tiles are decoded and passed to this
+   * object instead of the #RasterTileCache.
+   */
+  RasterTileStoreWriter *const store_writer;
+
+  /**
+   * If this is not -1, then only this tile is decoded (instead of
+   * all requested tiles).  This is used to decode several tiles in
+   * parallel, each with its own decoder.
+   */
+  unsigned only_tile = -1;
+
   /**
    * The number of remaining segments after the current one.
    */
@@ -31,11 +48,12 @@ class TerrainLoader {
 public:
   TerrainLoader(SharedMutex &_mutex, RasterTileCache &_rtc,
                 bool _scan_overview, bool _scan_all,
-                OperationEnvironment &_env)
+                OperationEnvironment &_env,
+                RasterTileStoreWriter *_store_writer=nullptr)
     :mutex(_mutex), raster_tile_cache(_rtc),
      scan_overview(_scan_overview),
-     scan_tiles(!_scan_overview || _scan_all),
-     env(_env) {}
+     scan_tiles(_store_writer == nullptr && (!_scan_overview || _scan_all)),
+     env(_env), store_writer(_store_writer) {}
 
   /**
    * Throws on error.
@@ -45,9 +63,20 @@ public:
 
   /**
    * Throws on error.
+   *
+   * @param pool if not nullptr, then tiles are decoded in parallel
+   * on this #ThreadPool
    */
   void UpdateTiles(struct zzip_dir *dir, const char *path,
-                   SignedRasterLocation p, unsigned radius);
+                   SignedRasterLocation p, unsigned radius,
+                   ThreadPool *pool=nullptr);
+
+  /**
+   * Decode all tiles and pass them to the #RasterTileStoreWriter.
+   *
+   * Throws on error.
+   */
+  void ConvertTiles(struct zzip_dir *dir, const char *path);
 
   /* callback methods for libjasper (via jas_rtc.cpp) */
 
@@ -67,11 +96,33 @@ public:
                    const struct jas_matrix &m);
 
 private:
+  [[gnu::pure]]
+  bool IsTileWanted(unsigned tile) const noexcept;
+
   /**
    * Throws on error.
    */
   void LoadJPG2000(struct zzip_dir *dir, const char *path);
 
+  /**
+   * Like LoadJPG2000(), but lock the given mutex while accessing the
+   * ZIP archive.
+   *
+   * Throws on error.
+   */
+  void LoadJPG2000(struct zzip_dir *dir, const char *path,
+                   Mutex &zzip_mutex);
+
+  /**
+   * Decode the requested tiles in parallel.  Each tile gets its own
+   * decoder, and tiles are submitted nearest first; each one is
+   * published to the #RasterTileCache as soon as it is finished.
+   *
+   * Throws on error.
+   */
+  void LoadTilesParallel(struct zzip_dir *dir, const char *path,
+                         ThreadPool &pool);
+
   void ParseBounds(const char *data);
 };
 
@@ -99,33 +150,64 @@ LoadTerrainOverview(struct zzip_dir *dir,
 }
 
 /**
+ * Decode all tiles of the JPEG2000 file and write them to a
+ * #RasterTileStore file.  The overview must have been loaded already.
+ * This is a very expensive operation which needs to be done only
+ * once per map file.
+ *
  * Throws on error.
  */
 void
+ConvertTerrainTiles(struct zzip_dir *dir, const char *path,
+                    RasterTileCache &raster_tile_cache,
+                    BufferedOutputStream &os,
+                    OperationEnvironment &env);
+
+static inline void
+ConvertTerrainTiles(struct zzip_dir *dir,
+                    RasterTileCache &tile_cache,
+                    BufferedOutputStream &os,
+                    OperationEnvironment &env)
+{
+  ConvertTerrainTiles(dir, "terrain.jp2", tile_cache, os, env);
+}
+
+/**
+ * Throws on error.
+ *
+ * @param pool if not nullptr, then tiles are decoded in parallel on
+ * this #ThreadPool
+ */
+void
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
-                   SignedRasterLocation p, unsigned radius);
+                   SignedRasterLocation p, unsigned radius,
+                   ThreadPool *pool=nullptr);
 
 static inline void
 UpdateTerrainTiles(struct zzip_dir *dir,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
-                   SignedRasterLocation p, unsigned radius)
+                   SignedRasterLocation p, unsigned radius,
+                   ThreadPool *pool=nullptr)
 {
-  UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex, p, radius);
+  UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex, p, radius,
+                     pool);
 }
 
 void
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
-                   const GeoPoint &location, double radius);
+                   const GeoPoint &location, double radius,
+                   ThreadPool *pool=nullptr);
 
 static inline void
 UpdateTerrainTiles(struct zzip_dir *dir,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
-                   const GeoPoint &location, double radius)
+                   const GeoPoint &location, double radius,
+                   ThreadPool *pool=nullptr)
 {
   UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
-                     projection, location, radius);
+                     projection, location, radius, pool);
 }
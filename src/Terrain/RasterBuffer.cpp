@@ -13,6 +13,7 @@ RasterBuffer::Resize(RasterLocation _size) noexcept
   assert(_size.x > 0);
   assert(_size.y > 0);
 
+  external = nullptr;
   data.GrowDiscard(_size.x, _size.y);
 }
 
@@ -243,7 +244,7 @@ TerrainHeight
 RasterBuffer::GetMaximum() const noexcept
 {
   return IsDefined()
-    ? *std::max_element(data.begin(), data.end(),
+    ? *std::max_element(GetData(), GetData() + GetSize().Area(),
                         [](TerrainHeight a, TerrainHeight b) {
                           return a.GetValue() < b.GetValue();
                         })
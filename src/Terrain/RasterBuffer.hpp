@@ -9,9 +9,19 @@
 #include "util/AllocatedGrid.hxx"
 #include "util/Compiler.h"
 
+#include <cassert>
+
 class RasterBuffer {
   AllocatedGrid<TerrainHeight> data;
 
+  /**
+   * If this is not nullptr, then this buffer refers to read-only
+   * memory owned by somebody else (e.g. a memory-mapped
+   * #RasterTileStore) instead of #data.
+   */
+  const TerrainHeight *external = nullptr;
+  RasterLocation external_size{0, 0};
+
 public:
   RasterBuffer() noexcept = default;
   RasterBuffer(unsigned _width, unsigned _height) noexcept
@@ -21,10 +31,13 @@ public:
   RasterBuffer &operator=(const RasterBuffer &) = delete;
 
   bool IsDefined() const noexcept {
-    return data.IsDefined();
+    return external != nullptr || data.IsDefined();
   }
 
   RasterLocation GetSize() const noexcept {
+    if (external != nullptr)
+      return external_size;
+
     return {data.GetWidth(), data.GetHeight()};
   }
 
@@ -33,19 +46,46 @@ public:
   }
 
   TerrainHeight *GetData() noexcept {
+    assert(external == nullptr);
+
     return data.begin();
   }
 
   const TerrainHeight *GetData() const noexcept {
+    if (external != nullptr)
+      return external;
+
     return data.begin();
   }
 
   const TerrainHeight *GetDataAt(RasterLocation p) const noexcept {
+    if (external != nullptr) {
+      assert(p.x < external_size.x);
+      assert(p.y < external_size.y);
+
+      return external + p.y * external_size.x + p.x;
+    }
+
     return data.GetPointerAt(p.x, p.y);
   }
 
   void Reset() noexcept {
     data.Reset();
+    external = nullptr;
+  }
+
+  /**
+   * Let this buffer refer to memory owned by the caller.  The memory
+   * must remain valid until Reset() or Resize() is called.
+   */
+  void SetExternal(const TerrainHeight *_data, RasterLocation _size) noexcept {
+    assert(_data != nullptr);
+    assert(_size.x > 0);
+    assert(_size.y > 0);
+
+    data.Reset();
+    external = _data;
+    external_size = _size;
   }
 
   void Resize(RasterLocation _size) noexcept;
@@ -6,6 +6,7 @@
 #include "Math/Util.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 
 void
@@ -35,6 +36,46 @@ RasterMap::GetInterpolatedHeight(const GeoPoint &location) const noexcept
   return raster_tile_cache.GetInterpolatedHeight(pt);
 }
 
+/**
+ * The number of locations which are projected at a time by
+ * GetHeights(); this limits the size of the buffer on the stack.
+ */
+static constexpr std::size_t HEIGHTS_CHUNK = 64;
+
+void
+RasterMap::GetHeights(std::span<const GeoPoint> locations,
+                      TerrainHeight *dest) const noexcept
+{
+  std::array<RasterLocation, HEIGHTS_CHUNK> points;
+
+  while (!locations.empty()) {
+    const std::size_t n = std::min(locations.size(), points.size());
+    for (std::size_t i = 0; i < n; ++i)
+      points[i] = projection.ProjectCoarse(locations[i]);
+
+    raster_tile_cache.GetHeights({points.data(), n}, dest);
+    locations = locations.subspan(n);
+    dest += n;
+  }
+}
+
+void
+RasterMap::GetInterpolatedHeights(std::span<const GeoPoint> locations,
+                                  TerrainHeight *dest) const noexcept
+{
+  std::array<RasterLocation, HEIGHTS_CHUNK> points;
+
+  while (!locations.empty()) {
+    const std::size_t n = std::min(locations.size(), points.size());
+    for (std::size_t i = 0; i < n; ++i)
+      points[i] = projection.ProjectFine(locations[i]);
+
+    raster_tile_cache.GetInterpolatedHeights({points.data(), n}, dest);
+    locations = locations.subspan(n);
+    dest += n;
+  }
+}
+
 void
 RasterMap::ScanLine(const GeoPoint &start, const GeoPoint &end,
                     TerrainHeight *buffer, unsigned size,
@@ -7,6 +7,8 @@
 #include "RasterTileCache.hpp"
 #include "Geo/GeoPoint.hpp"
 
+#include <span>
+
 class OperationEnvironment;
 
 class RasterMap {
@@ -95,6 +97,24 @@ public:
   [[gnu::pure]]
   TerrainHeight GetInterpolatedHeight(const GeoPoint &location) const noexcept;
 
+  /**
+   * Determine the non-interpolated heights at many locations at
+   * once.  This is cheaper than calling GetHeight() for each
+   * location; it works best if consecutive locations are close to
+   * each other.
+   *
+   * @param dest a buffer with space for locations.size() elements
+   */
+  void GetHeights(std::span<const GeoPoint> locations,
+                  TerrainHeight *dest) const noexcept;
+
+  /**
+   * Determine the interpolated heights at many locations at once.
+   * See GetHeights().
+   */
+  void GetInterpolatedHeights(std::span<const GeoPoint> locations,
+                              TerrainHeight *dest) const noexcept;
+
   /**
    * Scan a straight line and fill the buffer with the specified
    * number of samples along the line.
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "RasterPyramid.hpp"
+#include "RasterTileCache.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "util/AllocatedArray.hxx"
+#include "util/SpanCast.hxx"
+
+#include <algorithm>
+#include <stdexcept>
+
+static_assert(sizeof(TerrainHeight) == sizeof(int16_t));
+static_assert(sizeof(RasterPyramid::Level) == 12);
+static_assert(sizeof(RasterPyramid::Footer) == 16);
+
+static constexpr std::size_t
+LevelBytes(unsigned width, unsigned height) noexcept
+{
+  /* pad to a multiple of 4 bytes, to keep the following levels and
+     the table aligned */
+  return (std::size_t(width) * height * sizeof(TerrainHeight) + 3) & ~std::size_t(3);
+}
+
+/**
+ * How many levels shall be generated for a map of the given size?
+ * Levels smaller than 2x2 pixels are useless for
+ * RasterBuffer::ScanLine().
+ */
+static constexpr unsigned
+CountLevels(RasterLocation fine_size) noexcept
+{
+  unsigned n = 0;
+  while (n < RasterPyramid::MAX_LEVELS) {
+    const auto size = RasterPyramid::GetLevelSize(fine_size, n + 1);
+    if (size.x < 2 || size.y < 2)
+      break;
+
+    ++n;
+  }
+
+  return n;
+}
+
+RasterPyramid::RasterPyramid(std::unique_ptr<FileMapping> &&_mapping,
+                             RasterLocation fine_size)
+  :mapping(std::move(_mapping))
+{
+  const auto payload = FileCache::GetPayload(*mapping);
+
+  if (payload.size() < sizeof(Footer) ||
+      reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(Footer) != 0)
+    throw std::runtime_error("Malformed terrain pyramid");
+
+  const auto &footer = *reinterpret_cast<const Footer *>(payload.data() + payload.size() - sizeof(Footer));
+  if (footer.magic != Footer::MAGIC || footer.version != Footer::VERSION ||
+      footer.n_levels != CountLevels(fine_size) ||
+      footer.table_offset % alignof(Level) != 0 ||
+      footer.table_offset > payload.size() - sizeof(Footer) ||
+      footer.n_levels > (payload.size() - sizeof(Footer) - footer.table_offset) / sizeof(Level))
+    throw std::runtime_error("Malformed terrain pyramid");
+
+  const std::span<const Level> table{
+    reinterpret_cast<const Level *>(payload.data() + footer.table_offset),
+    footer.n_levels,
+  };
+
+  n_levels = table.size();
+
+  for (unsigned i = 0; i < n_levels; ++i) {
+    const auto &l = table[i];
+    const auto size = GetLevelSize(fine_size, i + 1);
+    if (l.width != size.x || l.height != size.y ||
+        l.offset % alignof(TerrainHeight) != 0 ||
+        l.offset > footer.table_offset ||
+        LevelBytes(l.width, l.height) > footer.table_offset - l.offset)
+      throw std::runtime_error("Malformed terrain pyramid");
+
+    levels[i].SetExternal(reinterpret_cast<const TerrainHeight *>(payload.data() + l.offset),
+                          size);
+  }
+}
+
+RasterPyramid::~RasterPyramid() noexcept = default;
+
+/**
+ * Accumulates 2^level rows of "fine" height values into one row of a
+ * #RasterPyramid level.
+ */
+class RasterPyramidRowBuilder {
+  const unsigned level;
+
+  AllocatedArray<int32_t> sums;
+  AllocatedArray<uint16_t> counts;
+
+  /**
+   * The "special" value to be used if there are no valid values in
+   * a block.  Water is preferred over "invalid".
+   */
+  AllocatedArray<TerrainHeight> specials;
+
+  AllocatedArray<TerrainHeight> result;
+
+public:
+  RasterPyramidRowBuilder(unsigned _level, unsigned width) noexcept
+    :level(_level),
+     sums(width), counts(width), specials(width), result(width)
+  {
+    Clear();
+  }
+
+  std::span<const TerrainHeight> GetResult() const noexcept {
+    return {result.data(), result.size()};
+  }
+
+  void Add(const TerrainHeight *src, unsigned fine_width) noexcept {
+    for (unsigned x = 0; x < fine_width; ++x) {
+      const TerrainHeight h = src[x];
+      const unsigned i = x >> level;
+
+      if (!h.IsSpecial()) [[likely]] {
+        sums[i] += h.GetValue();
+        ++counts[i];
+      } else if (h.IsWater())
+        specials[i] = h;
+    }
+  }
+
+  void Finish() noexcept {
+    for (std::size_t i = 0; i < result.size(); ++i)
+      result[i] = counts[i] > 0
+        ? TerrainHeight(sums[i] / int(counts[i]))
+        : specials[i];
+
+    Clear();
+  }
+
+private:
+  void Clear() noexcept {
+    std::fill(sums.begin(), sums.end(), 0);
+    std::fill(counts.begin(), counts.end(), 0);
+    std::fill(specials.begin(), specials.end(), TerrainHeight::Invalid());
+  }
+};
+
+void
+WriteRasterPyramid(const RasterTileCache &cache, BufferedOutputStream &os)
+{
+  if (!cache.IsValid())
+    throw std::runtime_error("Terrain invalid");
+
+  const RasterLocation fine_size = cache.GetSize();
+  const unsigned n_levels = CountLevels(fine_size);
+
+  AllocatedArray<TerrainHeight> row(fine_size.x);
+  std::array<RasterPyramid::Level, RasterPyramid::MAX_LEVELS> table;
+  uint32_t position = 0;
+
+  /* one pass over the "fine" rows per level; this needs only a few
+     rows of memory, and the levels can be written sequentially */
+  for (unsigned level = 1; level <= n_levels; ++level) {
+    const auto size = RasterPyramid::GetLevelSize(fine_size, level);
+    const std::size_t n_bytes = LevelBytes(size.x, size.y);
+    if (n_bytes > UINT32_MAX - position)
+      throw std::runtime_error("Terrain too large");
+
+    RasterPyramidRowBuilder builder(level, size.x);
+    const unsigned block_mask = (1u << level) - 1;
+
+    for (unsigned y = 0; y < fine_size.y; ++y) {
+      cache.ReadRow(y, row.data());
+      builder.Add(row.data(), fine_size.x);
+
+      if ((y & block_mask) == block_mask || y == fine_size.y - 1) {
+        builder.Finish();
+        os.Write(std::as_bytes(builder.GetResult()));
+      }
+    }
+
+    const std::size_t padding = n_bytes - std::size_t(size.x) * size.y * sizeof(TerrainHeight);
+    if (padding > 0) {
+      static constexpr std::byte zero[4]{};
+      os.Write(std::span{zero, padding});
+    }
+
+    table[level - 1] = {position, size.x, size.y};
+    position += n_bytes;
+  }
+
+  const RasterPyramid::Footer footer{
+    RasterPyramid::Footer::MAGIC,
+    RasterPyramid::Footer::VERSION,
+    n_levels,
+    position,
+  };
+
+  os.Write(std::as_bytes(std::span{table.data(), n_levels}));
+  os.Write(ReferenceAsBytes(footer));
+}
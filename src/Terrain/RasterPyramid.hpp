@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "RasterBuffer.hpp"
+#include "RasterLocation.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+class FileMapping;
+class BufferedOutputStream;
+class RasterTileCache;
+
+/**
+ * A mip-map of the terrain: several levels with decreasing
+ * resolution, each one half the width and height of the previous
+ * one.  Each pixel of level "k" is the average of (up to) 2^k x 2^k
+ * "fine" pixels, ignoring "special" values.  It is generated once
+ * from a fully mapped #RasterTileCache (see WriteRasterPyramid()) and
+ * stored in the #FileCache.
+ *
+ * When the map is zoomed out, RasterTileCache::ScanLine() reads the
+ * level which matches the sampling density instead of skipping over
+ * many "fine" pixels; this touches far fewer pages of the
+ * #RasterTileStore and avoids aliasing.
+ *
+ * File layout (after the #FileCache header): the raw data of each
+ * level (padded to a multiple of 4 bytes), followed by one #Level per
+ * level, followed by the #Footer.
+ */
+class RasterPyramid {
+public:
+  /**
+   * The maximum number of levels (not counting the "fine" tiles).
+   * The last level has 1/64 of the original resolution.
+   */
+  static constexpr unsigned MAX_LEVELS = 6;
+
+  struct Level {
+    /**
+     * The offset of the level data within the payload.
+     */
+    uint32_t offset;
+
+    uint32_t width, height;
+  };
+
+  struct Footer {
+    static constexpr uint32_t MAGIC = 0x59505258; // "XRPY"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic, version;
+
+    uint32_t n_levels;
+
+    /**
+     * The offset of the #Level array within the payload.
+     */
+    uint32_t table_offset;
+  };
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  /**
+   * Element 0 is level 1 (half resolution).
+   */
+  std::array<RasterBuffer, MAX_LEVELS> levels;
+
+  unsigned n_levels;
+
+public:
+  /**
+   * Throws on error.
+   *
+   * @param _mapping a mapping obtained from FileCache::Map()
+   * @param fine_size the size of the full-resolution map, see
+   * RasterTileCache::GetSize()
+   */
+  RasterPyramid(std::unique_ptr<FileMapping> &&_mapping,
+                RasterLocation fine_size);
+
+  ~RasterPyramid() noexcept;
+
+  RasterPyramid(const RasterPyramid &) = delete;
+  RasterPyramid &operator=(const RasterPyramid &) = delete;
+
+  /**
+   * Calculate the size of the given level.
+   */
+  static constexpr RasterLocation GetLevelSize(RasterLocation fine_size,
+                                               unsigned level) noexcept {
+    const unsigned round = (1u << level) - 1;
+    return {(fine_size.x + round) >> level, (fine_size.y + round) >> level};
+  }
+
+  unsigned GetLevelCount() const noexcept {
+    return n_levels;
+  }
+
+  /**
+   * @param level the level number (1 = half resolution)
+   */
+  const RasterBuffer &GetLevel(unsigned level) const noexcept {
+    assert(level > 0);
+    assert(level <= n_levels);
+
+    return levels[level - 1];
+  }
+
+  /**
+   * Find the coarsest level which still has at least two pixels per
+   * sample.  A finer level would not need to be touched, and a
+   * coarser level would need RasterBuffer::ScanLine() to
+   * interpolate, which is more expensive than reading the finer
+   * level.
+   *
+   * @param step the distance between two samples in "fine" pixels
+   * @return the level number or 0 if the "fine" tiles shall be used
+   */
+  [[gnu::pure]]
+  unsigned FindLevel(unsigned step) const noexcept {
+    unsigned level = 0;
+    while (level < n_levels && (4u << level) <= step)
+      ++level;
+    return level;
+  }
+};
+
+/**
+ * Generate a #RasterPyramid file from the given #RasterTileCache,
+ * which should have all tiles loaded (see
+ * RasterTileCache::AttachTileStore()).
+ *
+ * Throws on error.
+ */
+void
+WriteRasterPyramid(const RasterTileCache &cache, BufferedOutputStream &os);
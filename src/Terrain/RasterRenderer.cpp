@@ -3,6 +3,7 @@
 
 #include "Terrain/RasterRenderer.hpp"
 #include "Terrain/RasterMap.hpp"
+#include "Terrain/SlopeShading.hpp"
 #include "Math/Constants.hpp"
 #include "Screen/Layout.hpp"
 #include "ui/canvas/Ramp.hpp"
@@ -11,10 +12,14 @@
 #include "Renderer/GeoBitmapRenderer.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "ui/event/Idle.hpp"
+#include "Math/Util.hpp"
 
 #include <algorithm> // for std::clamp()
+#include <array>
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
 /**
  * Interpolate between x and y with i/128, i.e. i/(1 << 7).
@@ -85,6 +90,7 @@ RasterRenderer::~RasterRenderer() noexcept
   delete[] color_table;
   delete image;
   delete[] contour_column_base;
+  delete[] slope_row;
 }
 
 #ifdef ENABLE_OPENGL
@@ -121,8 +127,8 @@ RasterRenderer::BindAndGetTexture() const noexcept
 #endif
 
 void
-RasterRenderer::ScanMap(const RasterMap &map,
-                        const WindowProjection &projection) noexcept
+RasterRenderer::UpdatePixelSize(const RasterMap &map,
+                                const WindowProjection &projection) noexcept
 {
   // Coordinates of the MapWindow center
   const auto p = projection.GetScreenCenter();
@@ -155,6 +161,13 @@ RasterRenderer::ScanMap(const RasterMap &map,
   } else
     /* disable slope shading when zoomed out very far (too tiny) */
     quantisation_effective = 0;
+}
+
+void
+RasterRenderer::ScanMap(const RasterMap &map,
+                        const WindowProjection &projection) noexcept
+{
+  UpdatePixelSize(map, projection);
 
 #ifdef ENABLE_OPENGL
   bounds = projection.GetScreenBounds().Scale(1.5);
@@ -167,7 +180,181 @@ RasterRenderer::ScanMap(const RasterMap &map,
   last_quantisation_pixels = quantisation_pixels;
 #else
   height_matrix.Fill(map, projection, quantisation_pixels, true);
+
+  scan_projection = projection;
+  scan_offset = {0, 0};
 #endif
+
+  scrolled.reset();
+}
+
+/**
+ * Determine the cells which are exposed after the contents were moved
+ * by the given number of cells.  Some of the returned rectangles may
+ * be empty.
+ *
+ * @param padding include this number of cells next to the exposed
+ * ones
+ */
+static std::array<PixelRect, 2>
+GetExposedRects(UnsignedPoint2D size, int dx, int dy,
+                int padding=0) noexcept
+{
+  const int width = size.x, height = size.y;
+
+  PixelRect rows{0, 0, width, 0}, columns{0, 0, 0, height};
+
+  if (dy > 0) {
+    rows.bottom = std::min(dy + padding, height);
+    columns.top = rows.bottom;
+  } else if (dy < 0) {
+    rows.top = std::max(height + dy - padding, 0);
+    rows.bottom = height;
+    columns.bottom = rows.top;
+  }
+
+  if (dx > 0) {
+    columns.right = std::min(dx + padding, width);
+  } else if (dx < 0) {
+    columns.left = std::max(width + dx - padding, 0);
+    columns.right = width;
+  }
+
+  return {rows, columns};
+}
+
+static constexpr bool
+IsEmptyRect(const PixelRect &rc) noexcept
+{
+  return rc.left >= rc.right || rc.top >= rc.bottom;
+}
+
+bool
+RasterRenderer::ScrollMap(const RasterMap &map,
+                          const WindowProjection &projection) noexcept
+{
+  const auto size = height_matrix.GetSize();
+
+#ifdef ENABLE_OPENGL
+  if (!bounds.IsValid() || quantisation_pixels != last_quantisation_pixels ||
+      size != (UnsignedPoint2D)projection.GetScreenSize() / quantisation_pixels)
+    return false;
+
+  GeoBounds new_bounds = projection.GetScreenBounds().Scale(1.5);
+  if (!new_bounds.IntersectWith(map.GetBounds()))
+    return false;
+
+  const Angle delta_x = bounds.GetWidth() / size.x;
+  const Angle delta_y = bounds.GetHeight() / size.y;
+
+  /* scrolling works only if the new area has the same size (no
+     zooming and no clipping at the map border) */
+  if ((new_bounds.GetWidth() - bounds.GetWidth()).Absolute() > delta_x ||
+      (new_bounds.GetHeight() - bounds.GetHeight()).Absolute() > delta_y)
+    return false;
+
+  const int dx = iround((bounds.GetWest() - new_bounds.GetWest()) / delta_x);
+  const int dy = iround((new_bounds.GetNorth() - bounds.GetNorth()) / delta_y);
+#else
+  if (!scan_projection ||
+      projection.GetScreenSize() != scan_projection->GetScreenSize() ||
+      projection.GetScreenOrigin() != scan_projection->GetScreenOrigin() ||
+      projection.GetScale() != scan_projection->GetScale() ||
+      projection.GetScreenAngle() != scan_projection->GetScreenAngle())
+    return false;
+
+  /* where is the screen origin of the previous projection now?
+     Without zooming and rotating, this is a simple translation */
+  const auto origin =
+    projection.GeoToScreen(scan_projection->ScreenToGeo({0, 0}));
+
+  const double cell_width =
+    double(projection.GetScreenSize().width) / size.x;
+  const PixelPoint offset{
+    iround(origin.x / cell_width),
+    iround(double(origin.y) / quantisation_pixels),
+  };
+
+  /* don't drift too far from the original projection, because the
+     "translation" is only an approximation */
+  if (unsigned(std::abs(offset.x)) > size.x ||
+      unsigned(std::abs(offset.y)) > size.y)
+    return false;
+
+  const int dx = offset.x - scan_offset.x, dy = offset.y - scan_offset.y;
+#endif
+
+  if (dx == 0 && dy == 0)
+    return false;
+
+  /* if more than half of the area is new, it's cheaper to scan
+     everything */
+  if (unsigned(std::abs(dx)) * 2 > size.x ||
+      unsigned(std::abs(dy)) * 2 > size.y)
+    return false;
+
+  /* the slope shading resolution must not change, or the new parts
+     would not match the old ones */
+  const double old_pixel_size = pixel_size;
+  const unsigned old_quantisation_effective = quantisation_effective;
+  UpdatePixelSize(map, projection);
+  if (quantisation_effective != old_quantisation_effective)
+    return false;
+
+  pixel_size = old_pixel_size;
+
+#ifdef ENABLE_OPENGL
+  const Angle west = bounds.GetWest() - delta_x * dx;
+  const Angle north = bounds.GetNorth() + delta_y * dy;
+  bounds = GeoBounds(GeoPoint(west, north),
+                     GeoPoint(west + delta_x * size.x,
+                              north - delta_y * size.y));
+#else
+  scan_offset = offset;
+#endif
+
+  height_matrix.Shift(dx, dy);
+
+  for (const auto &rc : GetExposedRects(size, dx, dy)) {
+    if (IsEmptyRect(rc))
+      continue;
+
+#ifdef ENABLE_OPENGL
+    height_matrix.FillRect(map, bounds, rc, true);
+#else
+    height_matrix.FillRect(map, *scan_projection, quantisation_pixels,
+                           scan_offset, rc, true);
+#endif
+  }
+
+  scrolled = PixelPoint{dx, dy};
+  return true;
+}
+
+void
+RasterRenderer::ShiftImage(int dx, int dy) noexcept
+{
+  const auto size = height_matrix.GetSize();
+  assert(unsigned(std::abs(dx)) < size.x);
+  assert(unsigned(std::abs(dy)) < size.y);
+
+  const unsigned n = size.x - std::abs(dx);
+  const unsigned src_x = dx < 0 ? -dx : 0, dest_x = dx > 0 ? dx : 0;
+
+  const auto MoveRow = [this, n, src_x, dest_x](unsigned dest_y,
+                                                unsigned src_y){
+    std::memmove(image->GetRow(dest_y) + dest_x,
+                 image->GetRow(src_y) + src_x,
+                 n * sizeof(RawColor));
+  };
+
+  if (dy > 0) {
+    for (unsigned y = size.y - 1; y >= unsigned(dy); --y)
+      MoveRow(y, y - dy);
+  } else {
+    for (unsigned y = 0; y < size.y - unsigned(-dy); ++y)
+      MoveRow(y, y - dy);
+  }
 }
 
 void
@@ -185,6 +372,11 @@ RasterRenderer::GenerateImage(bool do_shading,
 
     delete[] contour_column_base;
     contour_column_base = new unsigned char[height_matrix.GetSize().x];
+
+    delete[] slope_row;
+    slope_row = new int8_t[height_matrix.GetSize().x];
+
+    image_parameters.reset();
   }
 
   if (quantisation_effective == 0) {
@@ -192,35 +384,70 @@ RasterRenderer::GenerateImage(bool do_shading,
     do_contour = false;
   }
 
-  const unsigned contour_height_scale = do_contour? height_scale * 2 : 16;
-
-  ContourStart(contour_height_scale);
+  const ImageParameters parameters{
+    do_shading, do_contour,
+    height_scale, contrast, brightness,
+    sunazimuth,
+  };
+
+  if (scrolled && image_parameters &&
+      image_parameters->IsCompatible(parameters)) {
+    /* the map was moved by only a few cells: move the existing image
+       and generate only the new parts, plus the border of the old
+       parts where slope and contours depend on the new cells */
+    ShiftImage(scrolled->x, scrolled->y);
+
+    for (const auto &rc : GetExposedRects(height_matrix.GetSize(),
+                                          scrolled->x, scrolled->y,
+                                          quantisation_effective + 1))
+      if (!IsEmptyRect(rc))
+        GenerateImage(rc, *image_parameters);
+  } else {
+    image_parameters = parameters;
+    GenerateImage(PixelRect{PixelSize{height_matrix.GetSize()}},
+                  parameters);
+  }
 
-  if (do_shading)
-    GenerateSlopeImage(height_scale, contrast, brightness,
-                       sunazimuth, contour_height_scale);
-  else
-    GenerateUnshadedImage(height_scale, contour_height_scale);
+  scrolled.reset();
 
   image->SetDirty();
 }
 
 void
-RasterRenderer::GenerateUnshadedImage(const unsigned height_scale,
+RasterRenderer::GenerateImage(const PixelRect &area,
+                              const ImageParameters &parameters) noexcept
+{
+  const unsigned contour_height_scale = parameters.do_contour
+    ? parameters.height_scale * 2
+    : 16;
+
+  ContourStart(area, contour_height_scale);
+
+  if (parameters.do_shading)
+    GenerateSlopeImage(area, parameters.height_scale,
+                       parameters.contrast, parameters.brightness,
+                       parameters.sunazimuth, contour_height_scale);
+  else
+    GenerateUnshadedImage(area, parameters.height_scale,
+                          contour_height_scale);
+}
+
+void
+RasterRenderer::GenerateUnshadedImage(const PixelRect &area,
+                                      const unsigned height_scale,
                                       const unsigned contour_height_scale) noexcept
 {
-  const auto *src = height_matrix.GetData();
   const RawColor *oColorBuf = color_table + 64 * 256;
-  RawColor *dest = image->GetTopRow();
 
-  for (unsigned y = height_matrix.GetSize().y; y > 0; --y) {
-    RawColor *p = dest;
-    dest = image->GetNextRow(dest);
+  for (int y = area.top; y < area.bottom; ++y) {
+    const auto *src = height_matrix.GetRow(y) + area.left;
+    RawColor *p = image->GetRow(y) + area.left;
 
-    unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    unsigned contour_row_base =
+      ContourInterval(src[area.left > 0 ? -1 : 0], contour_height_scale);
+    unsigned char *contour_this_column_base = contour_column_base + area.left;
 
-    for (unsigned x = height_matrix.GetSize().x; x > 0; --x) {
+    for (unsigned x = area.GetWidth(); x > 0; --x) {
       const auto e = *src++;
       if (!e.IsSpecial()) [[likely]] {
         unsigned h = std::max(0, (int)e.GetValue());
@@ -249,31 +476,14 @@ RasterRenderer::GenerateUnshadedImage(const unsigned height_scale,
   }
 }
 
-/**
- * Clip the difference between two adjacent terrain height values to
- * sane bounds.  This works around integer overflows in the
- * GenerateSlopeImage() formula when the map file is broken, avoiding
- * the sqrt() call with a negative argument.
- */
-static constexpr int
-ClipHeightDelta(int d) noexcept
-{
-  return std::clamp(d, -512, 512);
-}
-
-static constexpr int
-ClipHeightDelta(TerrainHeight a, TerrainHeight b) noexcept
-{
-  return ClipHeightDelta(a.GetValue() - b.GetValue());
-}
-
 // JMW: if zoomed right in (e.g. one unit is larger than terrain
 // grid), then increase the step size to be equal to the terrain
 // grid for purposes of calculating slope, to avoid shading problems
 // (gridding of display) This is why quantisation_effective is used instead of 1
 // previously.  for large zoom levels, quantisation_effective=1
 void
-RasterRenderer::GenerateSlopeImage(unsigned height_scale,
+RasterRenderer::GenerateSlopeImage(const PixelRect &area,
+                                   unsigned height_scale,
                                    int contrast,
                                    const int sx, const int sy, const int sz,
                                    const unsigned contour_height_scale) noexcept
@@ -290,67 +500,99 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
                   calculating its square will not overflow */
                8192u / (quantisation_effective * quantisation_effective));
   
-  const auto *src = height_matrix.GetData();
-  const RawColor *oColorBuf = color_table + 64 * 256;
+  const unsigned width = height_matrix.GetSize().x;
+
+  /* the range of columns which have the full distance to their left
+     and right neighbours; these can be calculated in one batch */
+  const unsigned inner_left = std::min(unsigned(border.left), width);
+  const unsigned inner_right = std::max(border.right, int(inner_left));
+  const unsigned batch_begin = std::max(unsigned(area.left), inner_left);
+  const unsigned batch_end = std::min(unsigned(area.right), inner_right);
+
+  SlopeShadingParameters parameters;
+  parameters.sx = sx;
+  parameters.sy = sy;
+  parameters.sz = sz;
+  parameters.contrast = contrast;
+  parameters.height_slope_factor = height_slope_factor;
 
-  RawColor *dest = image->GetTopRow();
+  const RawColor *oColorBuf = color_table + 64 * 256;
 
-  for (unsigned y = 0; y < height_matrix.GetSize().y; ++y) {
+  for (unsigned y = area.top; y < unsigned(area.bottom); ++y) {
     const unsigned row_plus_index = y < (unsigned)border.bottom
       ? quantisation_effective
       : height_matrix.GetSize().y - 1 - y;
-    const unsigned row_plus_offset = height_matrix.GetSize().x * row_plus_index;
+    const unsigned row_plus_offset = width * row_plus_index;
 
     const unsigned row_minus_index = y >= quantisation_effective
       ? quantisation_effective : y;
-    const unsigned row_minus_offset = height_matrix.GetSize().x * row_minus_index;
+    const unsigned row_minus_offset = width * row_minus_index;
 
-    const unsigned p31 = row_plus_index + row_minus_index;
+    const auto *src = height_matrix.GetRow(y);
 
-    RawColor *p = dest;
-    dest = image->GetNextRow(dest);
+    assert(src - row_minus_offset >= height_matrix.GetData());
+    assert(src + row_plus_offset + width <= height_matrix.GetDataEnd());
 
-    unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    parameters.p31 = row_plus_index + row_minus_index;
 
-    for (unsigned x = 0; x < height_matrix.GetSize().x; ++x, ++src) {
-      const auto e = *src;
-      if (!e.IsSpecial()) [[likely]] {
-        unsigned h = std::max(0, (int)e.GetValue());
+    /* first pass: calculate the illumination of the whole row */
 
-        const unsigned contour_interval =
-          ContourInterval(h, contour_height_scale);
+    const auto *above = src - row_minus_offset;
+    const auto *below = src + row_plus_offset;
 
-        h = std::min(254u, h >> height_scale);
+    for (unsigned x = area.left; x < unsigned(area.right); ++x) {
+      if (x == batch_begin && batch_begin < batch_end) {
+        /* the inner columns: vectorised */
+        CalculateSlopeShading(slope_row + x,
+                              above + x, below + x,
+                              src + x - quantisation_effective,
+                              src + x + quantisation_effective,
+                              batch_end - x,
+                              2 * quantisation_effective, parameters);
+        x = batch_end;
+        if (x >= unsigned(area.right))
+          break;
+      }
 
-        // no need to calculate slope if undefined height or sea level
+      // X direction
 
-        // Y direction
-        assert(src - row_minus_offset >= height_matrix.GetData());
-        assert(src + row_plus_offset >= height_matrix.GetData());
-        assert(src - row_minus_offset < height_matrix.GetDataEnd());
-        assert(src + row_plus_offset < height_matrix.GetDataEnd());
+      const unsigned column_plus_index = x < (unsigned)border.right
+        ? quantisation_effective
+        : width - 1 - x;
+      const unsigned column_minus_index = x >= (unsigned)border.left
+        ? quantisation_effective : x;
 
-        // X direction
+      assert(column_minus_index <= x);
+      assert(x + column_plus_index < width);
 
-        const unsigned column_plus_index = x < (unsigned)border.right
-          ? quantisation_effective
-          : height_matrix.GetSize().x - 1 - x;
-        const unsigned column_minus_index = x >= (unsigned)border.left
-          ? quantisation_effective : x;
+      slope_row[x] = CalculateSlopeShading(above[x], below[x],
+                                           src[x - column_minus_index],
+                                           src[x + column_plus_index],
+                                           column_plus_index + column_minus_index,
+                                           parameters);
+    }
+
+    /* second pass: contour lines and color lookup */
+
+    RawColor *p = image->GetRow(y) + area.left;
+
+    src += area.left;
+    unsigned contour_row_base =
+      ContourInterval(src[area.left > 0 ? -1 : 0], contour_height_scale);
+    unsigned char *contour_this_column_base = contour_column_base + area.left;
+    const int8_t *slope = slope_row + area.left;
+
+    for (unsigned x = area.GetWidth(); x > 0; --x, ++src, ++slope) {
+      const auto e = *src;
+      if (!e.IsSpecial()) [[likely]] {
+        unsigned h = std::max(0, (int)e.GetValue());
 
-        assert(src - column_minus_index >= height_matrix.GetData());
-        assert(src + column_plus_index >= height_matrix.GetData());
-        assert(src - column_minus_index < height_matrix.GetDataEnd());
-        assert(src + column_plus_index < height_matrix.GetDataEnd());
+        const unsigned contour_interval =
+          ContourInterval(h, contour_height_scale);
 
-        const auto h_above = src[-(int)row_minus_offset];
-        const auto h_below = src[row_plus_offset];
-        const auto h_left = src[-(int)column_minus_index];
-        const auto h_right = src[column_plus_index];
+        h = std::min(254u, h >> height_scale);
 
-        if (h_above.IsSpecial() || h_below.IsSpecial() ||
-            h_left.IsSpecial() || h_right.IsSpecial()) [[unlikely]] {
+        if (*slope == NO_SLOPE_SHADING) [[unlikely]] {
           /* some "special" terrain value surrounding us (water or
              invalid), skip slope calculation */
           *p++ = oColorBuf[h];
@@ -366,25 +608,7 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
           continue;
         }
 
-        const int p32 = ClipHeightDelta(h_above, h_below);
-        const int p22 = ClipHeightDelta(h_right, h_left);
-
-        const unsigned p20 = column_plus_index + column_minus_index;
-
-        const int dd0 = p22 * int(p31);
-        const int dd1 = int(p20) * p32;
-        const unsigned dd2 = p20 * p31 * height_slope_factor;
-        const int num = (int(dd2) * sz + dd0 * sx + dd1 * sy);
-        const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
-        const unsigned mag = (unsigned)sqrt(square_mag);
-        /* this is a workaround for a SIGFPE (division by zero)
-           observed by our users on some Android devices (e.g. Nexus
-           7), even though we did our best to make sure that the
-           integer arithmetics above can't overflow */
-        /* TODO: debug this problem and replace this workaround */
-        const int sval = num / int(mag|1);
-        const int sindex = (sval - sz) * contrast / 128;
-        *p++ = oColorBuf[int(h) + 256 * std::clamp(sindex, -63, 63)];
+        *p++ = oColorBuf[int(h) + 256 * *slope];
       } else if (e.IsWater()) {
         // we're in the water, so look up the color for water
         *p++ = oColorBuf[255];
@@ -399,7 +623,8 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 }
 
 void
-RasterRenderer::GenerateSlopeImage(unsigned height_scale,
+RasterRenderer::GenerateSlopeImage(const PixelRect &area,
+                                   unsigned height_scale,
                                    int contrast, int brightness,
                                    const Angle sunazimuth,
                                    const unsigned contour_height_scale) noexcept
@@ -411,7 +636,7 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
   const int sy = (int)(255 * fudgeelevation.fastcosine() * -sunazimuth.fastcosine());
   const int sz = (int)(255 * fudgeelevation.fastsine());
 
-  GenerateSlopeImage(height_scale, contrast,
+  GenerateSlopeImage(area, height_scale, contrast,
                      sx, sy, sz, contour_height_scale);
 }
 
@@ -422,6 +647,8 @@ RasterRenderer::PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
   if (color_table == nullptr)
     color_table = new RawColor[256 * 128];
 
+  image_parameters.reset();
+
   for (int i = 0; i < 256; i++) {
     for (int mag = -64; mag < 64; mag++) {
       RawColor color;
@@ -450,12 +677,15 @@ RasterRenderer::PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
 }
 
 void
-RasterRenderer::ContourStart(const unsigned contour_height_scale) noexcept
+RasterRenderer::ContourStart(const PixelRect &area,
+                             const unsigned contour_height_scale) noexcept
 {
-  // initialise column to first row
-  const auto *src = height_matrix.GetData();
-  unsigned char *col_base = contour_column_base;
-  for (unsigned x = height_matrix.GetSize().x; x > 0; --x)
+  /* initialise column to the row above the area (or to the first
+     row) */
+  const auto *src = height_matrix.GetRow(area.top > 0 ? area.top - 1 : 0)
+    + area.left;
+  unsigned char *col_base = contour_column_base + area.left;
+  for (unsigned x = area.GetWidth(); x > 0; --x)
     *col_base++ = ContourInterval(*src++, contour_height_scale);
 }
 
@@ -4,19 +4,26 @@
 #pragma once
 
 #include "Terrain/HeightMatrix.hpp"
+#include "Math/Angle.hpp"
+#include "ui/dim/Point.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
+#else
+#include "Projection/WindowProjection.hpp"
 #endif
 
+#include <cstdint>
+#include <optional>
+
 static constexpr unsigned NUM_COLOR_RAMP_LEVELS = 13;
 
-class Angle;
 class Canvas;
 class RasterMap;
 class WindowProjection;
 class RawBitmap;
 struct RawColor;
+struct PixelRect;
 struct ColorRamp;
 
 #ifdef ENABLE_OPENGL
@@ -48,13 +55,65 @@ class RasterRenderer {
    * texture has to be redrawn.
    */
   GeoBounds bounds = GeoBounds::Invalid();
+#else
+  /**
+   * The projection which was used by the last ScanMap() call.
+   * ScrollMap() scans new cells relative to it, so they are aligned
+   * with the existing ones.
+   */
+  std::optional<WindowProjection> scan_projection;
+
+  /**
+   * The position of the #HeightMatrix relative to the screen of
+   * #scan_projection (in cells).
+   */
+  PixelPoint scan_offset;
 #endif
 
+  /**
+   * The number of cells the #height_matrix was moved by the last
+   * ScrollMap() call, or std::nullopt if it was filled completely
+   * by ScanMap().
+   */
+  std::optional<PixelPoint> scrolled;
+
+  struct ImageParameters {
+    bool do_shading, do_contour;
+    unsigned height_scale;
+    int contrast, brightness;
+    Angle sunazimuth;
+
+    /**
+     * Can an image generated with these parameters be reused for the
+     * other ones?
+     */
+    [[gnu::pure]]
+    bool IsCompatible(const ImageParameters &other) const noexcept {
+      return do_shading == other.do_shading &&
+        do_contour == other.do_contour &&
+        height_scale == other.height_scale &&
+        contrast == other.contrast && brightness == other.brightness &&
+        sunazimuth.CompareRoughly(other.sunazimuth);
+    }
+  };
+
+  /**
+   * The parameters of the current #image.  This is std::nullopt if
+   * the #image needs to be regenerated completely.
+   */
+  std::optional<ImageParameters> image_parameters;
+
   HeightMatrix height_matrix;
   RawBitmap *image = nullptr;
 
   unsigned char *contour_column_base = nullptr;
 
+  /**
+   * The illumination of the current row, calculated by
+   * GenerateSlopeImage() before the colors are looked up.
+   */
+  int8_t *slope_row = nullptr;
+
   double pixel_size;
 
   RawColor *color_table = nullptr;
@@ -74,11 +133,20 @@ public:
     return height_matrix.GetSize();
   }
 
-#ifdef ENABLE_OPENGL
+  /**
+   * Discard the previous scan, i.e. the next frame must be generated
+   * with ScanMap() and from scratch.
+   */
   void Invalidate() noexcept {
+#ifdef ENABLE_OPENGL
     bounds.SetInvalid();
+#else
+    scan_projection.reset();
+#endif
+    image_parameters.reset();
   }
 
+#ifdef ENABLE_OPENGL
   /**
    * Calculate a new #quantisation_pixels value.
    *
@@ -108,6 +176,19 @@ public:
   void ScanMap(const RasterMap &map,
                const WindowProjection &projection) noexcept;
 
+  /**
+   * Update the height matrix incrementally after the map was moved
+   * by a small distance (without zooming or rotating): move the
+   * existing values and scan only the cells which have become
+   * visible.  The following GenerateImage() call will then
+   * regenerate only those parts of the image.
+   *
+   * @return false if that is not possible; ScanMap() needs to be
+   * called instead
+   */
+  bool ScrollMap(const RasterMap &map,
+                 const WindowProjection &projection) noexcept;
+
   /**
    * Convert the height matrix into the image.
    */
@@ -124,27 +205,49 @@ public:
             bool transparent_white=false) const noexcept;
 
 protected:
+  /**
+   * Convert the given area of the height matrix into the image.
+   */
+  void GenerateImage(const PixelRect &area,
+                     const ImageParameters &parameters) noexcept;
+
   /**
    * Convert the height matrix into the image, without shading.
    */
-  void GenerateUnshadedImage(unsigned height_scale,
+  void GenerateUnshadedImage(const PixelRect &area,
+                             unsigned height_scale,
                              unsigned contour_height_scale) noexcept;
 
   /**
    * Convert the height matrix into the image, with slope shading.
    */
-  void GenerateSlopeImage(unsigned height_scale, int contrast,
+  void GenerateSlopeImage(const PixelRect &area,
+                          unsigned height_scale, int contrast,
                           int sx, int sy, int sz,
                           unsigned contour_height_scale) noexcept;
 
   /**
    * Convert the height matrix into the image, with slope shading.
    */
-  void GenerateSlopeImage(unsigned height_scale,
+  void GenerateSlopeImage(const PixelRect &area,
+                          unsigned height_scale,
                           int contrast, int brightness,
                           Angle sunazimuth,
                           unsigned contour_height_scale) noexcept;
 
 private:
-  void ContourStart(unsigned contour_height_scale) noexcept;
+  /**
+   * Calculate #pixel_size and #quantisation_effective.
+   */
+  void UpdatePixelSize(const RasterMap &map,
+                       const WindowProjection &projection) noexcept;
+
+  /**
+   * Move the image contents along with the #height_matrix (see
+   * HeightMatrix::Shift()).
+   */
+  void ShiftImage(int dx, int dy) noexcept;
+
+  void ContourStart(const PixelRect &area,
+                    unsigned contour_height_scale) noexcept;
 };
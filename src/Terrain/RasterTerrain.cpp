@@ -3,19 +3,34 @@
 
 #include "RasterTerrain.hpp"
 #include "Loader.hpp"
+#include "RasterTileStore.hpp"
+#include "RasterPyramid.hpp"
 #include "Profile/Profile.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
 #include "io/FileOutputStream.hxx"
 #include "io/BufferedOutputStream.hxx"
 #include "io/Reader.hxx"
 #include "io/BufferedReader.hxx"
 #include "system/ConvertPathName.hpp"
 #include "Operation/Operation.hpp"
+#include "Operation/Cancelled.hpp"
+#include "thread/ThreadPool.hpp"
 #include "util/ConvertString.hpp"
 #include "LogFile.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 static const TCHAR *const terrain_cache_name = _T("terrain");
+static const TCHAR *const terrain_tiles_cache_name = _T("terrain-tiles");
+static const TCHAR *const terrain_pyramid_cache_name = _T("terrain-pyramid");
+
+RasterTerrain::RasterTerrain(ZipArchive &&_archive) noexcept
+  :Guard<RasterMap>(map), archive(std::move(_archive)) {}
+
+RasterTerrain::~RasterTerrain() noexcept = default;
 
 inline bool
 RasterTerrain::LoadCache(FileCache &cache, Path path)
@@ -45,13 +60,123 @@ RasterTerrain::SaveCache(FileCache &cache, Path path) const
   os->Commit();
 }
 
+inline bool
+RasterTerrain::OpenTileStore(FileCache &cache, Path path)
+{
+  auto mapping = cache.Map(terrain_tiles_cache_name, path);
+  if (!mapping)
+    return false;
+
+  auto store = std::make_unique<RasterTileStore>(std::move(mapping));
+  if (!map.GetTileCache().AttachTileStore(*store))
+    return false;
+
+  tile_store = std::move(store);
+  return true;
+}
+
+inline void
+RasterTerrain::SaveTileStore(FileCache &cache, Path path,
+                             OperationEnvironment &operation)
+{
+  auto os = cache.Save(terrain_tiles_cache_name, path);
+  BufferedOutputStream bos(*os);
+  ConvertTerrainTiles(archive.get(), map.GetTileCache(), bos, operation);
+  bos.Flush();
+  os->Commit();
+}
+
+inline bool
+RasterTerrain::OpenPyramid(FileCache &cache, Path path)
+{
+  auto mapping = cache.Map(terrain_pyramid_cache_name, path);
+  if (!mapping)
+    return false;
+
+  auto p = std::make_unique<RasterPyramid>(std::move(mapping),
+                                           map.GetTileCache().GetSize());
+  if (!map.GetTileCache().AttachPyramid(*p))
+    return false;
+
+  pyramid = std::move(p);
+  return true;
+}
+
+inline void
+RasterTerrain::SavePyramid(FileCache &cache, Path path)
+{
+  auto os = cache.Save(terrain_pyramid_cache_name, path);
+  BufferedOutputStream bos(*os);
+  WriteRasterPyramid(map.GetTileCache(), bos);
+  bos.Flush();
+  os->Commit();
+}
+
+inline void
+RasterTerrain::LoadPyramid(FileCache &cache, Path path) noexcept
+{
+  assert(tile_store);
+
+  try {
+    if (OpenPyramid(cache, path))
+      return;
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to open terrain pyramid");
+  }
+
+  try {
+    SavePyramid(cache, path);
+    if (!OpenPyramid(cache, path))
+      LogString("Terrain pyramid does not match");
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save terrain pyramid");
+    cache.Flush(terrain_pyramid_cache_name);
+  }
+}
+
+inline void
+RasterTerrain::LoadTileStore(FileCache &cache, Path path,
+                             OperationEnvironment &operation) noexcept
+{
+  try {
+    if (OpenTileStore(cache, path)) {
+      LoadPyramid(cache, path);
+      return;
+    }
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to open terrain tile store");
+  }
+
+  /* convert the JPEG2000 file once; this is expensive, but all
+     following runs can use the file without decoding anything */
+
+  try {
+    SaveTileStore(cache, path, operation);
+    if (!OpenTileStore(cache, path)) {
+      LogString("Terrain tile store does not match");
+      return;
+    }
+  } catch (OperationCancelled) {
+    cache.Flush(terrain_tiles_cache_name);
+    return;
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save terrain tile store");
+    cache.Flush(terrain_tiles_cache_name);
+    return;
+  }
+
+  LoadPyramid(cache, path);
+}
+
 inline void
 RasterTerrain::Load(Path path, FileCache *cache,
                     OperationEnvironment &operation)
 {
   try {
-    if (LoadCache(cache, path))
+    if (LoadCache(cache, path)) {
+      LoadTileStore(*cache, path, operation);
       return;
+    }
   } catch (...) {
     LogError(std::current_exception(), "Failed to load terrain cache");
   }
@@ -66,6 +191,8 @@ RasterTerrain::Load(Path path, FileCache *cache,
     } catch (...) {
       LogError(std::current_exception(), "Failed to save terrain cache");
     }
+
+    LoadTileStore(*cache, path, operation);
   }
 }
 
@@ -91,16 +218,43 @@ try {
   return nullptr;
 }
 
+inline ThreadPool *
+RasterTerrain::GetDecoderPool() noexcept
+{
+  if (decoder_pool_initialized)
+    return decoder_pool.get();
+
+  decoder_pool_initialized = true;
+
+  /* the calling thread decodes, too, so one core less; more than 4
+     decoders don't help much, because at most
+     RasterTileCache::MAX_ACTIVATE tiles are loaded at a time */
+  const unsigned n_threads =
+    std::min(ThreadPool::GetProcessorCount(), 4u) - 1;
+  if (n_threads == 0)
+    return nullptr;
+
+  try {
+    decoder_pool = std::make_unique<ThreadPool>("TerrainDecoder",
+                                                n_threads, true);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to start terrain decoder threads");
+  }
+
+  return decoder_pool.get();
+}
+
 bool
 RasterTerrain::UpdateTiles(const GeoPoint &location, double radius) noexcept
 {
   auto &tile_cache = map.GetTileCache();
-  if (!tile_cache.IsValid())
+  if (!tile_cache.IsValid() || tile_cache.IsMapped())
     return false;
 
   try {
     UpdateTerrainTiles(archive.get(), tile_cache, mutex,
-                       map.GetProjection(), location, radius);
+                       map.GetProjection(), location, radius,
+                       GetDecoderPool());
   } catch (...) {
     LogError(std::current_exception(), "Failed to update terrain tiles");
   }
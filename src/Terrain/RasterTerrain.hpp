@@ -12,6 +12,9 @@
 
 class Path;
 class FileCache;
+class RasterTileStore;
+class RasterPyramid;
+class ThreadPool;
 class OperationEnvironment;
 
 /**
@@ -29,12 +32,38 @@ private:
 
   RasterMap map;
 
+  /**
+   * The pre-decoded tiles of this terrain file, see
+   * RasterTileCache::AttachTileStore().  If this is set, then the
+   * JPEG2000 decoder is not used for tiles.
+   */
+  std::unique_ptr<RasterTileStore> tile_store;
+
+  /**
+   * Lower resolution levels for zoomed out views, see
+   * RasterTileCache::AttachPyramid().  This is only available if
+   * #tile_store is set, because generating it requires all tiles.
+   */
+  std::unique_ptr<RasterPyramid> pyramid;
+
+  /**
+   * Worker threads for decoding tiles in parallel.  Created on
+   * demand by UpdateTiles() on multi-core machines.
+   */
+  std::unique_ptr<ThreadPool> decoder_pool;
+
+  /**
+   * Was the creation of #decoder_pool attempted already?
+   */
+  bool decoder_pool_initialized = false;
+
 public:
   /**
    * Constructor.  Returns uninitialised object.
    */
-  explicit RasterTerrain(ZipArchive &&_archive) noexcept
-    :Guard<RasterMap>(map), archive(std::move(_archive)) {}
+  explicit RasterTerrain(ZipArchive &&_archive) noexcept;
+
+  ~RasterTerrain() noexcept;
 
   const Serial &GetSerial() const noexcept {
     return map.GetSerial();
@@ -84,6 +113,46 @@ private:
    */
   void SaveCache(FileCache &cache, Path path) const;
 
+  ThreadPool *GetDecoderPool() noexcept;
+
+  /**
+   * Throws on error.
+   */
+  bool OpenTileStore(FileCache &cache, Path path);
+
+  /**
+   * Convert all tiles to a #RasterTileStore file.
+   *
+   * Throws on error.
+   */
+  void SaveTileStore(FileCache &cache, Path path,
+                     OperationEnvironment &operation);
+
+  /**
+   * Attach the #RasterTileStore, converting the JPEG2000 file if
+   * necessary.  Errors are logged.
+   */
+  void LoadTileStore(FileCache &cache, Path path,
+                     OperationEnvironment &operation) noexcept;
+
+  /**
+   * Throws on error.
+   */
+  bool OpenPyramid(FileCache &cache, Path path);
+
+  /**
+   * Generate a #RasterPyramid file from the mapped tiles.
+   *
+   * Throws on error.
+   */
+  void SavePyramid(FileCache &cache, Path path);
+
+  /**
+   * Attach the #RasterPyramid, generating it if necessary.  Errors
+   * are logged.
+   */
+  void LoadPyramid(FileCache &cache, Path path) noexcept;
+
   /**
    * Throws on error.
    */
@@ -2,6 +2,8 @@
 // Copyright The XCSoar Project
 
 #include "RasterTileCache.hpp"
+#include "RasterTileStore.hpp"
+#include "RasterPyramid.hpp"
 #include "Math/Angle.hpp"
 #include "io/BufferedOutputStream.hxx"
 #include "io/BufferedReader.hxx"
@@ -82,23 +84,89 @@ struct RTDistanceSort {
   }
 };
 
+bool
+RasterTileCache::AttachTileStore(const RasterTileStore &store) noexcept
+{
+  if (store.GetTileCount() != tiles.GetSize())
+    return false;
+
+  /* verify that all tiles are available before modifying anything */
+  for (unsigned i = 0; i < tiles.GetSize(); ++i) {
+    const auto &tile = tiles.GetLinear(i);
+    if (tile.IsDefined() && store.GetTile(i, tile.size) == nullptr)
+      return false;
+  }
+
+  for (unsigned i = 0; i < tiles.GetSize(); ++i) {
+    auto &tile = tiles.GetLinear(i);
+    if (tile.IsDefined())
+      tile.buffer.SetExternal(store.GetTile(i, tile.size), tile.size);
+  }
+
+  mapped = true;
+  dirty = false;
+  ++serial;
+  return true;
+}
+
+bool
+RasterTileCache::AttachPyramid(const RasterPyramid &_pyramid) noexcept
+{
+  if (_pyramid.GetLevelCount() == 0 ||
+      _pyramid.GetLevel(1).GetSize() != RasterPyramid::GetLevelSize(size, 1))
+    return false;
+
+  pyramid = &_pyramid;
+  ++serial;
+  return true;
+}
+
+void
+RasterTileCache::ReadRow(unsigned y, TerrainHeight *dest) const noexcept
+{
+  assert(y < size.y);
+
+  const unsigned tile_y = y / tile_size.y;
+  const RasterLocation overview_size = overview.GetSize();
+
+  for (unsigned x = 0; x < size.x;) {
+    const RasterTile &tile = tiles.Get(x / tile_size.x, tile_y);
+    const unsigned tile_end = std::min((x / tile_size.x + 1) * tile_size.x,
+                                       size.x);
+
+    if (tile.IsLoaded() && tile.start.x == x && tile.end.x == tile_end) {
+      dest = std::copy_n(tile.buffer.GetDataAt({0, y - tile.start.y}),
+                         tile.size.x, dest);
+    } else {
+      const unsigned overview_y =
+        std::min(y >> RasterTraits::OVERVIEW_BITS, overview_size.y - 1);
+      for (unsigned i = x; i < tile_end; ++i)
+        *dest++ = overview.Get({
+            std::min(i >> RasterTraits::OVERVIEW_BITS, overview_size.x - 1),
+            overview_y,
+          });
+    }
+
+    x = tile_end;
+  }
+}
+
 bool
 RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
 {
+  if (mapped) {
+    /* all tiles are permanently available; the kernel decides which
+       pages of the RasterTileStore stay in memory */
+    dirty = false;
+    return false;
+  }
+
   /* tiles are usually 256 pixels wide; with a radius smaller than
      that, the (optimized) tile distance calculations may fail;
      additionally, this ensures that tiles which are slightly out of
      the screen will be loaded in advance */
   radius += 256;
 
-  /**
-   * Maximum number of tiles loaded at a time, to reduce system load
-   * peaks.
-   */
-  constexpr unsigned MAX_ACTIVATE = MAX_ACTIVE_TILES > 32
-    ? 16
-    : MAX_ACTIVE_TILES / 2;
-
   /* query all tiles; all tiles which are either in range or already
      loaded are added to RequestTiles */
 
@@ -107,13 +175,14 @@ RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
     if (tiles.GetLinear(i).VisibilityChanged(p, radius))
       request_tiles.append(i);
 
+  /* sort by distance; this determines which tiles get disposed and
+     the order in which new tiles get loaded */
+  const RTDistanceSort sort(*this);
+  std::sort(request_tiles.begin(), request_tiles.end(), sort);
+
   /* reduce if there are too many */
 
   if (request_tiles.size() > MAX_ACTIVE_TILES) {
-    /* sort by distance */
-    const RTDistanceSort sort(*this);
-    std::sort(request_tiles.begin(), request_tiles.end(), sort);
-
     /* dispose all tiles which are out of range */
     for (unsigned i = MAX_ACTIVE_TILES; i < request_tiles.size(); ++i) {
       RasterTile &tile = tiles.GetLinear(request_tiles[i]);
@@ -144,6 +213,21 @@ RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
   return num_activate > 0;
 }
 
+void
+RasterTileCache::GetRequestedTiles(RequestedTiles &dest) const noexcept
+{
+  dest.clear();
+
+  /* request_tiles is sorted by distance already */
+  for (const auto i : request_tiles) {
+    if (dest.full())
+      break;
+
+    if (tiles.GetLinear(i).IsRequested())
+      dest.append(i);
+  }
+}
+
 TerrainHeight
 RasterTileCache::GetHeight(RasterLocation p) const noexcept
 {
@@ -177,6 +261,82 @@ RasterTileCache::GetInterpolatedHeight(RasterLocation l) const noexcept
   return overview.GetInterpolated({RasterTraits::ToOverview(l.x), RasterTraits::ToOverview(l.y)});
 }
 
+/**
+ * Remembers the #RasterTile of the previous lookup, to skip the tile
+ * lookup for consecutive points on the same tile.
+ */
+class TileCursor {
+  const AllocatedGrid<RasterTile> &tiles;
+  const Point2D<uint_least16_t> tile_size;
+
+  const RasterTile *tile = nullptr;
+
+  /**
+   * The pixel range covered by #tile.
+   */
+  RasterLocation start{0, 0}, end{0, 0};
+
+public:
+  TileCursor(const AllocatedGrid<RasterTile> &_tiles,
+             Point2D<uint_least16_t> _tile_size) noexcept
+    :tiles(_tiles), tile_size(_tile_size) {}
+
+  /**
+   * @param p a pixel position inside the map
+   */
+  const RasterTile &Get(RasterLocation p) noexcept {
+    if (p.x < start.x || p.x >= end.x || p.y < start.y || p.y >= end.y) [[unlikely]] {
+      const unsigned tile_x = p.x / tile_size.x, tile_y = p.y / tile_size.y;
+      tile = &tiles.Get(tile_x, tile_y);
+      start = {tile_x * tile_size.x, tile_y * tile_size.y};
+      end = {start.x + tile_size.x, start.y + tile_size.y};
+    }
+
+    return *tile;
+  }
+};
+
+void
+RasterTileCache::GetHeights(std::span<const RasterLocation> points,
+                            TerrainHeight *dest) const noexcept
+{
+  TileCursor cursor(tiles, tile_size);
+
+  for (const RasterLocation p : points) {
+    if (p.x >= size.x || p.y >= size.y) {
+      *dest++ = TerrainHeight::Invalid();
+      continue;
+    }
+
+    const RasterTile &tile = cursor.Get(p);
+    *dest++ = tile.IsLoaded()
+      ? tile.GetHeight(p)
+      : overview.GetInterpolated(p << (RasterTraits::SUBPIXEL_BITS - RasterTraits::OVERVIEW_BITS));
+  }
+}
+
+void
+RasterTileCache::GetInterpolatedHeights(std::span<const RasterLocation> points,
+                                        TerrainHeight *dest) const noexcept
+{
+  TileCursor cursor(tiles, tile_size);
+
+  for (const RasterLocation l : points) {
+    if (l.x >= overview_size_fine.x || l.y >= overview_size_fine.y) {
+      *dest++ = TerrainHeight::Invalid();
+      continue;
+    }
+
+    const auto [px, ix] = RasterTraits::CalcSubpixel(l.x);
+    const auto [py, iy] = RasterTraits::CalcSubpixel(l.y);
+
+    const RasterTile &tile = cursor.Get({px, py});
+    *dest++ = tile.IsLoaded()
+      ? tile.GetInterpolatedHeight(px, py, ix, iy)
+      : overview.GetInterpolated({RasterTraits::ToOverview(l.x), RasterTraits::ToOverview(l.y)});
+  }
+}
+
 void
 RasterTileCache::SetSize(UnsignedPoint2D _size,
                          Point2D<uint_least16_t> _tile_size,
@@ -214,6 +374,8 @@ RasterTileCache::Reset() noexcept
   size = {0, 0};
   bounds.SetInvalid();
   segments.clear();
+  mapped = false;
+  pyramid = nullptr;
 
   overview.Reset();
 
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstdint>
 #include <optional>
+#include <span>
 
 static constexpr unsigned  RASTER_SLOPE_FACT = 12;
 
@@ -20,6 +21,8 @@ struct jas_matrix;
 struct GridLocation;
 class BufferedOutputStream;
 class BufferedReader;
+class RasterTileStore;
+class RasterPyramid;
 
 class RasterTileCache {
   static constexpr unsigned MAX_RTC_TILES = 4096;
@@ -35,6 +38,14 @@ class RasterTileCache {
   static constexpr unsigned MAX_ACTIVE_TILES = 512;
 #endif
 
+  /**
+   * Maximum number of tiles loaded at a time, to reduce system load
+   * peaks.
+   */
+  static constexpr unsigned MAX_ACTIVATE = MAX_ACTIVE_TILES > 32
+    ? 16
+    : MAX_ACTIVE_TILES / 2;
+
   /**
    * Target number of steps in intersection searches; total distance
    * is shifted by this number of bits
@@ -88,6 +99,18 @@ protected:
 
   bool dirty;
 
+  /**
+   * Are all tiles served from a #RasterTileStore?  If yes, then
+   * tiles are never loaded or unloaded by PollTiles().
+   */
+  bool mapped = false;
+
+  /**
+   * Lower resolution levels for zoomed out views, see
+   * AttachPyramid().
+   */
+  const RasterPyramid *pyramid = nullptr;
+
   /**
    * This serial gets updated each time the tiles get loaded or
    * discarded.
@@ -150,6 +173,26 @@ public:
   [[gnu::pure]]
   TerrainHeight GetInterpolatedHeight(RasterLocation p) const noexcept;
 
+  /**
+   * Determine the non-interpolated heights at many pixel locations
+   * at once.  This is cheaper than calling GetHeight() for each
+   * point, because consecutive points on the same tile share the
+   * tile lookup.
+   *
+   * @param points the pixel positions within the map; may be out of
+   * range
+   * @param dest a buffer with space for points.size() elements
+   */
+  void GetHeights(std::span<const RasterLocation> points,
+                  TerrainHeight *dest) const noexcept;
+
+  /**
+   * Determine the interpolated heights at many sub-pixel locations
+   * at once.  See GetHeights().
+   */
+  void GetInterpolatedHeights(std::span<const RasterLocation> points,
+                              TerrainHeight *dest) const noexcept;
+
   /**
    * Scan a straight line and fill the buffer with the specified
    * number of samples along the line.
@@ -219,6 +262,41 @@ public:
     return bounds.IsValid();
   }
 
+  unsigned GetTileCount() const noexcept {
+    return tiles.GetSize();
+  }
+
+  /**
+   * Let all tiles refer to the pre-decoded data in the given
+   * #RasterTileStore, which must remain valid until Reset() is
+   * called.
+   *
+   * @return false if the store does not match this object (nothing
+   * has been modified in this case)
+   */
+  bool AttachTileStore(const RasterTileStore &store) noexcept;
+
+  bool IsMapped() const noexcept {
+    return mapped;
+  }
+
+  /**
+   * Let ScanLine() use the given #RasterPyramid when the sampling
+   * density is low.  It must remain valid until Reset() is called.
+   *
+   * @return false if the pyramid does not match this object
+   */
+  bool AttachPyramid(const RasterPyramid &_pyramid) noexcept;
+
+  /**
+   * Copy one row of full-resolution height values.  Pixels of tiles
+   * which are not loaded are taken from the overview.
+   *
+   * @param y the pixel row; must be smaller than the height
+   * @param dest a buffer with space for GetSize().x elements
+   */
+  void ReadRow(unsigned y, TerrainHeight *dest) const noexcept;
+
   const Serial &GetSerial() const noexcept {
     return serial;
   }
@@ -260,6 +338,14 @@ public:
 
   bool PollTiles(SignedRasterLocation p, unsigned radius) noexcept;
 
+  using RequestedTiles = StaticArray<uint16_t, MAX_ACTIVATE>;
+
+  /**
+   * Obtain the indexes of the tiles which were requested by
+   * PollTiles(), nearest first.
+   */
+  void GetRequestedTiles(RequestedTiles &dest) const noexcept;
+
   void PutTileData(unsigned index, const struct jas_matrix &m) noexcept;
 
   void FinishTileUpdate() noexcept;
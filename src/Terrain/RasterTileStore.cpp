@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "RasterTileStore.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "util/SpanCast.hxx"
+#include "util/Compiler.h"
+
+extern "C" {
+#include "jasper/jas_seq.h"
+}
+
+#include <stdexcept>
+
+static_assert(sizeof(TerrainHeight) == sizeof(int16_t));
+static_assert(sizeof(RasterTileStore::Entry) == 8);
+static_assert(sizeof(RasterTileStore::Footer) == 16);
+
+static constexpr std::size_t
+TileBytes(unsigned width, unsigned height) noexcept
+{
+  /* pad to a multiple of 4 bytes, to keep the following tiles and
+     the table aligned */
+  return (std::size_t(width) * height * sizeof(TerrainHeight) + 3) & ~std::size_t(3);
+}
+
+RasterTileStore::RasterTileStore(std::unique_ptr<FileMapping> &&_mapping)
+  :mapping(std::move(_mapping)),
+   payload(FileCache::GetPayload(*mapping))
+{
+  if (payload.size() < sizeof(Footer) ||
+      reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(Footer) != 0)
+    throw std::runtime_error("Malformed terrain tile store");
+
+  const auto &footer = *reinterpret_cast<const Footer *>(payload.data() + payload.size() - sizeof(Footer));
+  if (footer.magic != Footer::MAGIC || footer.version != Footer::VERSION ||
+      footer.table_offset % alignof(Entry) != 0 ||
+      footer.table_offset > payload.size() - sizeof(Footer) ||
+      footer.n_tiles > (payload.size() - sizeof(Footer) - footer.table_offset) / sizeof(Entry))
+    throw std::runtime_error("Malformed terrain tile store");
+
+  entries = {
+    reinterpret_cast<const Entry *>(payload.data() + footer.table_offset),
+    footer.n_tiles,
+  };
+
+  for (const auto &e : entries)
+    if (e.offset != Entry::NONE &&
+        (e.offset % alignof(TerrainHeight) != 0 ||
+         e.offset > footer.table_offset ||
+         TileBytes(e.width, e.height) > footer.table_offset - e.offset))
+      throw std::runtime_error("Malformed terrain tile store");
+}
+
+RasterTileStore::~RasterTileStore() noexcept = default;
+
+const TerrainHeight *
+RasterTileStore::GetTile(unsigned index, RasterLocation size) const noexcept
+{
+  if (index >= entries.size())
+    return nullptr;
+
+  const auto &e = entries[index];
+  if (e.offset == Entry::NONE || e.width != size.x || e.height != size.y)
+    return nullptr;
+
+  return reinterpret_cast<const TerrainHeight *>(payload.data() + e.offset);
+}
+
+RasterTileStoreWriter::RasterTileStoreWriter(BufferedOutputStream &_os,
+                                             unsigned n_tiles) noexcept
+  :os(_os),
+   entries(n_tiles, RasterTileStore::Entry{RasterTileStore::Entry::NONE, 0, 0})
+{
+}
+
+void
+RasterTileStoreWriter::PutTile(unsigned index,
+                               const struct jas_matrix &m) noexcept
+{
+  if (error || index >= entries.size() ||
+      entries[index].offset != RasterTileStore::Entry::NONE)
+    return;
+
+  const unsigned width = m.numcols_, height = m.numrows_;
+  const std::size_t size = TileBytes(width, height);
+  if (width == 0 || height == 0 || width > 0xffff || height > 0xffff ||
+      size > RasterTileStore::Entry::NONE - position)
+    return;
+
+  try {
+    row.GrowDiscard(width);
+
+    for (unsigned y = 0; y != height; ++y) {
+      const jas_seqent_t *gcc_restrict src = m.rows_[y];
+
+      for (unsigned x = 0; x != width; ++x)
+        row[x] = TerrainHeight(src[x]);
+
+      os.Write(std::as_bytes(std::span{row.data(), width}));
+    }
+
+    const std::size_t padding = size - std::size_t(width) * height * sizeof(TerrainHeight);
+    if (padding > 0) {
+      static constexpr std::byte zero[4]{};
+      os.Write(std::span{zero, padding});
+    }
+  } catch (...) {
+    error = std::current_exception();
+    return;
+  }
+
+  entries[index] = {position, uint16_t(width), uint16_t(height)};
+  position += size;
+}
+
+void
+RasterTileStoreWriter::Finish()
+{
+  if (error)
+    std::rethrow_exception(error);
+
+  const RasterTileStore::Footer footer{
+    RasterTileStore::Footer::MAGIC,
+    RasterTileStore::Footer::VERSION,
+    unsigned(entries.size()),
+    position,
+  };
+
+  os.Write(std::as_bytes(std::span{entries}));
+  os.Write(ReferenceAsBytes(footer));
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "RasterLocation.hpp"
+#include "Height.hpp"
+#include "util/AllocatedArray.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <span>
+#include <vector>
+
+struct jas_matrix;
+class FileMapping;
+class BufferedOutputStream;
+
+/**
+ * A flat file containing all terrain tiles, already decoded to
+ * #TerrainHeight values.  It is generated once from the JPEG2000
+ * file (see #RasterTileStoreWriter) and stored in the #FileCache.
+ * After that, #RasterTileCache can use it via mmap() instead of
+ * decoding tiles, leaving memory management to the kernel's page
+ * cache.
+ *
+ * File layout (after the #FileCache header): the raw tile data (each
+ * tile padded to a multiple of 4 bytes), followed by one #Entry per
+ * tile, followed by the #Footer.
+ */
+class RasterTileStore {
+public:
+  struct Entry {
+    static constexpr uint32_t NONE = ~uint32_t(0);
+
+    /**
+     * The offset of the tile data within the payload, or #NONE if
+     * this tile was not stored.
+     */
+    uint32_t offset;
+
+    uint16_t width, height;
+  };
+
+  struct Footer {
+    static constexpr uint32_t MAGIC = 0x54535258; // "XRST"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic, version;
+
+    uint32_t n_tiles;
+
+    /**
+     * The offset of the #Entry array within the payload.
+     */
+    uint32_t table_offset;
+  };
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  std::span<const std::byte> payload;
+
+  std::span<const Entry> entries;
+
+public:
+  /**
+   * Throws on error.
+   *
+   * @param _mapping a mapping obtained from FileCache::Map()
+   */
+  explicit RasterTileStore(std::unique_ptr<FileMapping> &&_mapping);
+
+  ~RasterTileStore() noexcept;
+
+  RasterTileStore(const RasterTileStore &) = delete;
+  RasterTileStore &operator=(const RasterTileStore &) = delete;
+
+  unsigned GetTileCount() const noexcept {
+    return entries.size();
+  }
+
+  /**
+   * Returns a pointer to the decoded tile data or nullptr if the
+   * tile was not stored or does not have the expected size.
+   */
+  [[gnu::pure]]
+  const TerrainHeight *GetTile(unsigned index,
+                               RasterLocation size) const noexcept;
+};
+
+/**
+ * Writes a #RasterTileStore file while the JPEG2000 decoder delivers
+ * tiles (see TerrainLoader::PutTileData()).
+ */
+class RasterTileStoreWriter {
+  BufferedOutputStream &os;
+
+  std::vector<RasterTileStore::Entry> entries;
+
+  /**
+   * A buffer for converting one row of a tile.
+   */
+  AllocatedArray<TerrainHeight> row;
+
+  /**
+   * The number of bytes written so far.
+   */
+  uint32_t position = 0;
+
+  /**
+   * An error which occurred in PutTile(); it will be rethrown by
+   * Finish().
+   */
+  std::exception_ptr error;
+
+public:
+  RasterTileStoreWriter(BufferedOutputStream &_os,
+                        unsigned n_tiles) noexcept;
+
+  /**
+   * Append the data of one tile.  This method is called from the
+   * (C) decoder, and therefore cannot throw; errors are postponed
+   * until Finish().
+   */
+  void PutTile(unsigned index, const struct jas_matrix &m) noexcept;
+
+  /**
+   * Write the tile table.  Throws on error.
+   */
+  void Finish();
+};
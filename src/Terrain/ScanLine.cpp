@@ -3,6 +3,9 @@
 
 #include "Terrain/RasterTileCache.hpp"
 #include "Terrain/RasterLocation.hpp"
+#include "Terrain/RasterPyramid.hpp"
+
+#include <algorithm>
 
 /**
  * A #RasterLocation with some cached computations.  The
@@ -315,6 +318,24 @@ RasterTileCache::ScanLine(const RasterLocation _start,
   assert(_end.y < GetFineSize().y);
   assert(size >= 2);
 
+  if (pyramid != nullptr) {
+    /* when zoomed out, each sample covers many "fine" pixels; scan
+       the matching lower resolution level instead, which is much
+       smaller (fewer page faults) and filtered (less aliasing) */
+    const unsigned length =
+      std::max(_start.x > _end.x ? _start.x - _end.x : _end.x - _start.x,
+               _start.y > _end.y ? _start.y - _end.y : _end.y - _start.y);
+    const unsigned step = (length / (size - 1)) >> RasterTraits::SUBPIXEL_BITS;
+
+    if (const unsigned level = pyramid->FindLevel(step); level > 0) {
+      /* range checking is needed because the level size is rounded
+         up */
+      pyramid->GetLevel(level).ScanLineChecked(_start >> level, _end >> level,
+                                               buffer, size, interpolate);
+      return;
+    }
+  }
+
   const GridRay ray(GetFineTileSize(), _start, _end, size);
   assert(ray.size == size);
   assert(ray.start.index == 0);
@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "SlopeShading.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Height values below this one are "special" (see
+ * TerrainHeight::IsSpecial()).
+ */
+static constexpr int16_t SPECIAL_LIMIT = -29999;
+static_assert(TerrainHeight(SPECIAL_LIMIT - 1).IsSpecial());
+static_assert(!TerrainHeight(SPECIAL_LIMIT).IsSpecial());
+
+#ifdef __SSE2__
+
+/**
+ * Load 8 height values.
+ */
+[[gnu::always_inline]]
+static inline __m128i
+Load8(const TerrainHeight *p) noexcept
+{
+  static_assert(sizeof(TerrainHeight) == sizeof(int16_t));
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+/**
+ * Vectorised version of ClipHeightDelta().  Saturating the
+ * difference first yields the same result, because the clip range
+ * is well within int16_t.
+ */
+[[gnu::always_inline]]
+static inline __m128i
+ClipHeightDelta(__m128i a, __m128i b) noexcept
+{
+  const __m128i d = _mm_subs_epi16(a, b);
+  return _mm_min_epi16(_mm_max_epi16(d, _mm_set1_epi16(-512)),
+                       _mm_set1_epi16(512));
+}
+
+[[gnu::always_inline]]
+static inline __m128
+LowToFloat(__m128i v) noexcept
+{
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+}
+
+[[gnu::always_inline]]
+static inline __m128
+HighToFloat(__m128i v) noexcept
+{
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+}
+
+/**
+ * Evaluate the slope shading formula for 4 pixels.  All operands
+ * are integers which are represented exactly as float, and the
+ * truncating conversions mimic the integer arithmetic of the
+ * portable implementation.
+ *
+ * @return the (unclipped) illumination indices
+ */
+[[gnu::always_inline]]
+static inline __m128i
+Shade4(__m128 p22, __m128 p32,
+       __m128 p31, __m128 p20, __m128 dd2, __m128 dd2_square,
+       __m128 sx, __m128 sy, __m128 sz, __m128 contrast) noexcept
+{
+  const __m128 dd0 = _mm_mul_ps(p22, p31);
+  const __m128 dd1 = _mm_mul_ps(p20, p32);
+  const __m128 num = _mm_add_ps(_mm_mul_ps(dd2, sz),
+                                _mm_add_ps(_mm_mul_ps(dd0, sx),
+                                           _mm_mul_ps(dd1, sy)));
+  const __m128 square_mag = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dd0, dd0),
+                                                  _mm_mul_ps(dd1, dd1)),
+                                       dd2_square);
+  const __m128i mag = _mm_or_si128(_mm_cvttps_epi32(_mm_sqrt_ps(square_mag)),
+                                   _mm_set1_epi32(1));
+  const __m128 sval =
+    _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(num, _mm_cvtepi32_ps(mag))));
+  const __m128 sindex = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(sval, sz), contrast),
+                                   _mm_set1_ps(1.f / 128));
+  return _mm_cvttps_epi32(sindex);
+}
+
+#elif defined(__ARM_NEON)
+
+[[gnu::always_inline]]
+static inline int16x8_t
+Load8(const TerrainHeight *p) noexcept
+{
+  static_assert(sizeof(TerrainHeight) == sizeof(int16_t));
+  return vld1q_s16(reinterpret_cast<const int16_t *>(p));
+}
+
+[[gnu::always_inline]]
+static inline int16x8_t
+ClipHeightDelta(int16x8_t a, int16x8_t b) noexcept
+{
+  const int16x8_t d = vqsubq_s16(a, b);
+  return vminq_s16(vmaxq_s16(d, vdupq_n_s16(-512)), vdupq_n_s16(512));
+}
+
+[[gnu::always_inline]]
+static inline float32x4_t
+LowToFloat(int16x8_t v) noexcept
+{
+  return vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+}
+
+[[gnu::always_inline]]
+static inline float32x4_t
+HighToFloat(int16x8_t v) noexcept
+{
+  return vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+}
+
+#ifdef __aarch64__
+
+[[gnu::always_inline]]
+static inline float32x4_t
+Sqrt(float32x4_t x) noexcept
+{
+  return vsqrtq_f32(x);
+}
+
+[[gnu::always_inline]]
+static inline float32x4_t
+Divide(float32x4_t a, float32x4_t b) noexcept
+{
+  return vdivq_f32(a, b);
+}
+
+#else
+
+/**
+ * ARMv7 NEON has no square root instruction; use the reciprocal
+ * square root estimate with two Newton-Raphson steps.  The argument
+ * must be positive.
+ */
+[[gnu::always_inline]]
+static inline float32x4_t
+Sqrt(float32x4_t x) noexcept
+{
+  float32x4_t r = vrsqrteq_f32(x);
+  r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(x, r), r));
+  r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(x, r), r));
+  return vmulq_f32(x, r);
+}
+
+/**
+ * ARMv7 NEON has no division instruction; use the reciprocal
+ * estimate with two Newton-Raphson steps.
+ */
+[[gnu::always_inline]]
+static inline float32x4_t
+Divide(float32x4_t a, float32x4_t b) noexcept
+{
+  float32x4_t r = vrecpeq_f32(b);
+  r = vmulq_f32(r, vrecpsq_f32(b, r));
+  r = vmulq_f32(r, vrecpsq_f32(b, r));
+  return vmulq_f32(a, r);
+}
+
+#endif
+
+[[gnu::always_inline]]
+static inline int32x4_t
+Shade4(float32x4_t p22, float32x4_t p32,
+       float32x4_t p31, float32x4_t p20,
+       float32x4_t dd2, float32x4_t dd2_square,
+       float32x4_t sx, float32x4_t sy, float32x4_t sz,
+       float32x4_t contrast) noexcept
+{
+  const float32x4_t dd0 = vmulq_f32(p22, p31);
+  const float32x4_t dd1 = vmulq_f32(p20, p32);
+  const float32x4_t num = vmlaq_f32(vmlaq_f32(vmulq_f32(dd2, sz), dd0, sx),
+                                    dd1, sy);
+  const float32x4_t square_mag =
+    vmlaq_f32(vmlaq_f32(dd2_square, dd0, dd0), dd1, dd1);
+  /* the "max" avoids Sqrt(0), which would be NaN on ARMv7 */
+  const int32x4_t mag =
+    vorrq_s32(vcvtq_s32_f32(Sqrt(vmaxq_f32(square_mag, vdupq_n_f32(1)))),
+              vdupq_n_s32(1));
+  const float32x4_t sval =
+    vcvtq_f32_s32(vcvtq_s32_f32(Divide(num, vcvtq_f32_s32(mag))));
+  const float32x4_t sindex = vmulq_f32(vmulq_f32(vsubq_f32(sval, sz),
+                                                 contrast),
+                                       vdupq_n_f32(1.f / 128));
+  return vcvtq_s32_f32(sindex);
+}
+
+#endif
+
+void
+CalculateSlopeShading(int8_t *dest,
+                      const TerrainHeight *above,
+                      const TerrainHeight *below,
+                      const TerrainHeight *left,
+                      const TerrainHeight *right,
+                      unsigned n, const unsigned p20,
+                      const SlopeShadingParameters &p) noexcept
+{
+#if defined(__SSE2__) || defined(__ARM_NEON)
+  const float dd2_int = float(p20 * p.p31 * p.height_slope_factor);
+
+#ifdef __SSE2__
+  const __m128 v_p31 = _mm_set1_ps(float(p.p31));
+  const __m128 v_p20 = _mm_set1_ps(float(p20));
+  const __m128 dd2 = _mm_set1_ps(dd2_int);
+  const __m128 dd2_square = _mm_set1_ps(dd2_int * dd2_int);
+  const __m128 sx = _mm_set1_ps(float(p.sx));
+  const __m128 sy = _mm_set1_ps(float(p.sy));
+  const __m128 sz = _mm_set1_ps(float(p.sz));
+  const __m128 contrast = _mm_set1_ps(float(p.contrast));
+
+  const __m128i special_limit = _mm_set1_epi16(SPECIAL_LIMIT);
+  const __m128i no_slope = _mm_set1_epi8(NO_SLOPE_SHADING);
+
+  for (; n >= 8; n -= 8, dest += 8,
+         above += 8, below += 8, left += 8, right += 8) {
+    const __m128i a = Load8(above), b = Load8(below);
+    const __m128i l = Load8(left), r = Load8(right);
+
+    const __m128i special =
+      _mm_or_si128(_mm_or_si128(_mm_cmplt_epi16(a, special_limit),
+                                _mm_cmplt_epi16(b, special_limit)),
+                   _mm_or_si128(_mm_cmplt_epi16(l, special_limit),
+                                _mm_cmplt_epi16(r, special_limit)));
+
+    const __m128i p32 = ClipHeightDelta(a, b);
+    const __m128i p22 = ClipHeightDelta(r, l);
+
+    const __m128i lo = Shade4(LowToFloat(p22), LowToFloat(p32),
+                              v_p31, v_p20, dd2, dd2_square,
+                              sx, sy, sz, contrast);
+    const __m128i hi = Shade4(HighToFloat(p22), HighToFloat(p32),
+                              v_p31, v_p20, dd2, dd2_square,
+                              sx, sy, sz, contrast);
+
+    __m128i sindex = _mm_packs_epi32(lo, hi);
+    sindex = _mm_min_epi16(_mm_max_epi16(sindex, _mm_set1_epi16(-63)),
+                           _mm_set1_epi16(63));
+
+    const __m128i mask = _mm_packs_epi16(special, special);
+    sindex = _mm_packs_epi16(sindex, sindex);
+    sindex = _mm_or_si128(_mm_andnot_si128(mask, sindex),
+                          _mm_and_si128(mask, no_slope));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dest), sindex);
+  }
+#else
+  const float32x4_t v_p31 = vdupq_n_f32(float(p.p31));
+  const float32x4_t v_p20 = vdupq_n_f32(float(p20));
+  const float32x4_t dd2 = vdupq_n_f32(dd2_int);
+  const float32x4_t dd2_square = vdupq_n_f32(dd2_int * dd2_int);
+  const float32x4_t sx = vdupq_n_f32(float(p.sx));
+  const float32x4_t sy = vdupq_n_f32(float(p.sy));
+  const float32x4_t sz = vdupq_n_f32(float(p.sz));
+  const float32x4_t contrast = vdupq_n_f32(float(p.contrast));
+
+  const int16x8_t special_limit = vdupq_n_s16(SPECIAL_LIMIT);
+
+  for (; n >= 8; n -= 8, dest += 8,
+         above += 8, below += 8, left += 8, right += 8) {
+    const int16x8_t a = Load8(above), b = Load8(below);
+    const int16x8_t l = Load8(left), r = Load8(right);
+
+    const uint16x8_t special =
+      vorrq_u16(vorrq_u16(vcltq_s16(a, special_limit),
+                          vcltq_s16(b, special_limit)),
+                vorrq_u16(vcltq_s16(l, special_limit),
+                          vcltq_s16(r, special_limit)));
+
+    const int16x8_t p32 = ClipHeightDelta(a, b);
+    const int16x8_t p22 = ClipHeightDelta(r, l);
+
+    const int32x4_t lo = Shade4(LowToFloat(p22), LowToFloat(p32),
+                                v_p31, v_p20, dd2, dd2_square,
+                                sx, sy, sz, contrast);
+    const int32x4_t hi = Shade4(HighToFloat(p22), HighToFloat(p32),
+                                v_p31, v_p20, dd2, dd2_square,
+                                sx, sy, sz, contrast);
+
+    int16x8_t sindex = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+    sindex = vminq_s16(vmaxq_s16(sindex, vdupq_n_s16(-63)),
+                       vdupq_n_s16(63));
+
+    const int8x8_t result = vbsl_s8(vmovn_u16(special),
+                                    vdup_n_s8(NO_SLOPE_SHADING),
+                                    vmovn_s16(sindex));
+    vst1_s8(dest, result);
+  }
+#endif
+#endif
+
+  /* the remainder (or everything, if there is no SIMD support) */
+  for (unsigned i = 0; i < n; ++i)
+    dest[i] = CalculateSlopeShading(above[i], below[i], left[i], right[i],
+                                    p20, p);
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Height.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Returned by CalculateSlopeShading() when one of the neighbouring
+ * height values is "special" (water or invalid), i.e. no slope can be
+ * calculated.
+ */
+static constexpr int8_t NO_SLOPE_SHADING = 127;
+
+/**
+ * The parameters of the slope shading formula which are constant for
+ * one row of the #HeightMatrix.
+ */
+struct SlopeShadingParameters {
+  /**
+   * The direction of the light source, scaled to 255.
+   */
+  int sx, sy, sz;
+
+  int contrast;
+
+  unsigned height_slope_factor;
+
+  /**
+   * The vertical distance between the "above" and the "below" height
+   * sample.
+   */
+  unsigned p31;
+};
+
+/**
+ * Clip the difference between two adjacent terrain height values to
+ * sane bounds.  This works around integer overflows in the slope
+ * shading formula when the map file is broken, avoiding the sqrt()
+ * call with a negative argument.
+ */
+static constexpr int
+ClipHeightDelta(int d) noexcept
+{
+  return std::clamp(d, -512, 512);
+}
+
+static constexpr int
+ClipHeightDelta(TerrainHeight a, TerrainHeight b) noexcept
+{
+  return ClipHeightDelta(a.GetValue() - b.GetValue());
+}
+
+/**
+ * Calculate the illumination of one pixel from its four neighbours.
+ * This is the portable reference implementation.
+ *
+ * @param p20 the horizontal distance between the "left" and the
+ * "right" height sample
+ * @return the illumination index (-63..63) or #NO_SLOPE_SHADING
+ */
+[[gnu::pure]]
+static inline int8_t
+CalculateSlopeShading(TerrainHeight above, TerrainHeight below,
+                      TerrainHeight left, TerrainHeight right,
+                      unsigned p20,
+                      const SlopeShadingParameters &p) noexcept
+{
+  if (above.IsSpecial() || below.IsSpecial() ||
+      left.IsSpecial() || right.IsSpecial()) [[unlikely]]
+    return NO_SLOPE_SHADING;
+
+  const int p32 = ClipHeightDelta(above, below);
+  const int p22 = ClipHeightDelta(right, left);
+
+  const int dd0 = p22 * int(p.p31);
+  const int dd1 = int(p20) * p32;
+  const unsigned dd2 = p20 * p.p31 * p.height_slope_factor;
+  const int num = (int(dd2) * p.sz + dd0 * p.sx + dd1 * p.sy);
+  const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
+  const unsigned mag = (unsigned)std::sqrt(square_mag);
+  /* this is a workaround for a SIGFPE (division by zero)
+     observed by our users on some Android devices (e.g. Nexus
+     7), even though we did our best to make sure that the
+     integer arithmetics above can't overflow */
+  /* TODO: debug this problem and replace this workaround */
+  const int sval = num / int(mag|1);
+  const int sindex = (sval - p.sz) * p.contrast / 128;
+  return std::clamp(sindex, -63, 63);
+}
+
+/**
+ * Calculate the illumination of #n consecutive pixels, all of which
+ * have the same distances to their neighbours.  Uses SIMD
+ * instructions (SSE2 or NEON) if available at compile time; the
+ * result may differ from the portable implementation by one shading
+ * level due to rounding.
+ *
+ * @param dest the destination buffer for #n illumination indices
+ * (see CalculateSlopeShading())
+ * @param above, below, left, right pointers to the neighbour height
+ * samples of the first pixel
+ */
+void
+CalculateSlopeShading(int8_t *dest,
+                      const TerrainHeight *above,
+                      const TerrainHeight *below,
+                      const TerrainHeight *left,
+                      const TerrainHeight *right,
+                      unsigned n, unsigned p20,
+                      const SlopeShadingParameters &p) noexcept;
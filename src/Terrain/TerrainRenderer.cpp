@@ -326,6 +326,11 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
   compare_projection = CompareProjection(map_projection);
 #endif
 
+  /* if only the map position has changed, the previous image may be
+     scrolled instead of generating a new one from scratch */
+  const bool may_scroll = terrain_serial == terrain.GetSerial() &&
+    sunazimuth.CompareRoughly(last_sun_azimuth);
+
   terrain_serial = terrain.GetSerial();
 
   last_sun_azimuth = sunazimuth;
@@ -348,7 +353,8 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
 
   {
     RasterTerrain::Lease map(terrain);
-    raster_renderer.ScanMap(map, map_projection);
+    if (!may_scroll || !raster_renderer.ScrollMap(map, map_projection))
+      raster_renderer.ScanMap(map, map_projection);
   }
 
   raster_renderer.GenerateImage(do_shading, height_scale,
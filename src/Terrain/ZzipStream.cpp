@@ -43,6 +43,70 @@ static constexpr jas_stream_ops_t zzip_stream_ops = {
   jas_zzip_close
 };
 
+/**
+ * The stream object for OpenJasperZzipStream() with a #Mutex.
+ */
+struct LockedZzipFile {
+  struct zzip_file *const file;
+  Mutex &mutex;
+};
+
+static int
+jas_locked_zzip_read(jas_stream_obj_t *obj, char *buf, unsigned cnt)
+{
+  const auto &f = *(LockedZzipFile *)obj;
+  const std::lock_guard lock{f.mutex};
+  return zzip_fread(buf, 1, cnt, f.file);
+}
+
+static long
+jas_locked_zzip_seek(jas_stream_obj_t *obj, long offset, int origin)
+{
+  const auto &f = *(LockedZzipFile *)obj;
+  const std::lock_guard lock{f.mutex};
+  return zzip_seek(f.file, offset, origin);
+}
+
+static int
+jas_locked_zzip_close(jas_stream_obj_t *obj)
+{
+  const auto f = (LockedZzipFile *)obj;
+
+  int result;
+
+  {
+    const std::lock_guard lock{f->mutex};
+    result = zzip_close(f->file);
+  }
+
+  delete f;
+  return result;
+}
+
+static constexpr jas_stream_ops_t locked_zzip_stream_ops = {
+  jas_locked_zzip_read,
+  jas_zzip_write,
+  jas_locked_zzip_seek,
+  jas_locked_zzip_close
+};
+
+static jas_stream_t *
+CreateJasperStream(jas_stream_obj_t *obj, const jas_stream_ops_t &ops)
+{
+  jas_stream_t *stream = jas_stream_create();
+  if (stream == nullptr)
+    return nullptr;
+
+  stream->openmode_ = JAS_STREAM_READ|JAS_STREAM_BINARY;
+  stream->obj_ = obj;
+  stream->ops_ = const_cast<jas_stream_ops_t *>(&ops);
+
+  /* By default, use full buffering for this type of stream. */
+  jas_stream_initbuf(stream, JAS_STREAM_FULLBUF, 0, 0);
+
+  return stream;
+}
+
 jas_stream_t *
 OpenJasperZzipStream(struct zzip_dir *dir, const char *path)
 {
@@ -50,18 +114,34 @@ OpenJasperZzipStream(struct zzip_dir *dir, const char *path)
   if (f == nullptr)
     throw FmtRuntimeError("Failed to open '{}' from map file", path);
 
-  jas_stream_t *stream = jas_stream_create();
+  jas_stream_t *stream = CreateJasperStream(f, zzip_stream_ops);
   if (stream == nullptr) {
     zzip_close(f);
     throw std::runtime_error("jas_stream_create() failed");
   }
 
-  stream->openmode_ = JAS_STREAM_READ|JAS_STREAM_BINARY;
-  stream->obj_ = f;
-  stream->ops_ = const_cast<jas_stream_ops_t *>(&zzip_stream_ops);
+  return stream;
+}
 
-  /* By default, use full buffering for this type of stream. */
-  jas_stream_initbuf(stream, JAS_STREAM_FULLBUF, 0, 0);
+jas_stream_t *
+OpenJasperZzipStream(struct zzip_dir *dir, const char *path, Mutex &mutex)
+{
+  std::unique_lock lock{mutex};
+
+  const auto f = zzip_open_rb(dir, path);
+  if (f == nullptr)
+    throw FmtRuntimeError("Failed to open '{}' from map file", path);
+
+  lock.unlock();
+
+  auto *obj = new LockedZzipFile{f, mutex};
+  jas_stream_t *stream = CreateJasperStream(obj, locked_zzip_stream_ops);
+  if (stream == nullptr) {
+    delete obj;
+    lock.lock();
+    zzip_close(f);
+    throw std::runtime_error("jas_stream_create() failed");
+  }
 
   return stream;
 }
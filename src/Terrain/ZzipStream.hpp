@@ -4,6 +4,7 @@
 #pragma once
 
 #include "jasper/jas_stream.h"
+#include "thread/Mutex.hxx"
 
 struct zzip_dir;
 
@@ -12,3 +13,15 @@ struct zzip_dir;
  */
 jas_stream_t *
 OpenJasperZzipStream(struct zzip_dir *dir, const char *path);
+
+/**
+ * Like OpenJasperZzipStream(), but lock the given mutex around each
+ * access to the ZIP archive.  This allows several threads to read
+ * different streams of the same #zzip_dir, as long as all of them
+ * share the same mutex.
+ *
+ * Throws on error.
+ */
+jas_stream_t *
+OpenJasperZzipStream(struct zzip_dir *dir, const char *path,
+                     Mutex &mutex);
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "RangeAllocator.hpp"
+
+#include <cassert>
+#include <iterator>
+
+void
+RangeAllocator::Reset(unsigned _capacity) noexcept
+{
+  capacity = _capacity;
+  used = 0;
+
+  allocated.clear();
+  free_ranges.clear();
+  if (capacity > 0)
+    free_ranges.emplace(0, capacity);
+}
+
+unsigned
+RangeAllocator::Allocate(unsigned size) noexcept
+{
+  assert(size > 0);
+
+  for (auto i = free_ranges.begin(); i != free_ranges.end(); ++i) {
+    if (i->second < size)
+      continue;
+
+    const unsigned offset = i->first;
+    const unsigned remaining = i->second - size;
+    free_ranges.erase(i);
+    if (remaining > 0)
+      free_ranges.emplace(offset + size, remaining);
+
+    allocated.emplace(offset, size);
+    used += size;
+    return offset;
+  }
+
+  return NONE;
+}
+
+void
+RangeAllocator::Free(unsigned offset) noexcept
+{
+  const auto a = allocated.find(offset);
+  assert(a != allocated.end());
+
+  unsigned size = a->second;
+  allocated.erase(a);
+
+  assert(used >= size);
+  used -= size;
+
+  /* merge with the following free range */
+  auto next = free_ranges.lower_bound(offset);
+  assert(next == free_ranges.end() || next->first >= offset + size);
+  if (next != free_ranges.end() && next->first == offset + size) {
+    size += next->second;
+    next = free_ranges.erase(next);
+  }
+
+  /* merge with the preceding free range */
+  if (next != free_ranges.begin()) {
+    const auto prev = std::prev(next);
+    assert(prev->first + prev->second <= offset);
+    if (prev->first + prev->second == offset) {
+      prev->second += size;
+      return;
+    }
+  }
+
+  free_ranges.emplace_hint(next, offset, size);
+}
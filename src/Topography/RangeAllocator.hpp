@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+
+/**
+ * Manages the space of a fixed-size buffer (e.g. an OpenGL vertex
+ * buffer object), handing out ranges to callers.  Freed ranges are
+ * merged with their neighbours.  The unit (bytes, vertices, ...) is
+ * up to the caller.
+ */
+class RangeAllocator {
+  /**
+   * Maps the offset of each free range to its size.
+   */
+  std::map<unsigned, unsigned> free_ranges;
+
+  /**
+   * Maps the offset of each allocated range to its size.
+   */
+  std::unordered_map<unsigned, unsigned> allocated;
+
+  unsigned capacity = 0, used = 0;
+
+public:
+  static constexpr unsigned NONE = ~0U;
+
+  unsigned GetCapacity() const noexcept {
+    return capacity;
+  }
+
+  /**
+   * Returns the total size of all allocated ranges.
+   */
+  unsigned GetUsed() const noexcept {
+    return used;
+  }
+
+  /**
+   * Free all ranges and change the capacity.
+   */
+  void Reset(unsigned _capacity) noexcept;
+
+  /**
+   * Allocate a range (first fit).
+   *
+   * @param size the size of the range; must be positive
+   * @return the offset of the range or #NONE if there is no free
+   * range which is large enough
+   */
+  unsigned Allocate(unsigned size) noexcept;
+
+  /**
+   * Free a range which was returned by Allocate().
+   */
+  void Free(unsigned offset) noexcept;
+};
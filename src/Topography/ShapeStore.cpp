@@ -0,0 +1,353 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ShapeStore.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "util/SpanCast.hxx"
+
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+
+/* no implicit padding, so value-initialisation clears all bytes
+   which are written to the file */
+static_assert(sizeof(ShapeStore::Shape) == 88);
+static_assert(sizeof(ShapeStore::Footer) == 80);
+static_assert(alignof(XShape::Point) <= 8);
+
+static constexpr std::size_t MAX_GRID_SIZE = 256;
+
+/**
+ * Check whether a block of the given size at the given offset is
+ * properly aligned and fits within the first #limit bytes.
+ */
+static constexpr bool
+CheckBlock(uint32_t offset, std::size_t size, std::size_t align,
+           std::size_t limit) noexcept
+{
+  return offset % align == 0 && offset <= limit && size <= limit - offset;
+}
+
+static constexpr std::size_t
+CountIndexCounts(const ShapeStore::Shape &shape) noexcept
+{
+  /* polygons have one total count, lines have one count per line */
+  return shape.type == MS_SHAPE_LINE ? shape.num_lines : 1;
+}
+
+/**
+ * Convert a coordinate to a grid column/row, clamped to the grid.
+ */
+[[gnu::const]]
+static unsigned
+ToCell(Angle value, Angle min, Angle size, unsigned n) noexcept
+{
+  if (size.Native() <= 0)
+    return 0;
+
+  const double f = (value - min).Native() / size.Native() * n;
+  if (!(f > 0))
+    return 0;
+
+  if (f >= n)
+    return n - 1;
+
+  return unsigned(f);
+}
+
+/**
+ * The grid cells covered by a rectangle.
+ */
+struct CellRange {
+  unsigned x0, y0, x1, y1;
+
+  CellRange(const GeoBounds &area, const GeoBounds &bounds,
+            unsigned width, unsigned height) noexcept
+    :x0(ToCell(area.GetWest(), bounds.GetWest(),
+               bounds.GetEast() - bounds.GetWest(), width)),
+     y0(ToCell(area.GetSouth(), bounds.GetSouth(),
+               bounds.GetNorth() - bounds.GetSouth(), height)),
+     x1(ToCell(area.GetEast(), bounds.GetWest(),
+               bounds.GetEast() - bounds.GetWest(), width)),
+     y1(ToCell(area.GetNorth(), bounds.GetSouth(),
+               bounds.GetNorth() - bounds.GetSouth(), height))
+  {
+    /* a rectangle wrapping around the date line is put into all
+       columns */
+    if (x1 < x0) {
+      x0 = 0;
+      x1 = width - 1;
+    }
+  }
+
+  template<typename F>
+  void ForEach(unsigned width, F &&f) const {
+    for (unsigned y = y0; y <= y1; ++y)
+      for (unsigned x = x0; x <= x1; ++x)
+        f(y * width + x);
+  }
+};
+
+ShapeStore::ShapeStore(std::unique_ptr<FileMapping> &&_mapping)
+  :mapping(std::move(_mapping)),
+   payload(FileCache::GetPayload(*mapping))
+{
+  if (payload.size() < sizeof(Footer) ||
+      reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(Footer) != 0)
+    throw std::runtime_error("Malformed topography store");
+
+  const std::size_t footer_offset = payload.size() - sizeof(Footer);
+  const auto &footer = *At<Footer>(footer_offset);
+  if (footer.magic != Footer::MAGIC || footer.version != Footer::VERSION ||
+      footer.point_size != sizeof(XShape::Point) ||
+      !CheckBlock(footer.shapes_offset,
+                  std::size_t(footer.n_shapes) * sizeof(Shape),
+                  alignof(Shape), footer_offset) ||
+      footer.grid_offset < footer.shapes_offset + std::size_t(footer.n_shapes) * sizeof(Shape) ||
+      footer.grid_width == 0 || footer.grid_height == 0 ||
+      !CheckBlock(footer.grid_offset,
+                  (std::size_t(footer.grid_width) * footer.grid_height + 1) * sizeof(uint32_t),
+                  alignof(uint32_t), footer_offset) ||
+      !footer.bounds.Check())
+    throw std::runtime_error("Malformed topography store");
+
+  shapes = {At<Shape>(footer.shapes_offset), footer.n_shapes};
+  bounds = footer.bounds;
+  grid_width = footer.grid_width;
+  grid_height = footer.grid_height;
+  min_distance = footer.min_distance;
+
+  const std::size_t n_cells = std::size_t(grid_width) * grid_height;
+  cells = {At<uint32_t>(footer.grid_offset), n_cells + 1};
+
+  const std::size_t max_cell_shapes =
+    (footer_offset - footer.grid_offset) / sizeof(uint32_t) - cells.size();
+  if (cells.front() != 0 || cells.back() > max_cell_shapes ||
+      !std::is_sorted(cells.begin(), cells.end()))
+    throw std::runtime_error("Malformed topography store");
+
+  cell_shapes = {cells.data() + cells.size(), cells.back()};
+  for (const uint32_t i : cell_shapes)
+    if (i >= shapes.size())
+      throw std::runtime_error("Malformed topography store");
+
+  for (const auto &shape : shapes)
+    if (!CheckShape(shape, footer.shapes_offset))
+      throw std::runtime_error("Malformed topography store");
+}
+
+ShapeStore::~ShapeStore() noexcept = default;
+
+bool
+ShapeStore::CheckShape(const Shape &shape, std::size_t limit) const noexcept
+{
+  if (shape.type > MS_SHAPE_NULL || shape.num_lines > XShape::MAX_LINES ||
+      !shape.bounds.Check())
+    return false;
+
+  if (!CheckBlock(shape.lines_offset, shape.num_lines * sizeof(uint16_t),
+                  alignof(uint16_t), limit) ||
+      !CheckBlock(shape.points_offset,
+                  std::size_t(shape.n_points) * sizeof(XShape::Point),
+                  alignof(XShape::Point), limit))
+    return false;
+
+  const std::span<const uint16_t> lines{GetLines(shape), shape.num_lines};
+  if (std::accumulate(lines.begin(), lines.end(), std::size_t{}) != shape.n_points)
+    return false;
+
+  if (shape.label_offset != NONE &&
+      (!CheckBlock(shape.label_offset,
+                   (std::size_t(shape.label_length) + 1) * sizeof(TCHAR),
+                   alignof(TCHAR), limit) ||
+       GetLabel(shape)[shape.label_length] != 0))
+    return false;
+
+  for (unsigned level = 0; level < THINNING_LEVELS; ++level) {
+    const uint32_t offset = shape.index_offset[level];
+    if (offset == NONE)
+      continue;
+
+    const std::size_t size = shape.index_size[level];
+    const std::size_t n_counts = CountIndexCounts(shape);
+    if ((shape.type != MS_SHAPE_LINE && shape.type != MS_SHAPE_POLYGON) ||
+        !CheckBlock(offset, size * sizeof(uint16_t), alignof(uint16_t), limit) ||
+        size < n_counts)
+      return false;
+
+    /* the index values are not checked; they are only used by the
+       GPU, which is not going to crash on out-of-range indices */
+    const std::span<const uint16_t> counts{At<uint16_t>(offset), n_counts};
+    if (std::accumulate(counts.begin(), counts.end(), std::size_t{}) != size - n_counts)
+      return false;
+  }
+
+  return true;
+}
+
+#ifdef ENABLE_OPENGL
+
+XShape::Indices
+ShapeStore::GetIndices(const Shape &shape, unsigned level) const noexcept
+{
+  assert(level < THINNING_LEVELS);
+
+  const uint32_t offset = shape.index_offset[level];
+  if (offset == NONE)
+    return {nullptr, nullptr};
+
+  const uint16_t *count = At<uint16_t>(offset);
+  return {count + CountIndexCounts(shape), count};
+}
+
+#endif
+
+bool
+ShapeStore::FindShapes(const GeoBounds &area,
+                       std::span<bool> status) const noexcept
+{
+  assert(status.size() == shapes.size());
+
+  if (!bounds.Overlaps(area))
+    return false;
+
+  const CellRange range{area, bounds, grid_width, grid_height};
+  range.ForEach(grid_width, [this, &area, status](std::size_t cell){
+    for (std::size_t j = cells[cell]; j < cells[cell + 1]; ++j) {
+      const uint32_t i = cell_shapes[j];
+      if (!status[i] && shapes[i].bounds.Overlaps(area))
+        status[i] = true;
+    }
+  });
+
+  return true;
+}
+
+uint32_t
+ShapeStoreWriter::Write(std::span<const std::byte> src)
+{
+  /* leave room for padding */
+  if (src.size() > ShapeStore::NONE - 8 - position)
+    throw std::runtime_error("Topography store is too large");
+
+  const uint32_t offset = position;
+  os.Write(src);
+  position += src.size();
+  return offset;
+}
+
+void
+ShapeStoreWriter::Align()
+{
+  static constexpr std::byte zero[8]{};
+  Write(std::span{zero, (8 - position % 8) % 8});
+}
+
+void
+ShapeStoreWriter::Add(const XShape &src)
+{
+  ShapeStore::Shape shape{};
+
+  const auto lines = src.GetLines();
+
+  shape.bounds = src.get_bounds();
+  shape.type = src.get_type();
+  shape.num_lines = lines.size();
+  shape.n_points = std::accumulate(lines.begin(), lines.end(), 0U);
+
+  shape.lines_offset = WriteBlock(std::as_bytes(lines));
+  shape.points_offset =
+    WriteBlock(std::as_bytes(std::span{src.GetPoints(), shape.n_points}));
+
+  if (const TCHAR *label = src.GetLabel(); label != nullptr) {
+    const std::size_t length = _tcslen(label);
+    shape.label_length = length;
+    shape.label_offset =
+      WriteBlock(std::as_bytes(std::span{label, length + 1}));
+  } else
+    shape.label_offset = ShapeStore::NONE;
+
+  shape.index_offset.fill(ShapeStore::NONE);
+
+#ifdef ENABLE_OPENGL
+  if (shape.type == MS_SHAPE_LINE || shape.type == MS_SHAPE_POLYGON) {
+    const std::size_t n_counts = CountIndexCounts(shape);
+
+    for (unsigned level = 0; level < ShapeStore::THINNING_LEVELS; ++level) {
+      if (shape.type == MS_SHAPE_LINE && level == 0)
+        /* TopographyFileRenderer draws unthinned lines without
+           indices */
+        continue;
+
+      const auto indices = src.GetIndices(level, min_distance[level]);
+      if (indices.indices == nullptr)
+        continue;
+
+      const std::span counts{indices.count, n_counts};
+      const std::size_t n_indices =
+        std::accumulate(counts.begin(), counts.end(), std::size_t{});
+
+      shape.index_offset[level] = Write(std::as_bytes(counts));
+      Write(std::as_bytes(std::span{indices.indices, n_indices}));
+      Align();
+      shape.index_size[level] = n_counts + n_indices;
+    }
+  }
+#endif
+
+  shapes.push_back(shape);
+}
+
+void
+ShapeStoreWriter::Finish(const GeoBounds &bounds)
+{
+  /* aim for about 4 shapes per cell */
+  unsigned grid_size = 1;
+  while (grid_size < MAX_GRID_SIZE &&
+         std::size_t(grid_size) * grid_size * 4 < shapes.size())
+    grid_size *= 2;
+
+  unsigned grid_width = grid_size, grid_height = grid_size;
+  if (!bounds.Check() ||
+      (bounds.GetEast() - bounds.GetWest()).Native() <= 0 ||
+      (bounds.GetNorth() - bounds.GetSouth()).Native() <= 0)
+    grid_width = grid_height = 1;
+
+  /* build the grid: count the shapes of each cell first, then
+     convert the counts to start positions and fill in the shape
+     numbers */
+  std::vector<uint32_t> cells(std::size_t(grid_width) * grid_height + 1, 0);
+  for (const auto &shape : shapes)
+    CellRange{shape.bounds, bounds, grid_width, grid_height}
+      .ForEach(grid_width, [&cells](std::size_t cell){
+        ++cells[cell + 1];
+      });
+
+  std::partial_sum(cells.begin(), cells.end(), cells.begin());
+
+  std::vector<uint32_t> cell_shapes(cells.back());
+  std::vector<uint32_t> fill(cells.begin(), cells.end() - 1);
+  for (std::size_t i = 0; i < shapes.size(); ++i)
+    CellRange{shapes[i].bounds, bounds, grid_width, grid_height}
+      .ForEach(grid_width, [&cell_shapes, &fill, i](std::size_t cell){
+        cell_shapes[fill[cell]++] = i;
+      });
+
+  ShapeStore::Footer footer{};
+  footer.magic = ShapeStore::Footer::MAGIC;
+  footer.version = ShapeStore::Footer::VERSION;
+  footer.point_size = sizeof(XShape::Point);
+  footer.n_shapes = shapes.size();
+  footer.shapes_offset = WriteBlock(std::as_bytes(std::span{shapes}));
+  footer.grid_offset = Write(std::as_bytes(std::span{cells}));
+  Write(std::as_bytes(std::span{cell_shapes}));
+  Align();
+  footer.grid_width = grid_width;
+  footer.grid_height = grid_height;
+  footer.min_distance = min_distance;
+  footer.bounds = bounds;
+
+  Write(ReferenceAsBytes(footer));
+}
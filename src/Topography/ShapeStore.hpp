@@ -0,0 +1,283 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "XShape.hpp"
+#include "Geo/GeoBounds.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <tchar.h>
+
+class FileMapping;
+class BufferedOutputStream;
+
+/**
+ * A compiled copy of one shapefile: all shapes already converted to
+ * #XShape points (i.e. relative to the file center on OpenGL), the
+ * OpenGL thinning indices of all levels and a grid index for finding
+ * the shapes within a rectangle.  It is generated once from the
+ * shapefile (see #ShapeStoreWriter) and stored in the #FileCache.
+ * After that, #TopographyFile uses it via mmap() instead of calling
+ * shapelib, and its #XShape objects refer to the mapped data instead
+ * of copying it.
+ *
+ * File layout (after the #FileCache header): the data of all shapes
+ * (lines, points, label and indices, each block aligned to 8 bytes),
+ * followed by one #Shape per shape, followed by the grid (the
+ * #Footer::grid_width * #Footer::grid_height + 1 start positions of
+ * all cells and the shape numbers referenced by them, all uint32_t),
+ * followed by the #Footer.
+ */
+class ShapeStore {
+public:
+  static constexpr uint32_t NONE = ~uint32_t(0);
+
+  static constexpr std::size_t THINNING_LEVELS = 4;
+
+  struct Shape {
+    GeoBounds bounds;
+
+    /**
+     * The offset of the uint16_t array containing the number of
+     * points of each line.
+     */
+    uint32_t lines_offset;
+
+    /**
+     * The offset of the #XShape::Point array.
+     */
+    uint32_t points_offset;
+
+    uint32_t n_points;
+
+    /**
+     * The offset of the null-terminated label or #NONE.
+     */
+    uint32_t label_offset;
+
+    uint32_t label_length;
+
+    /**
+     * The offset of the thinning indices of each level (see
+     * XShape::Indices) or #NONE.  This is the "count" array (1 item
+     * for polygons, one per line for lines), followed by the
+     * indices.
+     */
+    std::array<uint32_t, THINNING_LEVELS> index_offset;
+
+    /**
+     * The total number of uint16_t items at #index_offset.
+     */
+    std::array<uint32_t, THINNING_LEVELS> index_size;
+
+    uint8_t type, num_lines;
+
+    uint8_t reserved[2];
+  };
+
+  struct Footer {
+    static constexpr uint32_t MAGIC = 0x50545358; // "XSTP"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic, version;
+
+    /**
+     * sizeof(XShape::Point); this rejects files written by a build
+     * with a different point type.
+     */
+    uint32_t point_size;
+
+    uint32_t n_shapes;
+
+    /**
+     * The offset of the #Shape array within the payload.
+     */
+    uint32_t shapes_offset;
+
+    /**
+     * The offset of the grid within the payload.
+     */
+    uint32_t grid_offset;
+
+    uint16_t grid_width, grid_height;
+
+    /**
+     * The minimum point distance which was used to build the
+     * thinning indices of each level (OpenGL only).
+     */
+    std::array<float, THINNING_LEVELS> min_distance;
+
+    uint32_t reserved;
+
+    /**
+     * The area covered by the grid.
+     */
+    GeoBounds bounds;
+  };
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  std::span<const std::byte> payload;
+
+  std::span<const Shape> shapes;
+
+  /**
+   * The start position of each grid cell within #cell_shapes plus
+   * one end position.
+   */
+  std::span<const uint32_t> cells;
+
+  std::span<const uint32_t> cell_shapes;
+
+  GeoBounds bounds;
+
+  unsigned grid_width, grid_height;
+
+  std::array<float, THINNING_LEVELS> min_distance;
+
+public:
+  /**
+   * Throws on error.
+   *
+   * @param _mapping a mapping obtained from FileCache::Map()
+   */
+  explicit ShapeStore(std::unique_ptr<FileMapping> &&_mapping);
+
+  ~ShapeStore() noexcept;
+
+  ShapeStore(const ShapeStore &) = delete;
+  ShapeStore &operator=(const ShapeStore &) = delete;
+
+  std::size_t size() const noexcept {
+    return shapes.size();
+  }
+
+  const GeoBounds &GetBounds() const noexcept {
+    return bounds;
+  }
+
+  const auto &GetMinimumDistance() const noexcept {
+    return min_distance;
+  }
+
+  const Shape &GetShape(std::size_t i) const noexcept {
+    return shapes[i];
+  }
+
+  const uint16_t *GetLines(const Shape &shape) const noexcept {
+    return At<uint16_t>(shape.lines_offset);
+  }
+
+  const XShape::Point *GetPoints(const Shape &shape) const noexcept {
+    return At<XShape::Point>(shape.points_offset);
+  }
+
+  const TCHAR *GetLabel(const Shape &shape) const noexcept {
+    return shape.label_offset != NONE
+      ? At<TCHAR>(shape.label_offset)
+      : nullptr;
+  }
+
+#ifdef ENABLE_OPENGL
+  /**
+   * @return the precomputed thinning indices or {nullptr, nullptr}
+   */
+  [[gnu::pure]]
+  XShape::Indices GetIndices(const Shape &shape,
+                             unsigned level) const noexcept;
+#endif
+
+  /**
+   * Set the #status element of all shapes whose bounds overlap the
+   * given rectangle to true.
+   *
+   * @param status an array of size() elements
+   * @return false if the rectangle is outside of this file
+   */
+  bool FindShapes(const GeoBounds &area,
+                  std::span<bool> status) const noexcept;
+
+private:
+  [[gnu::pure]]
+  bool CheckShape(const Shape &shape, std::size_t limit) const noexcept;
+
+  template<typename T>
+  const T *At(uint32_t offset) const noexcept {
+    return reinterpret_cast<const T *>(payload.data() + offset);
+  }
+};
+
+/**
+ * Writes a #ShapeStore file.
+ */
+class ShapeStoreWriter {
+  BufferedOutputStream &os;
+
+  std::vector<ShapeStore::Shape> shapes;
+
+  std::array<float, ShapeStore::THINNING_LEVELS> min_distance{};
+
+  /**
+   * The number of bytes written so far.
+   */
+  uint32_t position = 0;
+
+public:
+  explicit ShapeStoreWriter(BufferedOutputStream &_os) noexcept
+    :os(_os) {}
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Build the thinning indices with these minimum point distances
+   * (see TopographyFile::GetMinimumShapeDistance()).
+   */
+  void SetMinimumDistance(std::span<const float, ShapeStore::THINNING_LEVELS> _min_distance) noexcept {
+    std::copy(_min_distance.begin(), _min_distance.end(),
+              min_distance.begin());
+  }
+#endif
+
+  /**
+   * Append the next shape.  Throws on error.
+   */
+  void Add(const XShape &shape);
+
+  /**
+   * Write the shape table, the grid and the footer.  Throws on
+   * error.
+   *
+   * @param bounds the bounds of the shapefile
+   */
+  void Finish(const GeoBounds &bounds);
+
+private:
+  /**
+   * @return the offset of the data
+   */
+  uint32_t Write(std::span<const std::byte> src);
+
+  /**
+   * Pad the file to a multiple of 8 bytes.
+   */
+  void Align();
+
+  /**
+   * Write a block of data, padded to a multiple of 8 bytes.
+   *
+   * @return the offset of the block
+   */
+  uint32_t WriteBlock(std::span<const std::byte> src) {
+    const uint32_t offset = Write(src);
+    Align();
+    return offset;
+  }
+};
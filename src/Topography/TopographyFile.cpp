@@ -3,10 +3,15 @@
 
 #include "Topography/TopographyFile.hpp"
 #include "Topography/XShape.hpp"
+#include "Topography/ShapeStore.hpp"
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "util/ScopeExit.hxx"
 
+#ifdef ENABLE_OPENGL
+#include "Geo/FAISphere.hpp"
+#endif
+
 #include <zzip/lib.h>
 
 #include <algorithm>
@@ -54,6 +59,9 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
 
 TopographyFile::~TopographyFile() noexcept
 {
+  /* the XShape objects may refer to the ShapeStore */
+  ClearCache();
+
   if (dir != nullptr) {
     --dir->refcount;
     zzip_dir_free(dir);
@@ -84,6 +92,89 @@ LoadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
   return std::make_unique<XShape>(shape, center, label);
 }
 
+/**
+ * The minimum point distances of all thinning levels which are
+ * (going to be) stored in the #ShapeStore.
+ */
+[[gnu::pure]]
+static std::array<float, ShapeStore::THINNING_LEVELS>
+GetStoreMinimumDistance([[maybe_unused]] const TopographyFile &file,
+                        [[maybe_unused]] unsigned pixel_scale) noexcept
+{
+  std::array<float, ShapeStore::THINNING_LEVELS> result{};
+
+#ifdef ENABLE_OPENGL
+  static_assert(ShapeStore::THINNING_LEVELS == XShape::THINNING_LEVELS);
+
+  for (unsigned level = 0; level < result.size(); ++level)
+    result[level] = file.GetMinimumShapeDistance(level, pixel_scale);
+#endif
+
+  return result;
+}
+
+void
+TopographyFile::SaveStore(BufferedOutputStream &os,
+                          [[maybe_unused]] unsigned pixel_scale)
+{
+  ShapeStoreWriter writer{os};
+#ifdef ENABLE_OPENGL
+  writer.SetMinimumDistance(GetStoreMinimumDistance(*this, pixel_scale));
+#endif
+
+  for (std::size_t i = 0; i < file.size(); ++i)
+    writer.Add(*::LoadShape(file, center, i, label_field));
+
+  writer.Finish(ImportRect(file.GetBounds()));
+}
+
+void
+TopographyFile::AttachStore(std::unique_ptr<ShapeStore> &&_store,
+                            unsigned pixel_scale)
+{
+  assert(_store != nullptr);
+  assert(list.empty());
+
+  if (_store->size() != file.size())
+    throw std::runtime_error{"Wrong number of shapes in topography store"};
+
+  const auto file_bounds = ImportRect(file.GetBounds());
+  if (_store->GetBounds().GetNorthWest() != file_bounds.GetNorthWest() ||
+      _store->GetBounds().GetSouthEast() != file_bounds.GetSouthEast())
+    throw std::runtime_error{"Wrong bounds in topography store"};
+
+  if (_store->GetMinimumDistance() != GetStoreMinimumDistance(*this, pixel_scale))
+    throw std::runtime_error{"Wrong thinning parameters in topography store"};
+
+  ClearCache();
+  store_status.ResizeDiscard(_store->size());
+  store = std::move(_store);
+  cache_bounds = GeoBounds::Invalid();
+}
+
+inline std::unique_ptr<XShape>
+TopographyFile::LoadShape(std::size_t i)
+{
+  if (store != nullptr)
+    return std::make_unique<XShape>(*store, i);
+
+  return ::LoadShape(file, center, i, label_field);
+}
+
+/**
+ * Look up the shapes within the given rectangle in the
+ * #ShapeStore.
+ *
+ * @return false if the rectangle is outside of the file
+ */
+static bool
+FindShapes(const ShapeStore &store, std::span<bool> status,
+           const GeoBounds &bounds) noexcept
+{
+  std::fill(status.begin(), status.end(), false);
+  return store.FindShapes(bounds, status);
+}
+
 bool
 TopographyFile::Update(const WindowProjection &map_projection)
 {
@@ -99,29 +190,40 @@ TopographyFile::Update(const WindowProjection &map_projection)
 
   cache_bounds = screenRect.Scale(2);
 
-  // Test which shapes are inside the given bounds and save the
-  // status to file.status
-  switch (file.WhichShapes(dir, ConvertRect(cache_bounds))) {
-  case MS_FAILURE:
-    ClearCache();
-    throw std::runtime_error{"Failed to update shapefile"};
-
-  case MS_DONE:
-    /* screen is outside of map bounds */
-    return false;
+  ms_const_bitarray status = nullptr;
+  if (store != nullptr) {
+    if (!FindShapes(*store, store_status, cache_bounds))
+      /* screen is outside of map bounds */
+      return false;
+  } else {
+    // Test which shapes are inside the given bounds and save the
+    // status to file.status
+    switch (file.WhichShapes(dir, ConvertRect(cache_bounds))) {
+    case MS_FAILURE:
+      ClearCache();
+      throw std::runtime_error{"Failed to update shapefile"};
+
+    case MS_DONE:
+      /* screen is outside of map bounds */
+      return false;
+
+    case MS_SUCCESS:
+      break;
+    }
 
-  case MS_SUCCESS:
-    break;
+    status = file.GetStatus();
+    assert(status != nullptr);
   }
 
-  const auto status = file.GetStatus();
-  assert(status != nullptr);
+  const auto is_selected = [this, status](std::size_t i) noexcept {
+    return store != nullptr ? store_status[i] : msGetBit(status, i);
+  };
 
   // Iterate through the shapefile entries
   auto prev = list.before_begin();
   auto it = shapes.begin();
   for (std::size_t i = 0; i < file.size(); ++i, ++it) {
-    if (!msGetBit(status, i)) {
+    if (!is_selected(i)) {
       // If the shape is outside the bounds
       // delete the shape from the cache
       if (it->shape != nullptr) {
@@ -144,7 +246,7 @@ TopographyFile::Update(const WindowProjection &map_projection)
         assert(&*std::next(prev) != &*it);
 
         // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(file, center, i, label_field);
+        it->shape = LoadShape(i);
 
         /* insert into linked list (protected) */
         {
@@ -174,7 +276,7 @@ TopographyFile::LoadAll()
     if (it->shape == nullptr) {
       assert(&*std::next(prev) != &*it);
       // shape isn't cached yet -> cache the shape
-      it->shape = LoadShape(file, center, i, label_field);
+      it->shape = LoadShape(i);
       // update list pointer
       prev = list.insert_after(prev, *it);
     } else {
@@ -229,4 +331,12 @@ TopographyFile::GetMinimumPointDistance(unsigned level) const noexcept
   return 1;
 }
 
+ShapeScalar
+TopographyFile::GetMinimumShapeDistance(unsigned level,
+                                        unsigned pixel_scale) const noexcept
+{
+  return ShapeScalar(GetMinimumPointDistance(level))
+    / (pixel_scale * FAISphere::REARTH);
+}
+
 #endif
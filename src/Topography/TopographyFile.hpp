@@ -21,6 +21,8 @@
 
 class WindowProjection;
 class XShape;
+class ShapeStore;
+class BufferedOutputStream;
 struct zzip_dir;
 
 class TopographyFile {
@@ -44,6 +46,19 @@ class TopographyFile {
 
   AllocatedArray<ShapeEnvelope> shapes;
 
+  /**
+   * The compiled copy of this shapefile (see AttachStore()).  If
+   * this is set, shapes are looked up in this object instead of
+   * being loaded from #file.
+   */
+  std::unique_ptr<ShapeStore> store;
+
+  /**
+   * The result of ShapeStore::FindShapes(), one element per shape.
+   * Only allocated if #store is set.
+   */
+  AllocatedArray<bool> store_status;
+
   using ShapeList = IntrusiveForwardList<ShapeEnvelope>;
   ShapeList list;
 
@@ -92,9 +107,26 @@ public:
 
     ShapeList::const_iterator i;
 
-    constexpr const_iterator(ShapeList::const_iterator _i) noexcept:i(_i) {}
+    /**
+     * The first element of TopographyFile::shapes; used by
+     * GetIndex().
+     */
+    const ShapeEnvelope *base;
+
+    constexpr const_iterator(ShapeList::const_iterator _i,
+                             const ShapeEnvelope *_base) noexcept
+      :i(_i), base(_base) {}
 
   public:
+    /**
+     * Returns the number of the current shape within the shapefile.
+     * It identifies the shape even after it has been unloaded and
+     * loaded again.
+     */
+    std::size_t GetIndex() const noexcept {
+      return &*i - base;
+    }
+
     const_iterator &operator++() {
       ++i;
       return *this;
@@ -214,11 +246,11 @@ public:
   }
 
   const_iterator begin() const noexcept {
-    return const_iterator{list.begin()};
+    return const_iterator{list.begin(), shapes.data()};
   }
 
   const_iterator end() const noexcept {
-    return const_iterator{list.end()};
+    return const_iterator{list.end(), shapes.data()};
   }
 
   [[gnu::pure]]
@@ -242,8 +274,50 @@ public:
    */
   [[gnu::pure]]
   unsigned GetMinimumPointDistance(unsigned level) const noexcept;
+
+  /**
+   * Convert GetMinimumPointDistance() to the units of #ShapePoint,
+   * for XShape::GetIndices().
+   *
+   * @param pixel_scale the value of Layout::Scale(1)
+   */
+  [[gnu::pure]]
+  ShapeScalar GetMinimumShapeDistance(unsigned level,
+                                      unsigned pixel_scale) const noexcept;
 #endif
 
+  /**
+   * Write a #ShapeStore containing all shapes of this file.  This
+   * is slow, because all shapes are loaded and (on OpenGL) all
+   * thinning levels are computed.
+   *
+   * Throws on error.
+   *
+   * @param pixel_scale the value of Layout::Scale(1) (used for the
+   * thinning levels)
+   */
+  void SaveStore(BufferedOutputStream &os, unsigned pixel_scale);
+
+  /**
+   * Use the given #ShapeStore instead of reading shapes from the
+   * shapefile.  This must be called before the first Update().
+   *
+   * Throws if the #ShapeStore does not match this file (e.g. because
+   * it was generated from a different file or with a different
+   * display scale).
+   *
+   * @param pixel_scale the value of Layout::Scale(1)
+   */
+  void AttachStore(std::unique_ptr<ShapeStore> &&_store,
+                   unsigned pixel_scale);
+
+  /**
+   * Is a #ShapeStore attached (see AttachStore())?
+   */
+  bool HasStore() const noexcept {
+    return store != nullptr;
+  }
+
   /**
    * Throws on error.
    *
@@ -260,4 +334,10 @@ public:
 
 protected:
   void ClearCache() noexcept;
+
+private:
+  /**
+   * Throws on error.
+   */
+  std::unique_ptr<XShape> LoadShape(std::size_t i);
 };
@@ -14,7 +14,6 @@
 #include "util/AllocatedArray.hxx"
 #include "util/tstring.hpp"
 #include "Geo/GeoClip.hpp"
-#include "Geo/FAISphere.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "ui/canvas/opengl/VertexPointer.hpp"
@@ -61,8 +60,13 @@ TopographyFileRenderer::UpdateVisibleShapes(const WindowProjection &projection)
   visible_shapes.clear();
   visible_points.clear();
   visible_labels.clear();
+#ifdef ENABLE_OPENGL
+  visible_indices.clear();
+  ++visible_generation;
+#endif
 
-  for (const XShape &shape : file) {
+  for (auto i = file.begin(), end = file.end(); i != end; ++i) {
+    const XShape &shape = *i;
     if (!visible_bounds.Overlaps(shape.get_bounds()))
       continue;
 
@@ -81,8 +85,12 @@ TopographyFileRenderer::UpdateVisibleShapes(const WindowProjection &projection)
             }
           }
         }
-      } else
+      } else {
         visible_shapes.push_back(&shape);
+#ifdef ENABLE_OPENGL
+        visible_indices.push_back(i.GetIndex());
+#endif
+      }
     }
 
     if (shape.GetLabel() != nullptr)
@@ -92,38 +100,309 @@ TopographyFileRenderer::UpdateVisibleShapes(const WindowProjection &projection)
 
 #ifdef ENABLE_OPENGL
 
+/**
+ * The minimum capacity of the vertex buffer (in #ShapePoint units).
+ */
+static constexpr unsigned MIN_ARRAY_CAPACITY = 4096;
+
+/**
+ * The number of vertices which can be addressed by one #DrawBatch
+ * (with GLushort indices).
+ */
+static constexpr unsigned MAX_BATCH_VERTICES = 0x10000;
+
+[[gnu::pure]]
+static unsigned
+CountPoints(const XShape &shape) noexcept
+{
+  const auto lines = shape.GetLines();
+  return std::accumulate(lines.begin(), lines.end(), 0U);
+}
+
+inline void
+TopographyFileRenderer::RebuildArrayBuffer() noexcept
+{
+  unsigned n = 0;
+  for (const auto &shape : file)
+    n += CountPoints(shape);
+
+  /* leave room for shapes which will be loaded later */
+  const unsigned capacity = std::max(2 * n, MIN_ARRAY_CAPACITY);
+  array_allocator.Reset(capacity);
+  shape_offsets.clear();
+
+  ShapePoint *const p = (ShapePoint *)
+    array_buffer->BeginWrite(capacity * sizeof(*p));
+  assert(p != nullptr);
+
+  for (auto i = file.begin(), end = file.end(); i != end; ++i) {
+    const unsigned n_points = CountPoints(*i);
+    if (n_points == 0)
+      continue;
+
+    const unsigned offset = array_allocator.Allocate(n_points);
+    assert(offset != RangeAllocator::NONE);
+
+    shape_offsets.emplace(i.GetIndex(), offset);
+    std::copy_n(i->GetPoints(), n_points, p + offset);
+  }
+
+  array_buffer->CommitWrite(capacity * sizeof(*p), p);
+
+  array_buffer_serial = file.GetSerial();
+  ++array_generation;
+}
+
 inline void
 TopographyFileRenderer::UpdateArrayBuffer() noexcept
 {
-  if (array_buffer == nullptr)
+  if (array_buffer == nullptr) {
     array_buffer = std::make_unique<GLArrayBuffer>();
-  else if (file.GetSerial() == array_buffer_serial)
+    RebuildArrayBuffer();
+    return;
+  }
+
+  if (file.GetSerial() == array_buffer_serial)
     return;
 
   array_buffer_serial = file.GetSerial();
 
-  unsigned n = 0;
-  for (auto &shape : file) {
-    shape.SetOffset(n);
+  struct NewShape {
+    const XShape *shape;
+    std::size_t index;
+    unsigned n_points, offset;
+  };
+
+  std::vector<NewShape> new_shapes;
+
+  /* move the offsets of all shapes which are still loaded to a new
+     map; the remaining ones belong to unloaded shapes */
+  std::unordered_map<std::size_t, unsigned> offsets;
+  offsets.reserve(shape_offsets.size());
+
+  for (auto i = file.begin(), end = file.end(); i != end; ++i) {
+    const std::size_t index = i.GetIndex();
+    if (auto j = shape_offsets.find(index); j != shape_offsets.end()) {
+      offsets.emplace(index, j->second);
+      shape_offsets.erase(j);
+    } else if (const unsigned n_points = CountPoints(*i); n_points > 0)
+      new_shapes.push_back({&*i, index, n_points, 0});
+  }
 
-    const auto lines = shape.GetLines();
-    n = std::accumulate(lines.begin(), lines.end(), n);
+  for (const auto &i : shape_offsets)
+    array_allocator.Free(i.second);
+
+  shape_offsets = std::move(offsets);
+
+  if (new_shapes.empty())
+    return;
+
+  for (auto &i : new_shapes) {
+    i.offset = array_allocator.Allocate(i.n_points);
+    if (i.offset == RangeAllocator::NONE) {
+      /* no room left (or too fragmented): start over with a bigger
+         buffer */
+      RebuildArrayBuffer();
+      return;
+    }
+
+    shape_offsets.emplace(i.index, i.offset);
+  }
+
+  ++array_generation;
+
+  /* upload only the new shapes; adjacent ones are combined into one
+     glBufferSubData() call */
+
+  std::sort(new_shapes.begin(), new_shapes.end(),
+            [](const NewShape &a, const NewShape &b){
+              return a.offset < b.offset;
+            });
+
+  array_buffer->Bind();
+
+  std::vector<ShapePoint> run;
+  unsigned run_offset = 0;
+  for (const auto &i : new_shapes) {
+    if (!run.empty() && run_offset + run.size() != i.offset) {
+      GLArrayBuffer::SubData(run_offset * sizeof(ShapePoint),
+                             run.size() * sizeof(ShapePoint), run.data());
+      run.clear();
+    }
+
+    if (run.empty())
+      run_offset = i.offset;
+
+    run.insert(run.end(), i.shape->GetPoints(),
+               i.shape->GetPoints() + i.n_points);
+  }
+
+  GLArrayBuffer::SubData(run_offset * sizeof(ShapePoint),
+                         run.size() * sizeof(ShapePoint), run.data());
+
+  array_buffer->Unbind();
+}
+
+/**
+ * Collects the indices of many shapes into a few #DrawBatch
+ * instances.
+ */
+template<typename DrawBatch>
+class DrawBatchBuilder {
+  std::vector<DrawBatch> &batches;
+  std::vector<GLushort> &indices;
+
+public:
+  DrawBatchBuilder(std::vector<DrawBatch> &_batches,
+                   std::vector<GLushort> &_indices) noexcept
+    :batches(_batches), indices(_indices) {}
+
+  /**
+   * Prepare for adding indices of vertices in the range
+   * [offset, offset+n_vertices).
+   *
+   * @return the value to be added to shape-relative indices
+   */
+  GLushort Begin(GLenum mode, unsigned offset, unsigned n_vertices) noexcept {
+    assert(n_vertices <= MAX_BATCH_VERTICES);
+
+    if (batches.empty() || batches.back().mode != mode ||
+        offset < batches.back().base ||
+        offset + n_vertices - batches.back().base > MAX_BATCH_VERTICES)
+      batches.push_back({mode, offset, unsigned(indices.size()), 0});
+
+    return offset - batches.back().base;
   }
 
-  ShapePoint *p = (ShapePoint *)
-    array_buffer->BeginWrite(n * sizeof(*p));
-  assert (p != nullptr);
+  void Add(GLushort i) noexcept {
+    indices.push_back(i);
+    ++batches.back().count;
+  }
+
+  /**
+   * Append a line strip as separate line segments.
+   */
+  template<typename F>
+  void AddLineStrip(unsigned n, F &&get) noexcept {
+    for (unsigned i = 1; i < n; ++i) {
+      Add(get(i - 1));
+      Add(get(i));
+    }
+  }
+
+  /**
+   * Append a triangle strip, connected to the previous one with
+   * degenerate triangles.
+   */
+  void AddTriangleStrip(GLushort base, const GLushort *src,
+                        unsigned n) noexcept {
+    if (n == 0)
+      return;
+
+    if (batches.back().count > 0) {
+      Add(indices.back());
+      Add(base + src[0]);
+    }
+
+    for (unsigned i = 0; i < n; ++i)
+      Add(base + src[i]);
+  }
+};
+
+inline void
+TopographyFileRenderer::UpdateIndexBuffer(unsigned level,
+                                          ShapeScalar min_distance) noexcept
+{
+  if (index_buffer != nullptr &&
+      index_visible_generation == visible_generation &&
+      index_array_generation == array_generation &&
+      index_level == level)
+    return;
 
-  for (const auto &shape : file) {
+  index_visible_generation = visible_generation;
+  index_array_generation = array_generation;
+  index_level = level;
+
+  /* sort by type and offset to get as few batches as possible */
+  struct Item {
+    const XShape *shape;
+    unsigned offset;
+  };
+
+  std::vector<Item> items;
+  items.reserve(visible_shapes.size());
+  for (std::size_t i = 0; i < visible_shapes.size(); ++i)
+    if (auto j = shape_offsets.find(visible_indices[i]);
+        j != shape_offsets.end())
+      items.push_back({visible_shapes[i], j->second});
+
+  std::sort(items.begin(), items.end(), [](const Item &a, const Item &b){
+    return a.shape->get_type() != b.shape->get_type()
+      ? a.shape->get_type() < b.shape->get_type()
+      : a.offset < b.offset;
+  });
+
+  batches.clear();
+  std::vector<GLushort> indices;
+  DrawBatchBuilder builder{batches, indices};
+
+  for (const auto &item : items) {
+    const XShape &shape = *item.shape;
     const auto lines = shape.GetLines();
-    const ShapePoint *src = shape.GetPoints();
-    for (const auto n_points : lines) {
-      p = std::copy_n(src, n_points, p);
-      src += n_points;
+    const unsigned n_points = CountPoints(shape);
+
+    switch (shape.get_type()) {
+    case MS_SHAPE_NULL:
+    case MS_SHAPE_POINT:
+      break;
+
+    case MS_SHAPE_LINE:
+      if (XShape::Indices thinned;
+          level > 0 && n_points <= MAX_BATCH_VERTICES &&
+          (thinned = shape.GetIndices(level, min_distance)).indices != nullptr) {
+        const GLushort base = builder.Begin(GL_LINES, item.offset, n_points);
+        for (const unsigned n : std::span{thinned.count, lines.size()}) {
+          builder.AddLineStrip(n, [base, src = thinned.indices](unsigned i){
+            return GLushort(base + src[i]);
+          });
+          thinned.indices += n;
+        }
+      } else {
+        unsigned offset = item.offset;
+        for (const unsigned n : lines) {
+          const GLushort base = builder.Begin(GL_LINES, offset, n);
+          builder.AddLineStrip(n, [base](unsigned i){
+            return GLushort(base + i);
+          });
+          offset += n;
+        }
+      }
+
+      break;
+
+    case MS_SHAPE_POLYGON:
+      if (n_points <= MAX_BATCH_VERTICES) {
+        const auto triangles = shape.GetIndices(level, min_distance);
+        if (triangles.indices == nullptr)
+          break;
+
+        const GLushort base =
+          builder.Begin(GL_TRIANGLE_STRIP, item.offset, n_points);
+        builder.AddTriangleStrip(base, triangles.indices, *triangles.count);
+      }
+
+      break;
     }
   }
 
-  array_buffer->CommitWrite(n * sizeof(*p), p - n);
+  /* remove batches which have received no indices */
+  std::erase_if(batches, [](const DrawBatch &b){ return b.count == 0; });
+
+  if (index_buffer == nullptr)
+    index_buffer = std::make_unique<GLElementArrayBuffer>();
+
+  index_buffer->Load(indices.size() * sizeof(indices.front()),
+                     indices.data());
 }
 
 #endif
@@ -155,11 +434,20 @@ TopographyFileRenderer::Paint(Canvas &canvas,
     return;
 
 #ifdef ENABLE_OPENGL
-  OpenGL::solid_shader->Use();
+  const unsigned level = file.GetThinningLevel(map_scale);
+  const ShapeScalar min_distance =
+    file.GetMinimumShapeDistance(level, Layout::Scale(1));
 
   UpdateArrayBuffer();
+  UpdateIndexBuffer(level, min_distance);
+
+  if (batches.empty())
+    return;
+
+  OpenGL::solid_shader->Use();
+
   array_buffer->Bind();
-  const ShapePoint *const buffer = nullptr;
+  index_buffer->Bind();
 
   pen.Bind();
 
@@ -167,45 +455,45 @@ TopographyFileRenderer::Paint(Canvas &canvas,
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   }
-#else
-  shape_renderer.Configure(&pen, &brush);
-#endif
 
-  // get drawing info
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(ToGLM(projection, file.GetCenter())));
 
-#ifdef ENABLE_OPENGL
-  const unsigned level = file.GetThinningLevel(map_scale);
-  const ShapeScalar min_distance =
-    ShapeScalar(file.GetMinimumPointDistance(level))
-    / (Layout::Scale(1) * FAISphere::REARTH);
+  /* both buffers are bound, so these "pointers" are offsets */
+  const ShapePoint *const buffer = nullptr;
+  const GLushort *const indices = nullptr;
+
+  ScopeVertexPointer vp;
+  for (const auto &batch : batches) {
+    vp.Update(GL_FLOAT, buffer + batch.base);
+    glDrawElements(batch.mode, batch.count, GL_UNSIGNED_SHORT,
+                   indices + batch.start);
+  }
 
   glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
-                     glm::value_ptr(ToGLM(projection, file.GetCenter())));
+                     glm::value_ptr(glm::mat4(1)));
+  if (!pen.GetColor().IsOpaque())
+    glDisable(GL_BLEND);
+
+  pen.Unbind();
+
+  index_buffer->Unbind();
+  array_buffer->Unbind();
 #else // !ENABLE_OPENGL
+  shape_renderer.Configure(&pen, &brush);
+
+  // get drawing info
+
   const GeoClip clip(projection.GetScreenBounds().Scale(1.1));
   AllocatedArray<GeoPoint> geo_points;
 
   const unsigned iskip = file.GetSkipSteps(map_scale);
-#endif
-
-#ifdef ENABLE_OPENGL
-  ScopeVertexPointer vp;
-
-#ifdef GL_EXT_multi_draw_arrays
-  std::vector<GLsizei> polygon_counts;
-  std::vector<GLushort> polygon_indices;
-#endif
-#endif
 
   for (const XShape *shape_p : visible_shapes) {
     const XShape &shape = *shape_p;
 
     const auto lines = shape.GetLines();
-#ifdef ENABLE_OPENGL
-    const ShapePoint *points = buffer + shape.GetOffset();
-#else // !ENABLE_OPENGL
     const GeoPoint *points = shape.GetPoints();
-#endif
 
     switch (shape.get_type()) {
     case MS_SHAPE_NULL:
@@ -213,27 +501,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
       break;
 
     case MS_SHAPE_LINE:
-      {
-#ifdef ENABLE_OPENGL
-        vp.Update(GL_FLOAT, points);
-
-        XShape::Indices indices;
-        if (level == 0 ||
-            (indices = shape.GetIndices(level, min_distance)).indices == nullptr) {
-          unsigned offset = 0;
-          for (unsigned n : lines) {
-            glDrawArrays(GL_LINE_STRIP, offset, n);
-            offset += n;
-          }
-        } else {
-          for (unsigned n : std::span<const GLushort>{indices.count, lines.size()}) {
-            glDrawElements(GL_LINE_STRIP, n, GL_UNSIGNED_SHORT,
-                           indices.indices);
-            indices.indices += n;
-          }
-        }
-#else // !ENABLE_OPENGL
-        for (unsigned msize : lines) {
+      for (unsigned msize : lines) {
         shape_renderer.Begin(msize);
 
         const GeoPoint *end = points + msize - 1;
@@ -245,35 +513,9 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 
         shape_renderer.FinishPolyline(canvas);
       }
-#endif
-      }
       break;
 
     case MS_SHAPE_POLYGON:
-#ifdef ENABLE_OPENGL
-      {
-        const auto triangles = shape.GetIndices(level, min_distance);
-        const unsigned n = *triangles.count;
-
-#ifdef GL_EXT_multi_draw_arrays
-        const unsigned offset = shape.GetOffset();
-        if (GLExt::HaveMultiDrawElements() && offset + n < 0x10000) {
-          /* postpone, draw many polygons with a single
-             glMultiDrawElements() call */
-          polygon_counts.push_back(n);
-          const size_t size = polygon_indices.size();
-          polygon_indices.resize(size + n, offset);
-          for (unsigned i = 0; i < n; ++i)
-            polygon_indices[size + i] += triangles.indices[i];
-          break;
-        }
-#endif
-
-        vp.Update(GL_FLOAT, points);
-        glDrawElements(GL_TRIANGLE_STRIP, n, GL_UNSIGNED_SHORT,
-                       triangles.indices);
-      }
-#else // !ENABLE_OPENGL
       {
         const GeoPoint *src = &points[0];
         for (const unsigned n : lines) {
@@ -304,41 +546,10 @@ TopographyFileRenderer::Paint(Canvas &canvas,
           src += n;
         }
       }
-#endif
       break;
     }
   }
-#ifdef ENABLE_OPENGL
-
-#ifdef GL_EXT_multi_draw_arrays
-  if (!polygon_indices.empty()) {
-    assert(GLExt::HaveMultiDrawElements());
-
-    std::vector<const GLushort *> polygon_pointers;
-    unsigned i = 0;
-    for (auto count : polygon_counts) {
-      polygon_pointers.push_back(polygon_indices.data() + i);
-      i += count;
-    }
-
-    vp.Update(GL_FLOAT, buffer);
-
-    GLExt::MultiDrawElements(GL_TRIANGLE_STRIP, polygon_counts.data(),
-                             GL_UNSIGNED_SHORT,
-                             (const GLvoid **)polygon_pointers.data(),
-                             polygon_counts.size());
-  }
-#endif
-
-  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
-                     glm::value_ptr(glm::mat4(1)));
-  if (!pen.GetColor().IsOpaque())
-    glDisable(GL_BLEND);
-
-  pen.Unbind();
 
-  array_buffer->Unbind();
-#else
   shape_renderer.Commit();
 #endif
 }
@@ -9,17 +9,22 @@
 #include "Geo/GeoBounds.hpp"
 
 #ifdef ENABLE_OPENGL
+#include "Topography/RangeAllocator.hpp"
+#include "Topography/XShapePoint.hpp"
 #else
 #include "ui/canvas/Brush.hpp"
 #include "Topography/ShapeRenderer.hpp"
 #endif
 
+#include <cstddef>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class TopographyFile;
 class Canvas;
 class GLArrayBuffer;
+class GLElementArrayBuffer;
 class WindowProjection;
 class LabelBlock;
 class XShape;
@@ -55,8 +60,77 @@ class TopographyFileRenderer final
   std::vector<GeoPoint> visible_points;
 
 #ifdef ENABLE_OPENGL
+  /**
+   * The TopographyFile::const_iterator::GetIndex() value of each
+   * #visible_shapes element.
+   */
+  std::vector<std::size_t> visible_indices;
+
+  /**
+   * Incremented each time #visible_shapes is rebuilt.
+   */
+  unsigned visible_generation = 0;
+
+  /**
+   * The points of all loaded shapes.  Shapes are appended when they
+   * get loaded, and their ranges are freed when they get unloaded;
+   * the buffer is only rebuilt from scratch when there is no room
+   * left.
+   */
   std::unique_ptr<GLArrayBuffer> array_buffer;
   Serial array_buffer_serial;
+
+  /**
+   * Manages the space in #array_buffer (in #ShapePoint units).
+   */
+  RangeAllocator array_allocator;
+
+  /**
+   * Maps TopographyFile::const_iterator::GetIndex() of each loaded
+   * shape to its offset in #array_buffer.  This is not stored in
+   * the #XShape, because several renderers (i.e. map windows) may
+   * draw the same #TopographyFile.
+   */
+  std::unordered_map<std::size_t, unsigned> shape_offsets;
+
+  /**
+   * Incremented each time a shape gets a new offset in
+   * #array_buffer.
+   */
+  unsigned array_generation = 0;
+
+  /**
+   * A range of #index_buffer which is drawn with one
+   * glDrawElements() call.
+   */
+  struct DrawBatch {
+    /**
+     * The OpenGL primitive type.
+     */
+    unsigned mode;
+
+    /**
+     * The first vertex in #array_buffer; the indices are relative
+     * to it, because they are only 16 bit.
+     */
+    unsigned base;
+
+    /**
+     * The range within #index_buffer.
+     */
+    unsigned start, count;
+  };
+
+  /**
+   * The indices of all visible shapes, grouped into #batches.  It
+   * is rebuilt when the visible shapes, their offsets or the
+   * thinning level change.
+   */
+  std::unique_ptr<GLElementArrayBuffer> index_buffer;
+  std::vector<DrawBatch> batches;
+
+  unsigned index_visible_generation, index_array_generation;
+  unsigned index_level;
 #endif
 
 public:
@@ -89,7 +163,9 @@ private:
   void UpdateVisibleShapes(const WindowProjection &projection) noexcept;
 
 #ifdef ENABLE_OPENGL
+  void RebuildArrayBuffer() noexcept;
   void UpdateArrayBuffer() noexcept;
+  void UpdateIndexBuffer(unsigned level, ShapeScalar min_distance) noexcept;
 #endif
 
   void PaintPoints(Canvas &canvas, const WindowProjection &projection) noexcept;
@@ -11,19 +11,35 @@
 #include "io/ZipLineReader.hpp"
 #include "system/Path.hpp"
 
+#ifdef ENABLE_OPENGL
+#include "Screen/Layout.hpp"
+#endif
+
 /**
  * Load topography from the map file (ZIP), load the other files from
  * the same ZIP file.
  */
 static bool
-LoadConfiguredTopographyZip(TopographyStore &store)
+LoadConfiguredTopographyZip(TopographyStore &store, FileCache *cache)
 try {
   auto archive = OpenMapFile();
   if (!archive)
     return false;
 
+  const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+  if (map_path == nullptr)
+    cache = nullptr;
+
+#ifdef ENABLE_OPENGL
+  /* the thinning levels depend on the display resolution */
+  const unsigned pixel_scale = Layout::Scale(1);
+#else
+  const unsigned pixel_scale = 1;
+#endif
+
   ZipLineReaderA reader(archive->get(), "topology.tpl");
-  store.Load(reader, nullptr, archive->get());
+  store.Load(reader, nullptr, archive->get(),
+             cache, map_path, pixel_scale);
   return true;
 } catch (...) {
   LogError(std::current_exception(), "No topography in map file");
@@ -31,7 +47,7 @@ try {
 }
 
 bool
-LoadConfiguredTopography(TopographyStore &store)
+LoadConfiguredTopography(TopographyStore &store, FileCache *cache)
 {
-  return LoadConfiguredTopographyZip(store);
+  return LoadConfiguredTopographyZip(store, cache);
 }
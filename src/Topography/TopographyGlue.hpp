@@ -4,6 +4,11 @@
 #pragma once
 
 class TopographyStore;
+class FileCache;
 
+/**
+ * @param cache if not nullptr, then the compiled layers are stored
+ * in (and loaded from) this cache
+ */
 bool
-LoadConfiguredTopography(TopographyStore &store);
+LoadConfiguredTopography(TopographyStore &store, FileCache *cache=nullptr);
@@ -2,17 +2,25 @@
 // Copyright The XCSoar Project
 
 #include "Topography/TopographyStore.hpp"
+#include "Topography/ShapeStore.hpp"
 #include "Index.hpp"
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
+#include "util/tstring.hpp"
 #include "io/LineReader.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "system/ConvertPathName.hpp"
 #include "system/Path.hpp"
 #include "Operation/Operation.hpp"
 #include "Compatibility/path.h"
 #include "LogFile.hpp"
 
+#include <cassert>
 #include <cstdint>
+#include <string_view>
 
 #include <windef.h> // for MAX_PATH
 
@@ -65,10 +73,86 @@ TopographyStore::LoadAll() noexcept
     i.LoadAll();
 }
 
+/**
+ * Build the #FileCache name of a layer.  Characters which may not
+ * be safe in a file name are replaced.
+ */
+static tstring
+MakeShapeStoreCacheName(std::string_view name) noexcept
+{
+  tstring result{_T("topography-")};
+  for (const char ch : name)
+    result.push_back((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+                     (ch >= '0' && ch <= '9') || ch == '-' || ch == '_'
+                     ? TCHAR(ch)
+                     : _T('_'));
+  return result;
+}
+
+static bool
+OpenShapeStore(TopographyFile &file, FileCache &cache,
+               const TCHAR *cache_name, Path cache_path,
+               unsigned pixel_scale)
+{
+  auto mapping = cache.Map(cache_name, cache_path);
+  if (!mapping)
+    return false;
+
+  file.AttachStore(std::make_unique<ShapeStore>(std::move(mapping)),
+                   pixel_scale);
+  return true;
+}
+
+static void
+SaveShapeStore(TopographyFile &file, FileCache &cache,
+               const TCHAR *cache_name, Path cache_path,
+               unsigned pixel_scale)
+{
+  auto os = cache.Save(cache_name, cache_path);
+  BufferedOutputStream bos(*os);
+  file.SaveStore(bos, pixel_scale);
+  bos.Flush();
+  os->Commit();
+}
+
+/**
+ * Use the compiled #ShapeStore of this layer from the cache; if
+ * there is none (or it is stale), generate it.  Errors are logged,
+ * and the layer falls back to reading the shapefile.
+ */
+static void
+LoadShapeStore(TopographyFile &file, FileCache &cache,
+               const TCHAR *cache_name, Path cache_path,
+               unsigned pixel_scale) noexcept
+{
+  try {
+    if (OpenShapeStore(file, cache, cache_name, cache_path, pixel_scale))
+      return;
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to open topography store");
+  }
+
+  /* this loads and converts all shapes once; following runs map the
+     result without decoding anything */
+
+  try {
+    SaveShapeStore(file, cache, cache_name, cache_path, pixel_scale);
+    if (!OpenShapeStore(file, cache, cache_name, cache_path, pixel_scale))
+      LogString("Topography store does not match");
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save topography store");
+    cache.Flush(cache_name);
+  }
+}
+
 void
 TopographyStore::Load(NLineReader &reader,
-                      Path directory, struct zzip_dir *zdir) noexcept
+                      Path directory, struct zzip_dir *zdir,
+                      FileCache *cache, Path cache_path,
+                      unsigned pixel_scale) noexcept
 {
+  assert(cache == nullptr || cache_path != nullptr);
+
   Reset();
 
   // Create buffer for the shape filenames
@@ -111,7 +195,13 @@ TopographyStore::Load(NLineReader &reader,
                               entry->pen_width);
     } catch (...) {
       LogError(std::current_exception());
+      continue;
     }
+
+    if (cache != nullptr)
+      LoadShapeStore(*i, *cache,
+                     MakeShapeStoreCacheName(entry->name).c_str(),
+                     cache_path, pixel_scale);
   }
 }
 
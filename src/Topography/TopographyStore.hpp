@@ -4,11 +4,12 @@
 #pragma once
 
 #include "TopographyFile.hpp"
+#include "system/Path.hpp"
 #include "util/NonCopyable.hpp"
 
 #include <forward_list>
 
-class Path;
+class FileCache;
 class WindowProjection;
 class NLineReader;
 struct zzip_dir;
@@ -64,7 +65,17 @@ public:
    */
   void LoadAll() noexcept;
 
+  /**
+   * @param cache if not nullptr, then each layer is compiled to a
+   * #ShapeStore (once) and used from the cache
+   * @param cache_path the file which the cache depends on (i.e. the
+   * map file); required if #cache is set
+   * @param pixel_scale the value of Layout::Scale(1), which
+   * determines the thinning levels stored in the cache
+   */
   void Load(NLineReader &reader,
-            Path directory, struct zzip_dir *zdir = nullptr) noexcept;
+            Path directory, struct zzip_dir *zdir = nullptr,
+            FileCache *cache = nullptr, Path cache_path = nullptr,
+            unsigned pixel_scale = 1) noexcept;
   void Reset() noexcept;
 };
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "Topography/XShape.hpp"
+#include "Topography/ShapeStore.hpp"
 #include "Convert.hpp"
 #include "util/Compiler.h"
 #include "util/StringAPI.hxx"
@@ -100,7 +101,8 @@ ImportShapePoint(const pointObj &src, [[maybe_unused]] const GeoPoint &file_cent
 
 XShape::XShape(const shapeObj &shape, const GeoPoint &file_center,
                const char *_label)
-  :label(ImportLabel(_label))
+  :owned_label(ImportLabel(_label)),
+   label(owned_label.c_str())
 {
   bounds = ImportRect(shape.bounds);
   if (!bounds.Check())
@@ -113,6 +115,7 @@ XShape::XShape(const shapeObj &shape, const GeoPoint &file_center,
   const int min_points = GetMinPointsForShapeType(shape.type);
   if (min_points < 0) {
     /* not supported, leave an empty XShape object */
+    points = nullptr;
     return;
   }
 
@@ -129,8 +132,10 @@ XShape::XShape(const shapeObj &shape, const GeoPoint &file_center,
     ++num_lines;
   }
 
-  points = std::make_unique<Point[]>(num_points);
-  auto *p = points.get();
+  owned_points = std::make_unique<Point[]>(num_points);
+  points = owned_points.get();
+
+  auto *p = owned_points.get();
   for (std::size_t l = 0; l < num_lines; ++l) {
     const pointObj *src = shape.line[l].point;
     p = std::transform(src, src + lines[l], p,
@@ -140,6 +145,24 @@ XShape::XShape(const shapeObj &shape, const GeoPoint &file_center,
   }
 }
 
+XShape::XShape(const ShapeStore &store, std::size_t i) noexcept
+{
+  const auto &shape = store.GetShape(i);
+
+  bounds = shape.bounds;
+  type = shape.type;
+  num_lines = shape.num_lines;
+  std::copy_n(store.GetLines(shape), num_lines, lines.begin());
+  points = store.GetPoints(shape);
+
+#ifdef ENABLE_OPENGL
+  for (unsigned level = 0; level < THINNING_LEVELS; ++level)
+    indices[level] = store.GetIndices(shape, level);
+#endif
+
+  label = store.GetLabel(shape);
+}
+
 XShape::~XShape() noexcept = default;
 
 #ifdef ENABLE_OPENGL
@@ -147,7 +170,7 @@ XShape::~XShape() noexcept = default;
 inline bool
 XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance) noexcept
 {
-  assert(indices[thinning_level] == nullptr);
+  assert(indices[thinning_level].indices == nullptr);
 
   uint16_t *idx, *idx_count;
   std::size_t num_points = 0;
@@ -158,12 +181,13 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance) noexcept
   if (type == MS_SHAPE_LINE) {
     if (num_points <= 2)
       return false;  // line cannot be simplified, so don't create indices
-    index_count[thinning_level] = std::make_unique<GLushort[]>(num_lines + num_points);
-    idx_count = index_count[thinning_level].get();
-    indices[thinning_level] = idx = idx_count + num_lines;
+    owned_indices[thinning_level] = std::make_unique<GLushort[]>(num_lines + num_points);
+    idx_count = owned_indices[thinning_level].get();
+    idx = idx_count + num_lines;
+    indices[thinning_level] = {idx, idx_count};
 
     const auto end_l = std::next(lines.begin(), num_lines);
-    const ShapePoint *p = points.get();
+    const ShapePoint *p = points;
     unsigned i = 0;
     for (auto l = lines.begin(); l != end_l; ++l) {
       assert(*l >= 2);
@@ -188,17 +212,18 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance) noexcept
     // TODO: free memory saved by thinning (use malloc/realloc or some class?)
     return true;
   } else if (type == MS_SHAPE_POLYGON) {
-    index_count[thinning_level] = std::make_unique<GLushort[]>(1 + 3 * (num_points - 2) + 2 * (num_lines - 1));
-    idx_count = index_count[thinning_level].get();
-    indices[thinning_level] = idx = idx_count + 1;
+    owned_indices[thinning_level] = std::make_unique<GLushort[]>(1 + 3 * (num_points - 2) + 2 * (num_lines - 1));
+    idx_count = owned_indices[thinning_level].get();
+    idx = idx_count + 1;
+    indices[thinning_level] = {idx, idx_count};
 
     *idx_count = 0;
-    const ShapePoint *pt = points.get();
+    const ShapePoint *pt = points;
     for (std::size_t i=0; i < num_lines; i++) {
       std::size_t count = PolygonToTriangles(pt, lines[i], idx + *idx_count,
                                              min_distance);
       if (i > 0) {
-        const GLushort offset = pt - points.get();
+        const GLushort offset = pt - points;
         const std::size_t max_idx_count = *idx_count + count;
         for (std::size_t j = *idx_count; j < max_idx_count; j++)
           idx[j] += offset;
@@ -217,13 +242,13 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance) noexcept
 XShape::Indices
 XShape::GetIndices(int thinning_level, ShapeScalar min_distance) const noexcept
 {
-  if (indices[thinning_level] == nullptr) {
+  if (indices[thinning_level].indices == nullptr) {
     XShape &deconst = const_cast<XShape &>(*this);
     if (!deconst.BuildIndices(thinning_level, min_distance))
       return {};
   }
 
-  return {indices[thinning_level], index_count[thinning_level].get()};
+  return indices[thinning_level];
 }
 
 #endif // ENABLE_OPENGL
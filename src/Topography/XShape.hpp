@@ -20,13 +20,27 @@
 #include <tchar.h>
 
 struct GeoPoint;
+class ShapeStore;
 
 class XShape {
+public:
   static constexpr std::size_t MAX_LINES = 32;
 #ifdef ENABLE_OPENGL
   static constexpr std::size_t THINNING_LEVELS = 4;
 #endif
 
+#ifdef ENABLE_OPENGL
+  using Point = ShapePoint;
+
+  struct Indices {
+    const uint16_t *indices;
+    const uint16_t *count;
+  };
+#else
+  using Point = GeoPoint;
+#endif
+
+private:
   GeoBounds bounds;
 
   uint8_t type;
@@ -43,39 +57,41 @@ class XShape {
    */
   std::array<uint16_t, MAX_LINES> lines;
 
-#ifdef ENABLE_OPENGL
-  using Point = ShapePoint;
-#else
-  using Point = GeoPoint;
-#endif
-
   /**
-   * All points of all lines.
+   * All points of all lines.  This points either to #owned_points
+   * or into a #ShapeStore.
    */
-  std::unique_ptr<Point[]> points;
+  const Point *points;
+
+  std::unique_ptr<Point[]> owned_points;
 
 #ifdef ENABLE_OPENGL
   /**
-   * Indices of polygon triangles or lines with reduced number of vertices.
+   * Indices of polygon triangles or lines with reduced number of
+   * vertices for each thinning level.
+   *
+   * For polygons, Indices::count points to the total number of
+   * triangle vertices.  For lines, it points to an array of size
+   * num_lines, which contains the number of points for each line.
+   *
+   * These point either to #owned_indices or into a #ShapeStore.
    */
-  std::array<uint16_t *, THINNING_LEVELS> indices{};
+  std::array<Indices, THINNING_LEVELS> indices{};
 
   /**
-   * For polygons this will contain the total number of triangle vertices
-   * for each thinning level.
-   * For lines there will be an array of size num_lines for each thinning
-   * level, which contains the number of points for each line.
+   * Buffers allocated by BuildIndices(): the "count" array followed
+   * by the indices.
    */
-  std::array<std::unique_ptr<uint16_t[]>, THINNING_LEVELS> index_count;
+  std::array<std::unique_ptr<uint16_t[]>, THINNING_LEVELS> owned_indices;
+#endif
+
+  BasicAllocatedString<TCHAR> owned_label;
 
   /**
-   * The start offset in the #GLArrayBuffer (vertex buffer object).
-   * It is managed by #TopographyFileRenderer.
+   * The label or nullptr.  This points either to #owned_label or
+   * into a #ShapeStore.
    */
-  mutable unsigned offset;
-#endif
-
-  BasicAllocatedString<TCHAR> label;
+  const TCHAR *label;
 
 public:
   /**
@@ -84,30 +100,24 @@ public:
   XShape(const shapeObj &shape, const GeoPoint &file_center,
          const char *label);
 
+  /**
+   * Construct an instance which refers to the data of shape #i in
+   * the given #ShapeStore (without copying it).  The #ShapeStore
+   * must outlive this object.
+   */
+  XShape(const ShapeStore &store, std::size_t i) noexcept;
+
   ~XShape() noexcept;
 
   XShape(const XShape &) = delete;
   XShape &operator=(const XShape &) = delete;
 
 #ifdef ENABLE_OPENGL
-  void SetOffset(unsigned _offset) const noexcept {
-    offset = _offset;
-  }
-
-  unsigned GetOffset() const noexcept {
-    return offset;
-  }
-
 protected:
   bool BuildIndices(unsigned thinning_level,
                     ShapeScalar min_distance) noexcept;
 
 public:
-  struct Indices {
-    const uint16_t *indices;
-    const uint16_t *count;
-  };
-
   [[gnu::pure]]
   Indices GetIndices(int thinning_level,
                      ShapeScalar min_distance) const noexcept;
@@ -126,10 +136,10 @@ public:
   }
 
   const Point *GetPoints() const noexcept {
-    return points.get();
+    return points;
   }
 
   const TCHAR *GetLabel() const noexcept {
-    return label.c_str();
+    return label;
   }
 };
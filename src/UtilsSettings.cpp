@@ -108,7 +108,8 @@ SettingsLeave(const UISettings &old_ui_settings)
 
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
-    WaypointGlue::LoadWaypoints(way_points, data_components->terrain.get(),
+    WaypointGlue::LoadWaypoints(way_points, file_cache,
+                                data_components->terrain.get(),
                                 operation);
 
     try {
@@ -143,6 +144,9 @@ SettingsLeave(const UISettings &old_ui_settings)
 
     auto &topography = *data_components->topography;
     topography.Reset();
+    /* no FileCache here: compiling the shape stores would block the
+       UI thread for a long time; this will be done on the next
+       start */
     LoadConfiguredTopography(topography);
     main_window.SetTopography(&topography);
   }
@@ -155,7 +159,7 @@ SettingsLeave(const UISettings &old_ui_settings)
 
     auto &airspace_database = *data_components->airspaces;
     airspace_database.Clear();
-    ReadAirspace(airspace_database,
+    ReadAirspace(airspace_database, file_cache,
                  CommonInterface::GetComputerSettings().pressure,
                  operation);
 
@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "WaypointCache.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "io/BufferedReader.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "util/SpanCast.hxx"
+
+#include <bit>
+#include <stdexcept>
+#include <vector>
+
+#include <string.h>
+
+namespace {
+
+struct CacheHeader {
+  /**
+   * Increment this whenever the file format or the parser output
+   * changes.
+   */
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  uint32_t n_waypoints;
+};
+
+/**
+ * Fixed-size part of one waypoint.  It is followed by the four
+ * strings (in the order of the length fields) and #n_files strings
+ * (#n_files_embed of Waypoint::files_embed, then the rest of
+ * Waypoint::files_external), each file name preceded by its length
+ * as uint32_t.
+ */
+struct CacheRecord {
+  enum Flags : uint8_t {
+    TURN_POINT = 0x01,
+    HOME = 0x02,
+    START_POINT = 0x04,
+    FINISH_POINT = 0x08,
+    HAS_ELEVATION = 0x80,
+  };
+
+  GeoPoint location;
+  double elevation;
+
+  uint32_t original_id;
+  uint32_t runway;
+  uint16_t radio_frequency;
+  Waypoint::Type type;
+  uint8_t flags;
+
+  uint32_t shortname_length, name_length, comment_length, details_length;
+  uint32_t n_files_embed, n_files;
+};
+
+static constexpr uint32_t MAX_WAYPOINTS = 1024 * 1024;
+static constexpr uint32_t MAX_STRING_LENGTH = 1024 * 1024;
+static constexpr uint32_t MAX_FILES = 256;
+
+} // anonymous namespace
+
+static bool
+IsValid(const CacheRecord &record) noexcept
+{
+  return record.location.Check() &&
+    record.type <= Waypoint::Type::PGLANDING &&
+    record.shortname_length <= MAX_STRING_LENGTH &&
+    record.name_length <= MAX_STRING_LENGTH &&
+    record.comment_length <= MAX_STRING_LENGTH &&
+    record.details_length <= MAX_STRING_LENGTH &&
+    record.n_files_embed <= record.n_files &&
+    record.n_files <= MAX_FILES;
+}
+
+static void
+WriteString(BufferedOutputStream &os, tstring_view s)
+{
+  os.Write(std::as_bytes(std::span{s}));
+}
+
+static void
+WriteFileName(BufferedOutputStream &os, tstring_view s)
+{
+  const uint32_t length = s.size();
+  os.Write(ReferenceAsBytes(length));
+  WriteString(os, s);
+}
+
+static void
+SaveWaypoint(BufferedOutputStream &os, const Waypoint &wp)
+{
+  CacheRecord record;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(&record, 0, sizeof(record));
+
+  record.location = wp.location;
+  record.elevation = wp.has_elevation ? wp.elevation : 0;
+  record.original_id = wp.original_id;
+  record.runway = std::bit_cast<uint32_t>(wp.runway);
+  record.radio_frequency = std::bit_cast<uint16_t>(wp.radio_frequency);
+  record.type = wp.type;
+
+  if (wp.flags.turn_point)
+    record.flags |= CacheRecord::TURN_POINT;
+  if (wp.flags.home)
+    record.flags |= CacheRecord::HOME;
+  if (wp.flags.start_point)
+    record.flags |= CacheRecord::START_POINT;
+  if (wp.flags.finish_point)
+    record.flags |= CacheRecord::FINISH_POINT;
+  if (wp.has_elevation)
+    record.flags |= CacheRecord::HAS_ELEVATION;
+
+  record.shortname_length = wp.shortname.size();
+  record.name_length = wp.name.size();
+  record.comment_length = wp.comment.size();
+  record.details_length = wp.details.size();
+
+  for ([[maybe_unused]] const auto &i : wp.files_embed)
+    ++record.n_files_embed;
+
+  record.n_files = record.n_files_embed;
+#ifdef HAVE_RUN_FILE
+  for ([[maybe_unused]] const auto &i : wp.files_external)
+    ++record.n_files;
+#endif
+
+  os.Write(ReferenceAsBytes(record));
+  WriteString(os, wp.shortname);
+  WriteString(os, wp.name);
+  WriteString(os, wp.comment);
+  WriteString(os, wp.details);
+
+  for (const auto &i : wp.files_embed)
+    WriteFileName(os, i);
+
+#ifdef HAVE_RUN_FILE
+  for (const auto &i : wp.files_external)
+    WriteFileName(os, i);
+#endif
+}
+
+void
+SaveWaypointCache(BufferedOutputStream &os,
+                  std::span<const WaypointPtr> waypoints)
+{
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = CacheHeader::VERSION;
+  header.n_waypoints = waypoints.size();
+
+  os.Write(ReferenceAsBytes(header));
+
+  for (const auto &i : waypoints)
+    SaveWaypoint(os, *i);
+}
+
+static tstring
+ReadString(BufferedReader &r, std::size_t length)
+{
+  tstring s(length, _T('\0'));
+  r.ReadFull(std::as_writable_bytes(std::span{s}));
+  return s;
+}
+
+static tstring
+ReadFileName(BufferedReader &r)
+{
+  const auto length = r.ReadFullT<uint32_t>();
+  if (length > MAX_STRING_LENGTH)
+    throw std::runtime_error("Malformed waypoint cache file name");
+
+  return ReadString(r, length);
+}
+
+/**
+ * Read the list of file names into the given list, preserving their
+ * order.
+ */
+static void
+ReadFileNames(BufferedReader &r, std::forward_list<InternedString> &dest,
+              std::size_t n)
+{
+  auto position = dest.before_begin();
+  for (std::size_t i = 0; i < n; ++i)
+    position = dest.emplace_after(position, tstring_view{ReadFileName(r)});
+}
+
+static Waypoint
+LoadWaypoint(BufferedReader &r, WaypointOrigin origin)
+{
+  const auto record = r.ReadFullT<CacheRecord>();
+  if (!IsValid(record))
+    throw std::runtime_error("Malformed waypoint cache record");
+
+  Waypoint wp{record.location};
+  wp.origin = origin;
+  wp.original_id = record.original_id;
+  wp.runway = std::bit_cast<Runway>(record.runway);
+  wp.radio_frequency = std::bit_cast<RadioFrequency>(record.radio_frequency);
+  wp.type = record.type;
+
+  wp.flags.turn_point = record.flags & CacheRecord::TURN_POINT;
+  wp.flags.home = record.flags & CacheRecord::HOME;
+  wp.flags.start_point = record.flags & CacheRecord::START_POINT;
+  wp.flags.finish_point = record.flags & CacheRecord::FINISH_POINT;
+
+  wp.has_elevation = record.flags & CacheRecord::HAS_ELEVATION;
+  if (wp.has_elevation)
+    wp.elevation = record.elevation;
+
+  wp.shortname = ReadString(r, record.shortname_length);
+  wp.name = ReadString(r, record.name_length);
+  wp.comment = ReadString(r, record.comment_length);
+  wp.details = ReadString(r, record.details_length);
+
+  ReadFileNames(r, wp.files_embed, record.n_files_embed);
+
+#ifdef HAVE_RUN_FILE
+  ReadFileNames(r, wp.files_external,
+                record.n_files - record.n_files_embed);
+#else
+  /* skip the external files, they are not supported on this
+     platform */
+  for (std::size_t i = record.n_files_embed; i < record.n_files; ++i)
+    ReadFileName(r);
+#endif
+
+  return wp;
+}
+
+void
+LoadWaypointCache(BufferedReader &r, Waypoints &waypoints,
+                  WaypointOrigin origin)
+{
+  const auto header = r.ReadFullT<CacheHeader>();
+  if (header.version != CacheHeader::VERSION ||
+      header.n_waypoints > MAX_WAYPOINTS)
+    throw std::runtime_error("Malformed waypoint cache header");
+
+  std::vector<Waypoint> result;
+  result.reserve(header.n_waypoints);
+
+  for (unsigned i = 0; i < header.n_waypoints; ++i)
+    result.emplace_back(LoadWaypoint(r, origin));
+
+  for (auto &i : result)
+    waypoints.Append(std::move(i));
+}
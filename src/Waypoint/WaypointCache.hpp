@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Waypoint/Ptr.hpp"
+
+#include <cstdint>
+#include <span>
+
+enum class WaypointOrigin : uint8_t;
+class Waypoints;
+class BufferedReader;
+class BufferedOutputStream;
+
+/**
+ * Write the given waypoints to a binary cache file, which can be
+ * loaded with LoadWaypointCache() much faster than parsing the
+ * original file.
+ *
+ * The origin, the id and the flat location are not stored; they are
+ * assigned by the #Waypoints container on load.
+ *
+ * Throws on error.
+ */
+void
+SaveWaypointCache(BufferedOutputStream &os,
+                  std::span<const WaypointPtr> waypoints);
+
+/**
+ * Load a cache file written by SaveWaypointCache() and append all its
+ * waypoints (in the original order) to the #Waypoints object.
+ * Nothing is added if the file is malformed.
+ *
+ * Throws on error.
+ */
+void
+LoadWaypointCache(BufferedReader &reader, Waypoints &waypoints,
+                  WaypointOrigin origin);
@@ -27,9 +27,9 @@ struct WaypointDetailsBuilder {
   TCHAR name[201];
   tstring details;
 #ifdef HAVE_RUN_FILE
-  std::forward_list<tstring> files_external;
+  std::forward_list<InternedString> files_external;
 #endif
-  std::forward_list<tstring> files_embed;
+  std::forward_list<InternedString> files_embed;
 
   void Reset() noexcept {
     details.clear();
@@ -8,25 +8,37 @@
 #include "LogFile.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "WaypointReader.hpp"
+#include "WaypointCache.hpp"
 #include "Language/Language.hpp"
 #include "LocalPath.hpp"
 #include "Operation/Operation.hpp"
 #include "system/Path.hpp"
 #include "io/MapFile.hpp"
 #include "io/ZipArchive.hpp"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/Reader.hxx"
+
+#include <algorithm>
+#include <vector>
 
 namespace WaypointGlue {
 
+static const TCHAR *const primary_cache_name = _T("waypoints");
+static const TCHAR *const additional_cache_name = _T("waypoints-additional");
+static const TCHAR *const watched_cache_name = _T("waypoints-watched");
+static const TCHAR *const map_xcw_cache_name = _T("waypoints-map-xcw");
+static const TCHAR *const map_cup_cache_name = _T("waypoints-map-cup");
+
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
                  WaypointFileType file_type,
-                 WaypointOrigin origin,
-                 const RasterTerrain *terrain,
+                 WaypointFactory factory,
                  ProgressListener &progress) noexcept
 try {
-  ReadWaypointFile(path, file_type, waypoints,
-                   WaypointFactory(origin, terrain),
-                   progress);
+  ReadWaypointFile(path, file_type, waypoints, factory, progress);
   return true;
 } catch (...) {
   LogFormat(_T("Failed to read waypoint file: %s"), path.c_str());
@@ -36,13 +48,10 @@ try {
 
 static bool
 LoadWaypointFile(Waypoints &waypoints, Path path,
-                 WaypointOrigin origin,
-                 const RasterTerrain *terrain,
+                 WaypointFactory factory,
                  ProgressListener &progress) noexcept
 try {
-  ReadWaypointFile(path, waypoints,
-                   WaypointFactory(origin, terrain),
-                   progress);
+  ReadWaypointFile(path, waypoints, factory, progress);
   return true;
 } catch (...) {
   LogFormat(_T("Failed to read waypoint file: %s"), path.c_str());
@@ -53,13 +62,10 @@ try {
 static bool
 LoadWaypointFile(Waypoints &waypoints, struct zzip_dir *dir, const char *path,
                  WaypointFileType file_type,
-                 WaypointOrigin origin,
-                 const RasterTerrain *terrain,
+                 WaypointFactory factory,
                  ProgressListener &progressg) noexcept
 try {
-  ReadWaypointFile(dir, path, file_type, waypoints,
-                   WaypointFactory(origin, terrain),
-                   progressg);
+  ReadWaypointFile(dir, path, file_type, waypoints, factory, progressg);
   return true;
 } catch (...) {
   LogFormat(_T("Failed to read waypoint file: %s"), path);
@@ -67,8 +73,145 @@ try {
   return false;
 }
 
+/**
+ * Returns the waypoints which were appended since
+ * Waypoints::GetNextId() returned #first_id, in the order in which
+ * they were appended.
+ */
+static std::vector<WaypointPtr>
+GetAppendedWaypoints(const Waypoints &waypoints, unsigned first_id) noexcept
+{
+  std::vector<WaypointPtr> result;
+  for (const auto &i : waypoints)
+    if (i->id >= first_id)
+      result.push_back(i);
+
+  std::sort(result.begin(), result.end(),
+            [](const WaypointPtr &a, const WaypointPtr &b){
+              return a->id < b->id;
+            });
+  return result;
+}
+
+/**
+ * Attempt to load the waypoints of the given file from the cache.
+ *
+ * @return true on success, false if there is no (valid) cache file
+ */
+static bool
+LoadWaypointCache(Waypoints &waypoints, FileCache &cache,
+                  const TCHAR *cache_name, Path original_path,
+                  WaypointOrigin origin) noexcept
+try {
+  auto r = cache.Load(cache_name, original_path);
+  if (!r)
+    return false;
+
+  BufferedReader buffered_reader{*r};
+  LoadWaypointCache(buffered_reader, waypoints, origin);
+  return true;
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load waypoint cache");
+  cache.Flush(cache_name);
+  return false;
+}
+
+static void
+SaveWaypointCache(std::span<const WaypointPtr> list, FileCache &cache,
+                  const TCHAR *cache_name, Path original_path) noexcept
+try {
+  auto os = cache.Save(cache_name, original_path);
+  BufferedOutputStream bos{*os};
+  SaveWaypointCache(bos, list);
+  bos.Flush();
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save waypoint cache");
+}
+
+/**
+ * Load the waypoints of a file from the cache, or parse the file and
+ * update the cache.
+ *
+ * The terrain elevation of waypoints without elevation is looked up
+ * after loading/parsing, because it must not be stored in the cache
+ * (the terrain may change independently).
+ *
+ * @param parse a function which parses the file with the given
+ * #WaypointFactory and returns false on error
+ */
+template<typename F>
+static bool
+LoadCachedWaypointFile(Waypoints &waypoints, FileCache &cache,
+                       const TCHAR *cache_name, Path original_path,
+                       WaypointOrigin origin, const RasterTerrain *terrain,
+                       F &&parse) noexcept
+{
+  const unsigned first_id = waypoints.GetNextId();
+
+  const bool cached = LoadWaypointCache(waypoints, cache, cache_name,
+                                        original_path, origin);
+  const bool success = cached || parse(WaypointFactory(origin));
+
+  const auto appended = GetAppendedWaypoints(waypoints, first_id);
+
+  if (!cached && success)
+    /* save before the terrain elevation is filled in below */
+    SaveWaypointCache(appended, cache, cache_name, original_path);
+
+  const WaypointFactory factory(origin, terrain);
+  for (const auto &i : appended)
+    if (!i->has_elevation)
+      // TODO: eliminate this const_cast hack
+      factory.FallbackElevation(const_cast<Waypoint &>(*i));
+
+  return success;
+}
+
+static bool
+LoadWaypointFile(Waypoints &waypoints, Path path,
+                 WaypointOrigin origin,
+                 const RasterTerrain *terrain,
+                 FileCache *cache, const TCHAR *cache_name,
+                 ProgressListener &progress) noexcept
+{
+  if (cache == nullptr)
+    return LoadWaypointFile(waypoints, path,
+                            WaypointFactory(origin, terrain), progress);
+
+  return LoadCachedWaypointFile(waypoints, *cache, cache_name, path,
+                                origin, terrain,
+                                [&](WaypointFactory factory){
+                                  return LoadWaypointFile(waypoints, path,
+                                                          factory, progress);
+                                });
+}
+
+static bool
+LoadMapWaypointFile(Waypoints &waypoints, struct zzip_dir *dir,
+                    const char *path, WaypointFileType file_type,
+                    const RasterTerrain *terrain,
+                    FileCache *cache, const TCHAR *cache_name,
+                    Path map_path,
+                    ProgressListener &progress) noexcept
+{
+  if (cache == nullptr || map_path == nullptr)
+    return LoadWaypointFile(waypoints, dir, path, file_type,
+                            WaypointFactory(WaypointOrigin::MAP, terrain),
+                            progress);
+
+  return LoadCachedWaypointFile(waypoints, *cache, cache_name, map_path,
+                                WaypointOrigin::MAP, terrain,
+                                [&](WaypointFactory factory){
+                                  return LoadWaypointFile(waypoints, dir, path,
+                                                          file_type, factory,
+                                                          progress);
+                                });
+}
+
 bool
-LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
+LoadWaypoints(Waypoints &way_points, FileCache *cache,
+              const RasterTerrain *terrain,
               ProgressListener &progress)
 {
   bool found = false;
@@ -80,19 +223,20 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   auto path = Profile::GetPath(ProfileKeys::WaypointFile);
   if (path != nullptr)
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::PRIMARY,
-                              terrain, progress);
+                              terrain, cache, primary_cache_name, progress);
 
   // ### SECOND FILE ###
   path = Profile::GetPath(ProfileKeys::AdditionalWaypointFile);
   if (path != nullptr)
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::ADDITIONAL,
-                              terrain, progress);
+                              terrain, cache, additional_cache_name,
+                              progress);
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
   path = Profile::GetPath(ProfileKeys::WatchedWaypointFile);
   if (path != nullptr)
     found |= LoadWaypointFile(way_points, path, WaypointOrigin::WATCHED,
-                              terrain, progress);
+                              terrain, cache, watched_cache_name, progress);
 
   // ### MAP/FOURTH FILE ###
 
@@ -100,15 +244,19 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   if (!found) {
     try {
       if (auto archive = OpenMapFile()) {
-        found |= LoadWaypointFile(way_points, archive->get(), "waypoints.xcw",
-                                  WaypointFileType::WINPILOT,
-                                  WaypointOrigin::MAP,
-                                  terrain, progress);
-
-        found |= LoadWaypointFile(way_points, archive->get(), "waypoints.cup",
-                                  WaypointFileType::SEEYOU,
-                                  WaypointOrigin::MAP,
-                                  terrain, progress);
+        const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+
+        found |= LoadMapWaypointFile(way_points, archive->get(),
+                                     "waypoints.xcw",
+                                     WaypointFileType::WINPILOT,
+                                     terrain, cache, map_xcw_cache_name,
+                                     map_path, progress);
+
+        found |= LoadMapWaypointFile(way_points, archive->get(),
+                                     "waypoints.cup",
+                                     WaypointFileType::SEEYOU,
+                                     terrain, cache, map_cup_cache_name,
+                                     map_path, progress);
       }
     } catch (...) {
       LogError(std::current_exception(),
@@ -118,7 +266,7 @@ LoadWaypoints(Waypoints &way_points, const RasterTerrain *terrain,
   //Load user.cup
   LoadWaypointFile(way_points, LocalPath(_T("user.cup")),
                    WaypointFileType::SEEYOU,
-                   WaypointOrigin::USER, terrain, progress);
+                   WaypointFactory(WaypointOrigin::USER, terrain), progress);
   // Optimise the waypoint list after attaching new waypoints
   way_points.Optimise();
 
@@ -12,6 +12,7 @@ struct PlacesOfInterestSettings;
 struct TeamCodeSettings;
 class DeviceBlackboard;
 class ProfileMap;
+class FileCache;
 
 /**
  * This class is used to parse different waypoint files
@@ -85,10 +86,12 @@ SaveHome(ProfileMap &profile,
  * Reads the waypoints out of the two waypoint files and appends them to the
  * specified waypoint list
  * @param way_points The waypoint list to fill
+ * @param cache an optional #FileCache which stores a pre-parsed
+ * binary copy of each waypoint file, to speed up the next call
  * @param terrain RasterTerrain (for automatic waypoint height)
  */
 bool
-LoadWaypoints(Waypoints &way_points,
+LoadWaypoints(Waypoints &way_points, FileCache *cache,
               const RasterTerrain *terrain,
               ProgressListener &progress);
 
@@ -4,6 +4,7 @@
 #include "FileCache.hpp"
 #include "FileReader.hxx"
 #include "FileOutputStream.hxx"
+#include "FileMapping.hpp"
 #include "system/FileUtil.hpp"
 #include "util/SpanCast.hxx"
 
@@ -24,7 +25,7 @@
 #   include <fileapi.h>
 #endif
 
-static constexpr unsigned FILE_CACHE_MAGIC = 0xab352f8b;
+static constexpr uint32_t FILE_CACHE_MAGIC = 0xab352f8c;
 
 struct FileInfo {
   std::chrono::system_clock::time_point mtime;
@@ -47,6 +48,20 @@ struct FileInfo {
   }
 };
 
+struct FileCacheHeader {
+  uint32_t magic;
+
+  /**
+   * Explicit padding: the payload (see FileCache::GetPayload()) is
+   * aligned to 8 bytes, so mapped cache files may contain doubles.
+   */
+  uint32_t reserved;
+
+  FileInfo info;
+};
+
+static_assert(sizeof(FileCacheHeader) % 8 == 0);
+
 static inline bool
 GetRegularFileInfo(Path path, FileInfo &info)
 {
@@ -104,14 +119,11 @@ FileCache::Load(const TCHAR *name, Path original_path) noexcept
   try {
     auto r = std::make_unique<FileReader>(path);
 
-    unsigned magic;
-    struct FileInfo old_info;
-
-    r->ReadT(magic);
-    r->ReadT(old_info);
+    FileCacheHeader header;
+    r->ReadT(header);
 
-    if (magic == FILE_CACHE_MAGIC &&
-        old_info == original_info)
+    if (header.magic == FILE_CACHE_MAGIC &&
+        header.info == original_info)
       return r;
   } catch (...) {
   }
@@ -120,6 +132,32 @@ FileCache::Load(const TCHAR *name, Path original_path) noexcept
   return nullptr;
 }
 
+std::unique_ptr<FileMapping>
+FileCache::Map(const TCHAR *name, Path original_path) noexcept
+{
+  /* reuse Load() to validate the cache header */
+  if (!Load(name, original_path))
+    return nullptr;
+
+  try {
+    return std::make_unique<FileMapping>(MakeCachePath(name));
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+std::span<const std::byte>
+FileCache::GetPayload(const FileMapping &mapping) noexcept
+{
+  constexpr std::size_t header_size = sizeof(FileCacheHeader);
+
+  std::span<const std::byte> s = mapping;
+  if (s.size() < header_size)
+    return {};
+
+  return s.subspan(header_size);
+}
+
 std::unique_ptr<FileOutputStream>
 FileCache::Save(const TCHAR *name, Path original_path)
 {
@@ -134,8 +172,11 @@ FileCache::Save(const TCHAR *name, Path original_path)
 
   File::Delete(path);
 
+  FileCacheHeader header{};
+  header.magic = FILE_CACHE_MAGIC;
+  header.info = original_info;
+
   auto os = std::make_unique<FileOutputStream>(path);
-  os->Write(ReferenceAsBytes(FILE_CACHE_MAGIC));
-  os->Write(ReferenceAsBytes(original_info));
+  os->Write(ReferenceAsBytes(header));
   return os;
 }
@@ -5,12 +5,15 @@
 
 #include "system/Path.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <stdio.h>
 #include <tchar.h>
 
 class Reader;
 class FileOutputStream;
+class FileMapping;
 
 class FileCache {
   AllocatedPath cache_path;
@@ -32,6 +35,23 @@ public:
    */
   std::unique_ptr<Reader> Load(const TCHAR *name, Path original_path) noexcept;
 
+  /**
+   * Like Load(), but map the whole cache file into memory instead of
+   * opening a #Reader.  Use GetPayload() to skip the cache header.
+   *
+   * Returns nullptr on error.
+   */
+  std::unique_ptr<FileMapping> Map(const TCHAR *name,
+                                   Path original_path) noexcept;
+
+  /**
+   * Returns the portion of a mapping obtained from Map() which
+   * follows the cache header, i.e. the data written to the stream
+   * returned by Save().  It is aligned to 8 bytes.
+   */
+  [[gnu::pure]]
+  static std::span<const std::byte> GetPayload(const FileMapping &mapping) noexcept;
+
   /**
    * Throws on error.
    */
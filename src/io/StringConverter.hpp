@@ -25,6 +25,10 @@ public:
     return charset == Charset::AUTO;
   }
 
+  Charset GetCharset() const noexcept {
+    return charset;
+  }
+
   void SetCharset(Charset _charset) noexcept {
     charset = _charset;
   }
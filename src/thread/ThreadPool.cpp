@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ThreadPool.hpp"
+#include "Thread.hpp"
+#include "Util.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#else
+#include <sysinfoapi.h>
+#endif
+
+class ThreadPool::Worker final : public Thread {
+  ThreadPool &pool;
+
+public:
+  Worker(ThreadPool &_pool, const char *_name) noexcept
+    :Thread(_name), pool(_pool) {}
+
+protected:
+  void Run() noexcept override {
+    pool.RunWorker();
+  }
+};
+
+ThreadPool::ThreadPool(const char *name, unsigned n_threads,
+                       bool _idle_priority)
+  :idle_priority(_idle_priority)
+{
+  assert(n_threads > 0);
+
+  try {
+    for (unsigned i = 0; i < n_threads; ++i) {
+      auto &worker = workers.emplace_front(*this, name);
+
+      try {
+        worker.Start();
+      } catch (...) {
+        workers.pop_front();
+        throw;
+      }
+
+      ++n_workers;
+    }
+  } catch (...) {
+    StopWorkers();
+    throw;
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+  StopWorkers();
+}
+
+void
+ThreadPool::StopWorkers() noexcept
+{
+  {
+    const std::lock_guard lock{mutex};
+    stop = true;
+    cond.notify_all();
+  }
+
+  for (auto &i : workers)
+    i.Join();
+}
+
+void
+ThreadPool::Submit(std::function<void()> &&job) noexcept
+{
+  const std::lock_guard lock{mutex};
+  assert(!stop);
+
+  queue.emplace_back(std::move(job));
+  cond.notify_one();
+}
+
+void
+ThreadPool::RunWorker() noexcept
+{
+  if (idle_priority)
+    SetThreadIdlePriority();
+
+  std::unique_lock lock{mutex};
+
+  while (true) {
+    cond.wait(lock, [this]{ return stop || !queue.empty(); });
+
+    if (queue.empty())
+      /* stop was requested and all jobs are done */
+      break;
+
+    auto job = std::move(queue.front());
+    queue.pop_front();
+
+    {
+      const ScopeUnlock unlock(mutex);
+      job();
+    }
+  }
+}
+
+void
+ThreadPool::ForEach(unsigned n, const std::function<void(unsigned)> &f)
+{
+  struct State {
+    Mutex mutex;
+    Cond cond;
+
+    unsigned next = 0, running_helpers = 0;
+
+    std::exception_ptr error;
+  } state;
+
+  const auto run = [n, &f, &state]() noexcept {
+    while (true) {
+      unsigned i;
+
+      {
+        const std::lock_guard lock{state.mutex};
+        if (state.next >= n)
+          break;
+
+        i = state.next++;
+      }
+
+      try {
+        f(i);
+      } catch (...) {
+        const std::lock_guard lock{state.mutex};
+        if (!state.error)
+          state.error = std::current_exception();
+
+        /* don't start any more invocations */
+        state.next = n;
+      }
+    }
+  };
+
+  const unsigned n_helpers = std::min(n > 0 ? n - 1 : 0, n_workers);
+  state.running_helpers = n_helpers;
+
+  for (unsigned i = 0; i < n_helpers; ++i)
+    Submit([&state, &run]{
+      run();
+
+      /* notify while holding the lock, because the State object
+         lives on the caller's stack and may be destroyed as soon as
+         the caller observes running_helpers==0 */
+      const std::lock_guard lock{state.mutex};
+      if (--state.running_helpers == 0)
+        state.cond.notify_one();
+    });
+
+  /* the calling thread helps, too; this also avoids a deadlock if
+     all workers are busy */
+  run();
+
+  {
+    std::unique_lock lock{state.mutex};
+    state.cond.wait(lock, [&state]{ return state.running_helpers == 0; });
+  }
+
+  if (state.error)
+    std::rethrow_exception(state.error);
+}
+
+unsigned
+ThreadPool::GetProcessorCount() noexcept
+{
+#ifdef HAVE_POSIX
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? unsigned(n) : 1;
+#else
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return std::max(unsigned(info.dwNumberOfProcessors), 1u);
+#endif
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+
+#include <forward_list>
+#include <functional>
+#include <list>
+
+/**
+ * A fixed set of threads which execute submitted jobs in FIFO
+ * order.  This is used to spread independent CPU-bound work (e.g.
+ * decoding terrain tiles) over several CPU cores.
+ */
+class ThreadPool {
+  class Worker;
+
+  Mutex mutex;
+  Cond cond;
+
+  std::list<std::function<void()>> queue;
+
+  std::forward_list<Worker> workers;
+
+  unsigned n_workers = 0;
+
+  const bool idle_priority;
+
+  bool stop = false;
+
+public:
+  /**
+   * Throws on error.
+   *
+   * @param name the name of the worker threads
+   * @param n_threads the number of worker threads
+   * @param idle_priority run the worker threads with "idle" priority?
+   */
+  ThreadPool(const char *name, unsigned n_threads,
+             bool idle_priority=false);
+
+  /**
+   * Waits for all queued jobs to finish.
+   */
+  ~ThreadPool() noexcept;
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned GetSize() const noexcept {
+    return n_workers;
+  }
+
+  /**
+   * Enqueue a job.  It will be invoked in one of the worker threads.
+   * The job must not throw.
+   */
+  void Submit(std::function<void()> &&job) noexcept;
+
+  /**
+   * Invoke f(i) for each i in [0, n), distributed over the worker
+   * threads and the calling thread, in ascending order of "i".
+   * Returns after all invocations have finished.  If one of them
+   * throws, the first exception is rethrown after all others have
+   * finished.
+   */
+  void ForEach(unsigned n, const std::function<void(unsigned)> &f);
+
+  /**
+   * Returns the number of CPU cores available to this process
+   * (at least 1).
+   */
+  [[gnu::pure]]
+  static unsigned GetProcessorCount() noexcept;
+
+private:
+  void StopWorkers() noexcept;
+  void RunWorker() noexcept;
+};
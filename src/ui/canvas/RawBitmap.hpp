@@ -153,6 +153,17 @@ public:
 #endif
   }
 
+  /**
+   * Returns a pointer to the given row (0 is the top-most row).
+   */
+  RawColor *GetRow(unsigned y) noexcept {
+#ifndef USE_GDI
+    return GetBuffer() + y * size.width;
+#else
+    return GetBuffer() + (size.height - 1 - y) * corrected_width;
+#endif
+  }
+
   /**
    * Returns a pointer to the row below the current one.
    */
@@ -62,6 +62,15 @@ public:
     glBufferData(target, size, data, usage);
   }
 
+  /**
+   * Replaces a portion of the buffer, which must be bound and
+   * allocated already.
+   */
+  static void SubData(GLintptr offset, GLsizeiptr size,
+                      const GLvoid *data) noexcept {
+    glBufferSubData(target, offset, size, data);
+  }
+
   void Load(GLsizeiptr size, const GLvoid *data) noexcept {
     Bind();
     Data(size, data);
@@ -125,3 +134,7 @@ public:
 
 class GLArrayBuffer : public GLBuffer<GL_ARRAY_BUFFER, GL_STATIC_DRAW> {
 };
+
+class GLElementArrayBuffer
+  : public GLBuffer<GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW> {
+};
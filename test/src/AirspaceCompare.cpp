@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AirspaceCompare.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "io/BufferedReader.hxx"
+#include "io/FileReader.hxx"
+#include "io/MemoryReader.hxx"
+#include "system/Path.hpp"
+#include "util/SpanCast.hxx"
+#include "util/StringAPI.hxx"
+
+std::vector<AirspacePtr>
+GetPendingAirspaces(const Airspaces &airspaces)
+{
+  const auto &pending = airspaces.GetPending();
+  return {pending.begin(), pending.end()};
+}
+
+std::vector<AirspacePtr>
+ParseAirspaces(Reader &reader)
+{
+  BufferedReader buffered_reader{reader};
+
+  Airspaces airspaces;
+  ParseAirspaceFile(airspaces, buffered_reader);
+  return GetPendingAirspaces(airspaces);
+}
+
+std::vector<AirspacePtr>
+ParseAirspaces(Path path)
+{
+  FileReader file_reader{path};
+  return ParseAirspaces(file_reader);
+}
+
+std::vector<AirspacePtr>
+ParseAirspaces(std::string_view src)
+{
+  MemoryReader memory_reader{AsBytes(src)};
+  return ParseAirspaces(memory_reader);
+}
+
+/**
+ * Compare only the attributes which are valid for the reference;
+ * the parser leaves the others uninitialised.
+ */
+[[gnu::pure]]
+static bool
+Equals(const AirspaceAltitude &a, const AirspaceAltitude &b) noexcept
+{
+  if (a.reference != b.reference || a.altitude != b.altitude)
+    return false;
+
+  switch (a.reference) {
+  case AltitudeReference::AGL:
+    return a.altitude_above_terrain == b.altitude_above_terrain;
+
+  case AltitudeReference::STD:
+    return a.flight_level == b.flight_level;
+
+  default:
+    return true;
+  }
+}
+
+bool
+Equals(const AbstractAirspace &a, const AbstractAirspace &b) noexcept
+{
+  if (a.GetShape() != b.GetShape() ||
+      !StringIsEqual(a.GetName(), b.GetName()) ||
+      a.GetClass() != b.GetClass() || a.GetType() != b.GetType() ||
+      !Equals(a.GetBase(), b.GetBase()) || !Equals(a.GetTop(), b.GetTop()) ||
+      a.GetRadioFrequency() != b.GetRadioFrequency() ||
+      !a.GetDays().equals(b.GetDays()))
+    return false;
+
+  if (a.GetShape() == AbstractAirspace::Shape::CIRCLE)
+    return a.GetReferenceLocation() == b.GetReferenceLocation() &&
+      static_cast<const AirspaceCircle &>(a).GetRadius() ==
+      static_cast<const AirspaceCircle &>(b).GetRadius();
+
+  const auto &pa = a.GetPoints(), &pb = b.GetPoints();
+  if (pa.size() != pb.size())
+    return false;
+
+  for (std::size_t i = 0; i < pa.size(); ++i)
+    if (pa[i].GetLocation() != pb[i].GetLocation())
+      return false;
+
+  return true;
+}
+
+bool
+Equals(const std::vector<AirspacePtr> &a,
+       const std::vector<AirspacePtr> &b) noexcept
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if (!Equals(*a[i], *b[i]))
+      return false;
+
+  return true;
+}
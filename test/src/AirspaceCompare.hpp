@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Airspace/Ptr.hpp"
+
+#include <string_view>
+#include <vector>
+
+class Path;
+class Reader;
+class Airspaces;
+class AbstractAirspace;
+
+/**
+ * Returns the airspaces which were added to the #Airspaces object
+ * (but not yet optimised).
+ */
+std::vector<AirspacePtr>
+GetPendingAirspaces(const Airspaces &airspaces);
+
+/**
+ * Parse an airspace file (OpenAir or TNP) sequentially.
+ */
+std::vector<AirspacePtr>
+ParseAirspaces(Reader &reader);
+
+std::vector<AirspacePtr>
+ParseAirspaces(Path path);
+
+std::vector<AirspacePtr>
+ParseAirspaces(std::string_view src);
+
+/**
+ * Compare all attributes and the geometry of two airspaces.
+ */
+[[gnu::pure]]
+bool
+Equals(const AbstractAirspace &a, const AbstractAirspace &b) noexcept;
+
+[[gnu::pure]]
+bool
+Equals(const std::vector<AirspacePtr> &a,
+       const std::vector<AirspacePtr> &b) noexcept;
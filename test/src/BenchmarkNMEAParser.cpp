@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Feed NMEA lines from stdin into a device driver and the generic
+ * parser many times and report the throughput.  Example:
+ *
+ *   BenchmarkNMEAParser LX 100 <flight.nmea
+ */
+
+#include "NMEA/Info.hpp"
+#include "NMEA/Checksum.hpp"
+#include "Device/Port/NullPort.hpp"
+#include "Device/Driver.hpp"
+#include "Device/Register.hpp"
+#include "Device/Parser.hpp"
+#include "Device/Config.hpp"
+#include "system/Args.hpp"
+#include "util/ConvertString.hpp"
+#include "util/StringStrip.hxx"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+int main(int argc, char **argv)
+{
+  NarrowString<1024> usage;
+  usage = "DRIVER [PASSES] <FILE\n\n"
+          "Where DRIVER is one of:";
+  {
+    const DeviceRegister *driver;
+    for (unsigned i = 0; (driver = GetDriverByIndex(i)) != nullptr; ++i) {
+      WideToUTF8Converter driver_name(driver->name);
+      usage.AppendFormat("\n\t%s", (const char *)driver_name);
+    }
+  }
+
+  Args args(argc, argv, usage);
+  tstring driver_name = args.ExpectNextT();
+  const int passes = args.IsEmpty() ? 10 : args.ExpectNextInt();
+  args.ExpectEnd();
+
+  if (passes <= 0)
+    args.UsageError();
+
+  const DeviceRegister *driver = FindDriverByName(driver_name.c_str());
+  if (driver == nullptr) {
+    _ftprintf(stderr, _T("No such driver: %s\n"), driver_name.c_str());
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> lines;
+
+  char buffer[1024];
+  while (fgets(buffer, sizeof(buffer), stdin) != nullptr) {
+    StripRight(buffer);
+    lines.emplace_back(buffer);
+  }
+
+  if (lines.empty()) {
+    fprintf(stderr, "No input\n");
+    return EXIT_FAILURE;
+  }
+
+  DeviceConfig config;
+  config.Clear();
+
+  NullPort port;
+  Device *device = driver->CreateOnPort != nullptr
+    ? driver->CreateOnPort(config, port)
+    : nullptr;
+
+  NMEAParser parser;
+
+  NMEAInfo data;
+  data.Reset();
+  data.UpdateClock();
+
+  unsigned handled = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (int pass = 0; pass < passes; ++pass) {
+    for (const auto &line : lines) {
+      data.clock += std::chrono::milliseconds{100};
+
+      /* same dispatch as DeviceDescriptor::ParseNMEA() */
+      const bool checksum_valid = VerifyNMEAChecksum(line.c_str());
+
+      if ((device != nullptr &&
+           (checksum_valid
+            ? device->ParseVerifiedNMEA(line.c_str(), data)
+            : device->ParseNMEA(line.c_str(), data))) ||
+          (checksum_valid && parser.ParseVerifiedLine(line.c_str(), data)))
+        ++handled;
+    }
+  }
+
+  const std::chrono::duration<double> duration =
+    std::chrono::steady_clock::now() - start;
+
+  const double total = double(lines.size()) * passes;
+
+  printf("%zu lines x %d passes, %u handled\n",
+         lines.size(), passes, handled);
+  printf("%.0f lines/s, %.1f ns/line\n",
+         total / duration.count(),
+         duration.count() * 1e9 / total);
+
+  delete device;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compare RasterMap::GetHeight() called for each point with the
+ * batched RasterMap::GetHeights() query, using a fan of rays like
+ * the reach calculation does.
+ */
+
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Operation/ConsoleOperationEnvironment.hpp"
+#include "system/Args.hpp"
+#include "io/ZipArchive.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned N_RAYS = 360;
+static constexpr unsigned N_STEPS = 200;
+static constexpr unsigned N_ITERATIONS = 50;
+
+static std::vector<GeoPoint>
+MakeFan(const RasterMap &map)
+{
+  const GeoPoint center = map.GetMapCenter();
+  const double radius = center.DistanceS(map.GetBounds().GetNorthWest()) / 2;
+
+  std::vector<GeoPoint> points;
+  points.reserve(N_RAYS * N_STEPS);
+
+  for (unsigned i = 0; i < N_RAYS; ++i) {
+    const Angle bearing = Angle::FullCircle() * i / N_RAYS;
+    const GeoPoint end = GeoVector(radius, bearing).EndPoint(center);
+    for (unsigned j = 1; j <= N_STEPS; ++j)
+      points.push_back(center.Interpolate(end, double(j) / N_STEPS));
+  }
+
+  return points;
+}
+
+template<typename F>
+static double
+Measure(F &&f)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < N_ITERATIONS; ++i)
+    f();
+  const std::chrono::duration<double, std::milli> duration =
+    std::chrono::steady_clock::now() - start;
+  return duration.count() / N_ITERATIONS;
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH");
+  const auto map_path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  ZipArchive archive(map_path);
+
+  RasterMap map;
+
+  {
+    ConsoleOperationEnvironment operation;
+    LoadTerrainOverview(archive.get(), map.GetTileCache(), operation);
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+
+  const auto points = MakeFan(map);
+  std::vector<TerrainHeight> single(points.size()), batch(points.size());
+
+  const double t_single = Measure([&]{
+    for (std::size_t i = 0; i < points.size(); ++i)
+      single[i] = map.GetHeight(points[i]);
+  });
+
+  const double t_batch = Measure([&]{
+    map.GetHeights(points, batch.data());
+  });
+
+  const double t_single_interpolated = Measure([&]{
+    for (std::size_t i = 0; i < points.size(); ++i)
+      single[i] = map.GetInterpolatedHeight(points[i]);
+  });
+
+  const double t_batch_interpolated = Measure([&]{
+    map.GetInterpolatedHeights(points, batch.data());
+  });
+
+  unsigned n_mismatch = 0;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    if (single[i].GetValue() != batch[i].GetValue())
+      ++n_mismatch;
+
+  printf("%zu points\n", points.size());
+  printf("GetHeight:              %8.3f ms\n", t_single);
+  printf("GetHeights:             %8.3f ms\n", t_batch);
+  printf("GetInterpolatedHeight:  %8.3f ms\n", t_single_interpolated);
+  printf("GetInterpolatedHeights: %8.3f ms\n", t_batch_interpolated);
+
+  if (n_mismatch > 0) {
+    fprintf(stderr, "%u mismatches\n", n_mismatch);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -3,12 +3,19 @@
 
 #include "Engine/Trace/Trace.hpp"
 #include "Contest/ContestManager.hpp"
+#include "Contest/ContestFlight.hpp"
+#include "Contest/Solvers/Contests.hpp"
 #include "Printing.hpp"
 #include "system/Args.hpp"
+#include "thread/ThreadPool.hpp"
+#include "util/ConvertString.hpp"
 #include "DebugReplay.hpp"
 
 #include <cassert>
+#include <memory>
+#include <vector>
 #include <stdio.h>
+#include <string.h>
 
 using namespace std::chrono;
 
@@ -152,22 +159,107 @@ TestContest(DebugReplay &replay)
   weglide_free.Reset();
   charron.Reset();
   full_trace.clear();
+  triangle_trace.clear();
   sprint_trace.clear();
 
   return 0;
 }
 
+/**
+ * Post-flight analysis: load every fix after the release and solve
+ * all contests at full resolution.
+ */
+static int
+TestContestExact(DebugReplay &replay, ThreadPool *pool)
+{
+  std::vector<TracePoint> points;
+  bool released = false;
+
+  while (replay.Next()) {
+    const MoreData &basic = replay.Basic();
+    if (!basic.time_available || !basic.location_available ||
+        !basic.NavAltitudeAvailable())
+      continue;
+
+    if (!released && replay.Calculated().flight.release_time.IsDefined()) {
+      released = true;
+
+      const auto release_time =
+        replay.Calculated().flight.release_time.Cast<TracePoint::Time>();
+      std::erase_if(points, [release_time](const TracePoint &p){
+        return p.GetTime() < release_time;
+      });
+    }
+
+    points.emplace_back(basic);
+  }
+
+  const ContestFlight flight(points);
+
+  static constexpr Contest contests[] = {
+    Contest::OLC_CLASSIC,
+    Contest::OLC_FAI,
+    Contest::OLC_SPRINT,
+    Contest::OLC_LEAGUE,
+    Contest::OLC_PLUS,
+    Contest::DMST,
+    Contest::XCONTEST,
+    Contest::SIS_AT,
+    Contest::NET_COUPE,
+    Contest::WEGLIDE_FREE,
+    Contest::CHARRON,
+  };
+
+  ContestStatistics results[std::size(contests)];
+  flight.Solve(contests, results, 100, pool);
+
+  printf("%zu fixes, %u trace points\n",
+         points.size(), flight.GetFull().size());
+
+  for (std::size_t i = 0; i < std::size(contests); ++i) {
+    std::cout << WideToUTF8Converter(ContestToString(contests[i])).c_str()
+              << "\n";
+
+    for (const auto &result : results[i].result) {
+      if (result.IsDefined())
+        PrintHelper::print(result);
+    }
+  }
+
+  return 0;
+}
 
 int main(int argc, char **argv)
 {
-  Args args(argc, argv, "DRIVER FILE");
-  DebugReplay *replay = CreateDebugReplay(args);
-  if (replay == NULL)
-    return EXIT_FAILURE;
+  Args args(argc, argv, "[--exact] [DRIVER] FILE ...\n"
+            "Options:\n"
+            "  --exact   post-flight analysis of all fixes, using all CPU cores");
+
+  bool exact = false;
+  if (const char *arg = args.PeekNext();
+      arg != nullptr && strcmp(arg, "--exact") == 0) {
+    args.Skip();
+    exact = true;
+  }
+
+  std::unique_ptr<ThreadPool> pool;
+  if (exact && ThreadPool::GetProcessorCount() > 1)
+    pool = std::make_unique<ThreadPool>("RunContestAnalysis",
+                                        ThreadPool::GetProcessorCount() - 1);
+
+  do {
+    DebugReplay *replay = CreateDebugReplay(args);
+    if (replay == NULL)
+      return EXIT_FAILURE;
+
+    int result = exact
+      ? TestContestExact(*replay, pool.get())
+      : TestContest(*replay);
+    delete replay;
 
-  args.ExpectEnd();
+    if (result != 0)
+      return result;
+  } while (!args.IsEmpty());
 
-  int result = TestContest(*replay);
-  delete replay;
-  return result;
+  return EXIT_SUCCESS;
 }
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Engine/Route/AStar.hpp"
+#include "TestUtil.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <deque>
+
+static constexpr unsigned SIZE = 120;
+static constexpr unsigned UNREACHABLE = ~0u;
+
+struct GridNode {
+  unsigned x, y;
+
+  constexpr bool operator==(const GridNode &) const noexcept = default;
+};
+
+/**
+ * A deliberately weak hash function, to stress the collision
+ * handling of the #AStar node table.
+ */
+struct GridNodeHash {
+  constexpr std::size_t operator()(const GridNode &n) const noexcept {
+    return n.x * std::size_t(SIZE) + n.y;
+  }
+};
+
+static std::array<std::array<bool, SIZE>, SIZE> wall;
+
+static void
+GenerateMaze(unsigned density)
+{
+  for (unsigned x = 0; x < SIZE; ++x)
+    for (unsigned y = 0; y < SIZE; ++y)
+      wall[x][y] = unsigned(rand() % 100) < density;
+
+  wall[0][0] = wall[SIZE - 1][SIZE - 1] = false;
+}
+
+static constexpr unsigned
+Distance(unsigned a, unsigned b) noexcept
+{
+  return a > b ? a - b : b - a;
+}
+
+/**
+ * Reference implementation: breadth-first search.
+ */
+static unsigned
+SearchBFS(GridNode start, GridNode goal)
+{
+  std::array<std::array<unsigned, SIZE>, SIZE> d;
+  for (auto &column : d)
+    column.fill(UNREACHABLE);
+
+  std::deque<GridNode> queue;
+  d[start.x][start.y] = 0;
+  queue.push_back(start);
+
+  while (!queue.empty()) {
+    const GridNode n = queue.front();
+    queue.pop_front();
+    if (n == goal)
+      return d[n.x][n.y];
+
+    const GridNode neighbours[] = {
+      {n.x - 1, n.y}, {n.x + 1, n.y}, {n.x, n.y - 1}, {n.x, n.y + 1},
+    };
+
+    for (const auto &i : neighbours) {
+      if (i.x >= SIZE || i.y >= SIZE || wall[i.x][i.y] ||
+          d[i.x][i.y] != UNREACHABLE)
+        continue;
+
+      d[i.x][i.y] = d[n.x][n.y] + 1;
+      queue.push_back(i);
+    }
+  }
+
+  return UNREACHABLE;
+}
+
+/**
+ * @return the length of the shortest path or #UNREACHABLE
+ */
+static unsigned
+SearchAStar(AStar<GridNode, GridNodeHash> &astar,
+            GridNode start, GridNode goal)
+{
+  astar.Restart(start);
+
+  while (!astar.IsEmpty()) {
+    const GridNode n = astar.Pop();
+    if (n == goal) {
+      /* walk back to the start, checking that the predecessor chain
+         matches the node value */
+      unsigned length = 0;
+      for (GridNode i = n, p = astar.GetPredecessor(i); !(p == i);
+           i = p, p = astar.GetPredecessor(i)) {
+        if (Distance(i.x, p.x) + Distance(i.y, p.y) != 1)
+          return UNREACHABLE - 1;
+        ++length;
+      }
+
+      if (astar.GetNodeValue(n).g != length)
+        return UNREACHABLE - 1;
+
+      return length;
+    }
+
+    const GridNode neighbours[] = {
+      {n.x - 1, n.y}, {n.x + 1, n.y}, {n.x, n.y - 1}, {n.x, n.y + 1},
+    };
+
+    for (const auto &i : neighbours) {
+      if (i.x >= SIZE || i.y >= SIZE || wall[i.x][i.y])
+        continue;
+
+      const unsigned h = Distance(i.x, goal.x) + Distance(i.y, goal.y);
+      astar.Link(i, n, AStarPriorityValue(1, h));
+    }
+  }
+
+  return UNREACHABLE;
+}
+
+int main()
+{
+  static constexpr unsigned N_MAZES = 8;
+  plan_tests(2 * N_MAZES);
+
+  srand(42);
+
+  /* start with a tiny reservation, so the node table needs to grow
+     during the first searches */
+  AStar<GridNode, GridNodeHash> astar(0);
+
+  for (unsigned i = 0; i < N_MAZES; ++i) {
+    GenerateMaze(i * 5);
+
+    const GridNode start{0, 0}, goal{SIZE - 1, SIZE - 1};
+    const GridNode middle{SIZE / 2 + i, SIZE / 3};
+
+    ok1(SearchAStar(astar, start, goal) == SearchBFS(start, goal));
+
+    const GridNode other = wall[middle.x][middle.y] ? start : middle;
+    ok1(SearchAStar(astar, goal, other) == SearchBFS(goal, other));
+  }
+
+  return exit_status();
+}
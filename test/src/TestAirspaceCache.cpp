@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Airspace/AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/MemoryReader.hxx"
+#include "io/StringOutputStream.hxx"
+#include "system/Path.hpp"
+#include "util/SpanCast.hxx"
+#include "util/PrintException.hxx"
+#include "AirspaceCompare.hpp"
+#include "TestUtil.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <tchar.h>
+
+static std::string
+Save(const std::vector<AirspacePtr> &airspaces)
+{
+  StringOutputStream sos;
+  BufferedOutputStream bos{sos};
+  SaveAirspaceCache(bos, airspaces);
+  bos.Flush();
+  return std::move(sos).GetValue();
+}
+
+static std::vector<AirspacePtr>
+Load(std::string_view data)
+{
+  MemoryReader memory_reader{AsBytes(data)};
+  BufferedReader buffered_reader{memory_reader};
+
+  Airspaces airspaces;
+  try {
+    LoadAirspaceCache(buffered_reader, airspaces);
+  } catch (...) {
+    /* nothing must have been added */
+    if (!airspaces.GetPending().empty())
+      return {nullptr};
+    throw;
+  }
+
+  return GetPendingAirspaces(airspaces);
+}
+
+static void
+TestRoundTrip(Path path)
+{
+  const auto original = ParseAirspaces(path);
+  ok1(!original.empty());
+
+  const auto data = Save(original);
+  ok1(Equals(Load(data), original));
+
+  /* a truncated file must be rejected as a whole */
+  bool failed = false;
+  try {
+    Load(data.substr(0, data.size() - 1));
+  } catch (...) {
+    failed = true;
+  }
+
+  ok1(failed);
+}
+
+static void
+TestMalformed()
+{
+  /* an unknown version must be rejected */
+  std::string data = Save({});
+  data[0] ^= 0x40;
+
+  bool failed = false;
+  try {
+    Load(data);
+  } catch (...) {
+    failed = true;
+  }
+
+  ok1(failed);
+
+  ok1(Load(Save({})).empty());
+}
+
+int main()
+try {
+  plan_tests(3 * 3 + 2);
+
+  TestRoundTrip(Path(_T("test/data/airspace/openair.txt")));
+  TestRoundTrip(Path(_T("test/data/airspace/openair_extended.txt")));
+  TestRoundTrip(Path(_T("test/data/airspace/tnp.sua")));
+  TestMalformed();
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -12,8 +12,13 @@
 #include "util/PrintException.hxx"
 #include "io/FileLineReader.hpp"
 #include "Operation/Operation.hpp"
+#include "thread/ThreadPool.hpp"
+#include "AirspaceCompare.hpp"
 #include "TestUtil.hpp"
 
+#include <string>
+
+#include <stdio.h>
 #include <tchar.h>
 
 struct AirspaceClassTestCouple
@@ -288,13 +293,98 @@ TestOpenAirExtended()
   }
 }
 
+/**
+ * Generate a large OpenAir file with polygons and circles.
+ *
+ * @param latin1_block insert a name which is not valid UTF-8 into
+ * this block
+ * @param dangling_interval insert an airspace without geometry
+ * (whose attributes are carried over to the next airspace) after
+ * each multiple of this block number; 0 disables this
+ */
+static std::string
+GenerateOpenAir(unsigned n_blocks, unsigned latin1_block,
+                unsigned dangling_interval)
+{
+  std::string result = "* generated\r\n\r\n";
+
+  char buffer[256];
+  for (unsigned i = 0; i < n_blocks; ++i) {
+    if (i % 2 == 0) {
+      snprintf(buffer, sizeof(buffer),
+               "AC R\r\nAN Polygon %u%s\r\nAL %u ft\r\nAH FL%u\r\n"
+               "DP 47:%02u:00 N 007:%02u:00 E\r\n"
+               "DP 47:%02u:30 N 007:%02u:00 E\r\n"
+               "DP 47:%02u:30 N 007:%02u:30 E\r\n\r\n",
+               i, i == latin1_block ? " Z\xfcrich" : " Caf\xc3\xa9",
+               i % 5000, 50 + i % 100,
+               i % 60, (i / 60) % 60,
+               i % 60, (i / 60) % 60,
+               i % 60, (i / 60) % 60);
+    } else {
+      snprintf(buffer, sizeof(buffer),
+               "AC Q\r\nAN Circle %u * comment\r\nAL GND\r\nAH %u ft\r\n"
+               "V X=47:%02u:00 N 008:%02u:00 E\r\nDC %u\r\n\r\n",
+               i, 1000 + i % 5000,
+               i % 60, (i / 60) % 60, 1 + i % 10);
+    }
+
+    result += buffer;
+
+    if (dangling_interval > 0 && i % dangling_interval == 0)
+      result += "AC D\r\nAN Dangling\r\nAF 123.450\r\n\r\n";
+  }
+
+  return result;
+}
+
+static std::vector<AirspacePtr>
+ParseParallel(std::string_view src, ThreadPool &pool)
+{
+  Airspaces airspaces;
+  ParseAirspaceFile(airspaces, src, pool);
+  return GetPendingAirspaces(airspaces);
+}
+
+static void
+TestParallel()
+{
+  ThreadPool pool("Test", 3);
+
+  const auto plain = GenerateOpenAir(8000, ~0u, 0);
+  ok1(plain.size() > 512 * 1024);
+  const auto expected = ParseAirspaces(plain);
+  ok1(expected.size() == 8000);
+  ok1(Equals(ParseParallel(plain, pool), expected));
+
+  /* names after the first invalid UTF-8 sequence are converted from
+     ISO-Latin-1 */
+  const auto latin1 = GenerateOpenAir(8000, 5000, 0);
+  ok1(Equals(ParseParallel(latin1, pool), ParseAirspaces(latin1)));
+
+  /* airspaces without geometry which leak attributes into the next
+     one */
+  const auto dangling = GenerateOpenAir(8000, ~0u, 1);
+  ok1(Equals(ParseParallel(dangling, pool), ParseAirspaces(dangling)));
+
+  /* small files are parsed sequentially */
+  const auto small = GenerateOpenAir(10, ~0u, 0);
+  ok1(Equals(ParseParallel(small, pool), ParseAirspaces(small)));
+
+  /* only the complete lines of the file header are inspected */
+  ok1(!IsTNPAirspaceFile(plain.substr(0, 4096)));
+  ok1(IsTNPAirspaceFile("* comment\r\nTITLE=Test\r\nTYPE=CTA\r\n"));
+  ok1(!IsTNPAirspaceFile("* comment\nTITLE=Te"));
+}
+
 int main()
 try {
-  plan_tests(113);
+  plan_tests(113 + 9);
 
   TestOpenAir();
   TestTNP();
   TestOpenAirExtended();
+  TestParallel();
 
   return exit_status();
 } catch (const std::runtime_error &e) {
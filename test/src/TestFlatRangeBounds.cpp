@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Geo/Flat/FlatRangeBounds.hpp"
+#include "TestUtil.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+static bool
+operator==(const FlatBoundingBox &a, const FlatBoundingBox &b) noexcept
+{
+  return a.GetLowerLeft() == b.GetLowerLeft() &&
+    a.GetUpperRight() == b.GetUpperRight();
+}
+
+/**
+ * Compare all ranges of a random walk with the bounding box
+ * calculated by iterating over the points.
+ */
+static void
+TestRanges(unsigned n)
+{
+  std::vector<FlatGeoPoint> points;
+  FlatGeoPoint p(0, 0);
+  for (unsigned i = 0; i < n; ++i) {
+    p.x += rand() % 201 - 100;
+    p.y += rand() % 201 - 100;
+    points.push_back(p);
+  }
+
+  FlatRangeBounds bounds;
+  bounds.Update(n, [&points](std::size_t i){ return points[i]; });
+
+  unsigned n_mismatch = 0;
+  for (unsigned begin = 0; begin < n; ++begin) {
+    for (unsigned end = begin + 1; end <= n; ++end) {
+      const FlatBoundingBox expected(points.begin() + begin,
+                                     points.begin() + end);
+      if (!(bounds.Get(begin, end) == expected))
+        ++n_mismatch;
+    }
+  }
+
+  ok1(n_mismatch == 0);
+}
+
+int main()
+{
+  plan_tests(6);
+
+  srand(42);
+
+  TestRanges(1);
+  TestRanges(2);
+  TestRanges(7);
+  TestRanges(64);
+  TestRanges(65);
+  TestRanges(300);
+
+  return exit_status();
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Engine/Waypoint/InternedString.hpp"
+#include "util/StringAPI.hxx"
+#include "TestUtil.hpp"
+
+#include <thread>
+#include <vector>
+
+static void
+TestBasic()
+{
+  InternedString empty;
+  ok1(empty.empty());
+  ok1(empty.size() == 0);
+  ok1(StringIsEqual(empty.c_str(), _T("")));
+  ok1(InternedString{tstring_view{}} == empty);
+
+  InternedString a{_T("foo")};
+  ok1(!a.empty());
+  ok1(a.size() == 3);
+  ok1(StringIsEqual(a.c_str(), _T("foo")));
+  ok1(a == _T("foo"));
+  ok1(!(a == _T("bar")));
+
+  /* equal values share one buffer */
+  InternedString b{tstring_view{_T("foobar"), 3}};
+  ok1(a == b);
+  ok1(a.c_str() == b.c_str());
+
+  InternedString c{_T("bar")};
+  ok1(!(a == c));
+
+  /* copy and move */
+  InternedString d{a};
+  ok1(d.c_str() == a.c_str());
+
+  InternedString e{std::move(d)};
+  ok1(e == a);
+  ok1(d.empty());
+
+  e = c;
+  ok1(e == c);
+  ok1(a == _T("foo"));
+
+  e = _T("");
+  ok1(e.empty());
+
+  e.assign(_T("foo"));
+  ok1(e.c_str() == a.c_str());
+}
+
+static void
+TestRelease()
+{
+  /* after all references are gone, the value must be allocated
+     again, and still be correct */
+  {
+    InternedString a{_T("released")};
+    ok1(a == _T("released"));
+  }
+
+  InternedString b{_T("released")};
+  ok1(b == _T("released"));
+}
+
+static void
+TestThreads()
+{
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < 4; ++t)
+    threads.emplace_back([]{
+      for (unsigned i = 0; i < 10000; ++i) {
+        InternedString a{_T("shared")};
+        InternedString b{a};
+        InternedString c{_T("shared")};
+        if (!(b == c))
+          abort();
+      }
+    });
+
+  for (auto &i : threads)
+    i.join();
+
+  InternedString a{_T("shared")};
+  ok1(a == _T("shared"));
+}
+
+int main()
+{
+  plan_tests(22);
+
+  TestBasic();
+  TestRelease();
+  TestThreads();
+
+  return exit_status();
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "NMEA/SentenceTable.hpp"
+#include "NMEA/Checksum.hpp"
+#include "TestUtil.hpp"
+
+#include <string>
+
+static constexpr auto sentences = MakeNMEASentenceTable<int>({
+  {"GGA", 1},
+  {"RMC", 2},
+  {"$PFLAA", 3},
+  {"!w", 4},
+});
+
+[[gnu::pure]]
+static int
+Lookup(std::string_view name) noexcept
+{
+  const int *handler = sentences.Find(name);
+  return handler != nullptr ? *handler : 0;
+}
+
+static void
+TestFind()
+{
+  ok1(Lookup("GGA") == 1);
+  ok1(Lookup("RMC") == 2);
+  ok1(Lookup("$PFLAA") == 3);
+  ok1(Lookup("!w") == 4);
+
+  ok1(Lookup("GSA") == 0);
+  ok1(Lookup("GG") == 0);
+  ok1(Lookup("GGAX") == 0);
+  ok1(Lookup("$PFLA") == 0);
+  ok1(Lookup("$pflaa") == 0);
+
+  /* an empty name must not match an unused slot */
+  ok1(Lookup({}) == 0);
+}
+
+static void
+TestFastChecksum()
+{
+  /* all lengths around the eight-character word size, with and
+     without the leading dollar sign (which is not checksummed) */
+  for (unsigned length = 0; length < 18; ++length) {
+    std::string s;
+    for (unsigned i = 0; i < length; ++i)
+      s.push_back(static_cast<char>(0x20 + (i * 37 + length) % 0x5f));
+
+    ok(FastNMEAChecksum(s) == NMEAChecksum(std::string_view{s}),
+       "length %u", length);
+
+    s.insert(s.begin(), '$');
+    ok(FastNMEAChecksum(s) == NMEAChecksum(std::string_view{s}),
+       "length %u with '$'", length);
+  }
+}
+
+int main()
+{
+  plan_tests(10 + 18 * 2);
+
+  TestFind();
+  TestFastChecksum();
+
+  return exit_status();
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Geo/PolygonEdgeArray.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+#include "TestUtil.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+static const GeoPoint center(Angle::Degrees(7.5), Angle::Degrees(47.2));
+
+static double
+Random(double min, double max)
+{
+  return min + (max - min) * rand() / RAND_MAX;
+}
+
+static GeoPoint
+RandomPoint(double radius)
+{
+  return GeoVector(Random(0, radius),
+                   Angle::Degrees(Random(0, 360))).EndPoint(center);
+}
+
+/**
+ * Generate a closed, star-shaped polygon with many vertices (and some
+ * self-intersections if "jagged" is set).
+ */
+static SearchPointVector
+MakePolygon(unsigned n, bool jagged)
+{
+  SearchPointVector v;
+  for (unsigned i = 0; i < n; ++i) {
+    double bearing = 360. * i / n;
+    if (jagged)
+      bearing += Random(-20, 20);
+
+    v.emplace_back(GeoVector(Random(5000, 30000),
+                             Angle::Degrees(bearing)).EndPoint(center));
+  }
+
+  v.emplace_back(v.front().GetLocation());
+  return v;
+}
+
+static void
+TestPolygon(unsigned n, bool jagged)
+{
+  const FlatProjection projection(center);
+
+  SearchPointVector border = MakePolygon(n, jagged);
+  border.Project(projection);
+
+  PolygonEdgeArray edges;
+  edges.Update(border);
+  edges.Project(border);
+
+  unsigned n_inside = 0, n_inside_mismatch = 0;
+  for (unsigned i = 0; i < 2000; ++i) {
+    const GeoPoint p = RandomPoint(35000);
+    const bool expected = border.IsInside(p);
+    if (expected)
+      ++n_inside;
+
+    if (edges.IsInside(p) != expected)
+      ++n_inside_mismatch;
+  }
+
+  ok1(n_inside > 0);
+  ok1(n_inside_mismatch == 0);
+
+  unsigned n_hits = 0, n_ray_mismatch = 0;
+  for (unsigned i = 0; i < 500; ++i) {
+    const FlatRay ray(projection.ProjectInteger(RandomPoint(40000)),
+                      projection.ProjectInteger(RandomPoint(40000)));
+
+    std::vector<double> expected;
+    for (auto it = border.begin(); it + 1 != border.end(); ++it) {
+      const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
+      const auto t = ray.DistinctIntersection(r_seg);
+      if (t >= 0)
+        expected.push_back(t);
+    }
+
+    std::vector<double> result;
+    edges.VisitIntersections(ray, [&result](double t){
+      result.push_back(t);
+    });
+
+    n_hits += expected.size();
+    if (result != expected)
+      ++n_ray_mismatch;
+  }
+
+  ok1(n_hits > 0);
+  ok1(n_ray_mismatch == 0);
+}
+
+int main()
+{
+  plan_tests(4 * 4);
+
+  srand(42);
+
+  /* smaller than one block */
+  TestPolygon(5, false);
+
+  /* not a multiple of the block size */
+  TestPolygon(PolygonEdgeArray::BLOCK_SIZE * 7 + 3, false);
+  TestPolygon(PolygonEdgeArray::BLOCK_SIZE * 7 + 3, true);
+  TestPolygon(5000, true);
+
+  return exit_status();
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Topography/RangeAllocator.hpp"
+#include "TestUtil.hpp"
+
+static void
+TestBasic()
+{
+  RangeAllocator a;
+  a.Reset(100);
+  ok1(a.GetCapacity() == 100);
+  ok1(a.GetUsed() == 0);
+
+  const unsigned x = a.Allocate(30);
+  const unsigned y = a.Allocate(30);
+  const unsigned z = a.Allocate(30);
+  ok1(x == 0);
+  ok1(y == 30);
+  ok1(z == 60);
+  ok1(a.GetUsed() == 90);
+
+  /* full */
+  ok1(a.Allocate(20) == RangeAllocator::NONE);
+
+  /* the gap is reused */
+  a.Free(y);
+  ok1(a.GetUsed() == 60);
+  ok1(a.Allocate(40) == RangeAllocator::NONE);
+  ok1(a.Allocate(20) == 30);
+
+  a.Reset(10);
+  ok1(a.GetUsed() == 0);
+  ok1(a.Allocate(10) == 0);
+  ok1(a.Allocate(1) == RangeAllocator::NONE);
+}
+
+static void
+TestMerge()
+{
+  RangeAllocator a;
+  a.Reset(100);
+
+  const unsigned x = a.Allocate(25);
+  const unsigned y = a.Allocate(25);
+  const unsigned z = a.Allocate(25);
+  const unsigned w = a.Allocate(25);
+  ok1(w == 75);
+
+  /* free neighbours in an order which needs merging in both
+     directions */
+  a.Free(x);
+  a.Free(z);
+  a.Free(y);
+  ok1(a.Allocate(75) == 0);
+
+  a.Free(0);
+  a.Free(w);
+  ok1(a.GetUsed() == 0);
+  ok1(a.Allocate(100) == 0);
+}
+
+int main()
+{
+  plan_tests(17);
+
+  TestBasic();
+  TestMerge();
+
+  return exit_status();
+}
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyFile.hpp"
+#include "Topography/XShape.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "io/FileCache.hpp"
+#include "io/ZipArchive.hpp"
+#include "io/ZipLineReader.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "util/PrintException.hxx"
+#include "util/StringAPI.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+static const Path map_path{_T("test/data/benalla9.xcm")};
+
+static void
+Load(TopographyStore &store, ZipArchive &archive, FileCache *cache)
+{
+  ZipLineReaderA reader(archive.get(), "topology.tpl");
+  store.Load(reader, nullptr, archive.get(), cache, map_path);
+}
+
+static bool
+Equals(const XShape &a, const XShape &b) noexcept
+{
+  const auto a_lines = a.GetLines(), b_lines = b.GetLines();
+  if (a.get_bounds().GetNorthWest() != b.get_bounds().GetNorthWest() ||
+      a.get_bounds().GetSouthEast() != b.get_bounds().GetSouthEast() ||
+      a.get_type() != b.get_type() ||
+      !std::equal(a_lines.begin(), a_lines.end(),
+                  b_lines.begin(), b_lines.end()))
+    return false;
+
+  std::size_t n_points = 0;
+  for (const unsigned n : a_lines)
+    n_points += n;
+
+  if (!std::equal(a.GetPoints(), a.GetPoints() + n_points, b.GetPoints()))
+    return false;
+
+  if ((a.GetLabel() == nullptr) != (b.GetLabel() == nullptr) ||
+      (a.GetLabel() != nullptr && !StringIsEqual(a.GetLabel(), b.GetLabel())))
+    return false;
+
+  return true;
+}
+
+#ifdef ENABLE_OPENGL
+
+static bool
+Equals(XShape::Indices a, XShape::Indices b, std::size_t n_counts) noexcept
+{
+  if (a.indices == nullptr || b.indices == nullptr)
+    return a.indices == b.indices;
+
+  std::size_t n_indices = 0;
+  for (std::size_t i = 0; i < n_counts; ++i)
+    n_indices += a.count[i];
+
+  return std::equal(a.count, a.count + n_counts, b.count) &&
+    std::equal(a.indices, a.indices + n_indices, b.indices);
+}
+
+/**
+ * Compare the precomputed thinning indices with the ones built by
+ * #XShape.
+ */
+static bool
+EqualIndices(const TopographyFile &file,
+             const XShape &a, const XShape &b) noexcept
+{
+  if (a.get_type() != MS_SHAPE_LINE && a.get_type() != MS_SHAPE_POLYGON)
+    return true;
+
+  const std::size_t n_counts = a.get_type() == MS_SHAPE_LINE
+    ? a.GetLines().size()
+    : 1;
+
+  for (unsigned level = a.get_type() == MS_SHAPE_LINE;
+       level < XShape::THINNING_LEVELS; ++level) {
+    const auto min_distance = file.GetMinimumShapeDistance(level, 1);
+    if (!Equals(a.GetIndices(level, min_distance),
+                b.GetIndices(level, min_distance), n_counts))
+      return false;
+  }
+
+  return true;
+}
+
+#endif
+
+static bool
+Equals(const TopographyFile &a, const TopographyFile &b) noexcept
+{
+  auto i = a.begin();
+  auto j = b.begin();
+  for (; i != a.end() && j != b.end(); ++i, ++j) {
+    if (!Equals(*i, *j))
+      return false;
+
+#ifdef ENABLE_OPENGL
+    if (!EqualIndices(a, *i, *j))
+      return false;
+#endif
+  }
+
+  return i == a.end() && j == b.end();
+}
+
+static bool
+Equals(const TopographyStore &a, const TopographyStore &b) noexcept
+{
+  if (std::distance(a.begin(), a.end()) != std::distance(b.begin(), b.end()))
+    return false;
+
+  return std::equal(a.begin(), a.end(), b.begin(),
+                    [](const TopographyFile &x, const TopographyFile &y){
+                      return Equals(x, y);
+                    });
+}
+
+static WindowProjection
+MakeProjection(const GeoPoint &location, double radius) noexcept
+{
+  WindowProjection projection;
+  projection.SetScreenSize({640, 480});
+  projection.SetScaleFromRadius(radius);
+  projection.SetGeoLocation(location);
+  projection.SetScreenOrigin(320, 240);
+  projection.UpdateScreenBounds();
+  return projection;
+}
+
+/**
+ * Are all layers using a #ShapeStore?
+ */
+static bool
+HasStores(const TopographyStore &store) noexcept
+{
+  return std::all_of(store.begin(), store.end(), [](const auto &file){
+    return file.HasStore();
+  });
+}
+
+/**
+ * Delete the shape stores left over from a previous run, so the
+ * first run really compiles them.
+ */
+static void
+DeleteShapeStores(Path directory)
+{
+  struct Visitor final : File::Visitor {
+    void Visit(Path path, [[maybe_unused]] Path filename) override {
+      File::Delete(path);
+    }
+  } visitor;
+
+  Directory::VisitSpecificFiles(directory, _T("topography-*"), visitor);
+}
+
+/**
+ * Compare the shapes selected by Update() (i.e. the grid index of
+ * the #ShapeStore vs. the shapelib index).
+ */
+static bool
+CompareUpdate(TopographyStore &a, TopographyStore &b,
+              const WindowProjection &projection)
+{
+  a.ScanVisibility(projection);
+  b.ScanVisibility(projection);
+  return Equals(a, b);
+}
+
+int main()
+try {
+  plan_tests(12);
+
+  const Path results_path{_T("output/results")};
+  Directory::Create(results_path);
+  DeleteShapeStores(results_path);
+  FileCache cache{AllocatedPath{results_path}};
+
+  ZipArchive archive{map_path};
+
+  TopographyStore plain;
+  Load(plain, archive, nullptr);
+  ok1(plain.begin() != plain.end());
+  ok1(!File::Exists(Path(_T("output/results/topography-roadltrans_line"))));
+
+  /* the first run compiles the shapefiles, the second one uses the
+     cache */
+  for (unsigned run = 0; run < 2; ++run) {
+    TopographyStore cached;
+    Load(cached, archive, &cache);
+    ok1(File::Exists(Path(_T("output/results/topography-roadltrans_line"))));
+    ok1(HasStores(cached));
+
+    const GeoPoint center = plain.begin()->GetCenter();
+    ok1(CompareUpdate(plain, cached, MakeProjection(center, 5000)));
+
+    plain.LoadAll();
+    cached.LoadAll();
+    ok1(Equals(plain, cached));
+
+    /* outside of the map */
+    ok1(CompareUpdate(plain, cached,
+                      MakeProjection(GeoPoint(Angle::Degrees(-70),
+                                              Angle::Degrees(10)),
+                                     5000)));
+
+    /* reset the plain store for the next run */
+    plain.Reset();
+    Load(plain, archive, nullptr);
+  }
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
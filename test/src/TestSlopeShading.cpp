@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Terrain/SlopeShading.hpp"
+#include "TestUtil.hpp"
+
+#include <cstdlib>
+
+static constexpr unsigned WIDTH = 1003;
+
+static TerrainHeight row_above[WIDTH], row_below[WIDTH], row_middle[WIDTH];
+
+static void
+FillRow(TerrainHeight *row, int base, int range, bool with_special)
+{
+  for (unsigned i = 0; i < WIDTH; ++i) {
+    int value = base + rand() % range;
+    if (with_special && rand() % 50 == 0)
+      row[i] = rand() % 2 == 0
+        ? TerrainHeight::Invalid()
+        : TerrainHeight(-30000 - rand() % 100);
+    else
+      row[i] = TerrainHeight(value);
+  }
+}
+
+/**
+ * Compare the (possibly vectorised) batch implementation with the
+ * portable reference implementation.  The SIMD code calculates with
+ * float instead of int, which may round some pixels to the
+ * neighbouring shading level.
+ */
+static void
+TestCompare(unsigned q, unsigned height_slope_factor,
+            int sx, int sy, int sz, int contrast)
+{
+  const SlopeShadingParameters p{
+    sx, sy, sz, contrast, height_slope_factor, 2 * q,
+  };
+
+  const unsigned n = WIDTH - 2 * q;
+
+  int8_t result[WIDTH];
+  CalculateSlopeShading(result, row_above + q, row_below + q,
+                        row_middle, row_middle + 2 * q,
+                        n, 2 * q, p);
+
+  unsigned n_special_mismatch = 0, n_mismatch = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    const int8_t expected =
+      CalculateSlopeShading(row_above[q + i], row_below[q + i],
+                            row_middle[i], row_middle[2 * q + i],
+                            2 * q, p);
+
+    if ((expected == NO_SLOPE_SHADING) != (result[i] == NO_SLOPE_SHADING))
+      ++n_special_mismatch;
+    else if (std::abs(expected - result[i]) > 1)
+      ++n_mismatch;
+  }
+
+  ok1(n_special_mismatch == 0);
+  ok1(n_mismatch == 0);
+}
+
+static void
+TestRows(bool with_special)
+{
+  /* gentle terrain */
+  FillRow(row_above, 200, 50, with_special);
+  FillRow(row_below, 200, 50, with_special);
+  FillRow(row_middle, 200, 50, with_special);
+
+  TestCompare(1, 100, -100, 150, 200, 128);
+  TestCompare(3, 500, 50, -220, 100, 255);
+
+  /* steep terrain, exceeds the ClipHeightDelta() range */
+  FillRow(row_above, -1000, 5000, with_special);
+  FillRow(row_below, 2000, 5000, with_special);
+  FillRow(row_middle, 0, 8000, with_special);
+
+  TestCompare(1, 1, 255, 0, 30, 64);
+  TestCompare(25, 8192 / (25 * 25), -180, -180, 44, 200);
+}
+
+int main()
+{
+  plan_tests(16);
+
+  srand(42);
+
+  TestRows(false);
+  TestRows(true);
+
+  return exit_status();
+}
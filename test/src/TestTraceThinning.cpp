@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compare #Trace with a straightforward (slow) implementation of its
+ * thinning rules after every appended point.
+ */
+
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "io/FileLineReader.hpp"
+#include "system/ConvertPathName.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+#include <stdio.h>
+
+using namespace std::chrono;
+
+using Time = TracePoint::Time;
+
+/**
+ * Keeps all points in a std::vector and searches the whole trace for
+ * the next point to be thinned.
+ */
+class ReferenceTrace {
+  struct Item {
+    TracePoint point;
+
+    /**
+     * See Trace::delta_distances.
+     */
+    unsigned delta_distance;
+  };
+
+  std::vector<Item> items;
+
+  TaskProjection projection;
+
+  const Time no_thin_time, max_time;
+  const unsigned max_size, opt_size;
+
+  Time average_delta_time{};
+  unsigned average_delta_distance = 0;
+
+public:
+  ReferenceTrace(Time _no_thin_time, Time _max_time,
+                 unsigned _max_size) noexcept
+    :no_thin_time(_no_thin_time), max_time(_max_time),
+     max_size(_max_size), opt_size((3 * _max_size) / 4) {}
+
+  std::size_t size() const noexcept {
+    return items.size();
+  }
+
+  const TracePoint &operator[](std::size_t i) const noexcept {
+    return items[i].point;
+  }
+
+  unsigned GetAverageDeltaDistance() const noexcept {
+    return average_delta_distance;
+  }
+
+  Time GetAverageDeltaTime() const noexcept {
+    return average_delta_time;
+  }
+
+  void push_back(TracePoint point) noexcept {
+    if (items.empty()) {
+      projection.Reset(point.GetLocation());
+      projection.Update();
+    } else if (point.GetTime() < Back().GetTime()) {
+      if (point.GetTime() + minutes{3} < Back().GetTime()) {
+        Clear();
+        return;
+      }
+
+      EraseLaterThan(point.GetTime() - seconds{10});
+    } else if (point.GetTime() - Back().GetTime() < seconds{2})
+      return;
+
+    if (max_time != Trace::null_time && point.GetTime() > max_time)
+      EraseEarlierThan(point.GetTime() - max_time);
+
+    if (items.size() >= max_size)
+      Thin();
+
+    point.Project(projection);
+    items.push_back({point, 0});
+
+    if (items.size() > 2)
+      UpdateDeltaDistance(items.size() - 2);
+  }
+
+private:
+  const TracePoint &Back() const noexcept {
+    return items.back().point;
+  }
+
+  void Clear() noexcept {
+    items.clear();
+    average_delta_time = {};
+    average_delta_distance = 0;
+  }
+
+  void UpdateDeltaDistance(std::size_t i) noexcept {
+    items[i].delta_distance =
+      items[i].point.FlatDistanceTo(items[i - 1].point);
+  }
+
+  void EraseLaterThan(Time time) noexcept {
+    while (!items.empty() && Back().GetTime() > time)
+      items.pop_back();
+  }
+
+  void EraseEarlierThan(Time time) noexcept {
+    if (time == Time{})
+      return;
+
+    while (!items.empty() && items.front().point.GetTime() < time)
+      items.erase(items.begin());
+  }
+
+  Time GetRecentTime(Time t) const noexcept {
+    if (items.empty() || Back().GetTime() <= t)
+      return {};
+
+    return Back().GetTime() - t;
+  }
+
+  /**
+   * The elimination rank of an inner point: distance error, then
+   * time error, then age.
+   */
+  std::tuple<unsigned, Time, std::size_t> GetRank(std::size_t i) const noexcept {
+    const TracePoint &last = items[i - 1].point;
+    const TracePoint &node = items[i].point;
+    const TracePoint &next = items[i + 1].point;
+
+    const int d_this = last.FlatDistanceTo(node) + node.FlatDistanceTo(next);
+    const int d_rem = last.FlatDistanceTo(next);
+
+    const Time t = next.DeltaTime(last)
+      - std::min(next.DeltaTime(node), node.DeltaTime(last));
+
+    return {abs(d_this - d_rem), t, i};
+  }
+
+  void EraseDelta(std::size_t target_size, Time recent) noexcept {
+    if (items.size() <= 2)
+      return;
+
+    const Time recent_time = GetRecentTime(recent);
+
+    while (items.size() > target_size) {
+      std::size_t best = 0;
+      for (std::size_t i = 1; i + 1 < items.size(); ++i)
+        if (items[i].point.GetTime() < recent_time &&
+            (best == 0 || GetRank(i) < GetRank(best)))
+          best = i;
+
+      if (best == 0)
+        break;
+
+      items.erase(std::next(items.begin(), best));
+      if (best + 1 < items.size())
+        UpdateDeltaDistance(best);
+    }
+  }
+
+  void Thin() noexcept {
+    EraseDelta(opt_size, no_thin_time);
+    if (items.size() > opt_size && no_thin_time.count() > 0)
+      EraseDelta(opt_size, {});
+
+    const Time r = GetRecentTime(no_thin_time);
+
+    unsigned acc = 0;
+    unsigned n = 0;
+    for (; n < items.size() && items[n].point.GetTime() < r; ++n)
+      acc += items[n].delta_distance;
+
+    average_delta_distance = n > 0 ? acc / n : 0;
+    average_delta_time = n >= 2
+      ? (items[n - 1].point.GetTime() - items.front().point.GetTime()) / (n - 1)
+      : Time{};
+  }
+};
+
+[[gnu::pure]]
+static bool
+Equals(const Trace &trace, const ReferenceTrace &reference) noexcept
+{
+  if (trace.size() != reference.size() ||
+      trace.GetAverageDeltaDistance() != reference.GetAverageDeltaDistance() ||
+      trace.GetAverageDeltaTime() != reference.GetAverageDeltaTime())
+    return false;
+
+  std::size_t i = 0;
+  for (const TracePoint &point : trace) {
+    const TracePoint &expected = reference[i++];
+    if (point.GetTime() != expected.GetTime() ||
+        point.GetFlatLocation() != expected.GetFlatLocation())
+      return false;
+  }
+
+  return true;
+}
+
+static std::vector<TracePoint>
+LoadFixes(Path path)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  std::vector<TracePoint> fixes;
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    fixes.emplace_back(fix.location,
+                       duration_cast<Time>(fix.time.DurationSinceMidnight()),
+                       fix.gps_altitude, 0, 0);
+  }
+
+  return fixes;
+}
+
+/**
+ * Let the clock go back now and then, to exercise the repair and
+ * restart code.
+ */
+static std::vector<TracePoint>
+WarpTime(std::vector<TracePoint> fixes) noexcept
+{
+  for (std::size_t i = 1; i < fixes.size(); ++i) {
+    const TracePoint &fix = fixes[i];
+
+    Time offset{};
+    if (i % 1301 == 0)
+      offset = seconds{400};
+    else if (i % 97 == 0)
+      offset = seconds{5 + i % 20};
+    else
+      continue;
+
+    if (fix.GetTime() > offset)
+      fixes[i] = TracePoint(fix.GetLocation(), fix.GetTime() - offset,
+                            fix.GetAltitude(), 0, 0);
+  }
+
+  return fixes;
+}
+
+static bool
+Compare(const std::vector<TracePoint> &fixes, unsigned max_size,
+        Time no_thin_time, Time max_time)
+{
+  Trace trace(no_thin_time, max_time, max_size);
+  ReferenceTrace reference(no_thin_time, max_time, max_size);
+
+  for (const TracePoint &fix : fixes) {
+    trace.push_back(fix);
+    reference.push_back(fix);
+
+    if (!Equals(trace, reference))
+      return false;
+  }
+
+  return true;
+}
+
+static void
+TestFile(const char *path)
+{
+  const auto fixes = LoadFixes(PathName(path));
+  const auto warped = WarpTime(fixes);
+
+  static constexpr unsigned sizes[] = {4, 7, 16, 64, 256};
+  static constexpr Time no_thin_times[] = {
+    seconds{0}, seconds{30}, seconds{1000},
+  };
+  static constexpr Time max_times[] = {
+    Trace::null_time, seconds{600}, seconds{3600},
+  };
+
+  for (const unsigned max_size : sizes) {
+    bool success = !fixes.empty();
+    for (const Time no_thin_time : no_thin_times)
+      for (const Time max_time : max_times)
+        success = success &&
+          Compare(fixes, max_size, no_thin_time, max_time) &&
+          Compare(warped, max_size, no_thin_time, max_time);
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s max_size=%u", path, max_size);
+    ok(success, buffer, 0);
+  }
+}
+
+/**
+ * The memory is allocated as needed, not for #max_size points.
+ */
+static void
+TestLargeMaxSize()
+{
+  Trace trace({}, Trace::null_time, 1U << 30);
+
+  const GeoPoint origin(Angle::Degrees(7.7), Angle::Degrees(51.0));
+  for (unsigned i = 0; i < 1000; ++i)
+    trace.push_back(TracePoint(origin, Time{10 * i}, 1000., 0, 0));
+
+  ok1(trace.size() == 1000);
+  ok1(trace.GetMaxSize() == 1U << 30);
+}
+
+static constexpr const char *igc_files[] = {
+  "test/data/01lz1hq1.igc",
+  "test/data/0asljd01.igc",
+  "test/data/9crx3101.igc",
+  "test/data/apf-bug554.igc",
+};
+
+int main()
+try {
+  plan_tests(std::size(igc_files) * 5 + 2);
+
+  for (const char *path : igc_files)
+    TestFile(path);
+
+  TestLargeMaxSize();
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
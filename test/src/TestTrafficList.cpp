@@ -0,0 +1,267 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FLARM/List.hpp"
+#include "FLARM/Store.hpp"
+#include "TestUtil.hpp"
+
+#include <cmath>
+#include <set>
+
+#include <stdio.h>
+
+static FlarmId
+MakeId(unsigned i) noexcept
+{
+  /* sequential ids, like a block of ICAO addresses */
+  char buffer[16];
+  sprintf(buffer, "%06X", 0x3d0000 + i);
+  return FlarmId::Parse(buffer, nullptr);
+}
+
+static void
+Fill(TrafficList &list, unsigned n, TimeStamp clock) noexcept
+{
+  for (unsigned i = 0; i < n; ++i) {
+    FlarmTraffic *traffic = list.AllocateTraffic(MakeId(i));
+    if (traffic == nullptr)
+      return;
+
+    traffic->valid.Update(clock);
+    traffic->alarm_level = FlarmTraffic::AlarmType::NONE;
+    /* the distance decreases with the index */
+    traffic->distance = 10000 - i * 10;
+  }
+}
+
+[[gnu::pure]]
+static bool
+FindAll(const TrafficList &list, unsigned begin, unsigned end) noexcept
+{
+  for (unsigned i = begin; i < end; ++i) {
+    const FlarmTraffic *traffic = list.FindTraffic(MakeId(i));
+    if (traffic == nullptr || traffic->id != MakeId(i))
+      return false;
+  }
+
+  return true;
+}
+
+static void
+TestLookup()
+{
+  const TimeStamp clock{std::chrono::seconds{100}};
+
+  constexpr unsigned n = TrafficList::MAX_COUNT;
+
+  TrafficList list;
+  list.Clear();
+  Fill(list, n, clock);
+
+  ok1(list.GetActiveTrafficCount() == n);
+  ok1(FindAll(list, 0, n));
+  ok1(list.FindTraffic(MakeId(n)) == nullptr);
+
+  /* the capacity is limited */
+  list.Clear();
+  Fill(list, n + 10, clock);
+  ok1(list.GetActiveTrafficCount() == n);
+
+  /* expire half of the traffic; the index must follow the items
+     moved by quick_remove() */
+  list.Clear();
+  Fill(list, n, clock);
+  for (unsigned i = 0; i < n; i += 2)
+    list.FindTraffic(MakeId(i))->valid.Update(clock + std::chrono::seconds{5});
+
+  list.Expire(clock + std::chrono::seconds{5});
+  ok1(list.GetActiveTrafficCount() == n / 2);
+
+  bool ok = true;
+  for (unsigned i = 0; i < n; ++i)
+    if ((list.FindTraffic(MakeId(i)) != nullptr) != (i % 2 == 0))
+      ok = false;
+  ok1(ok);
+}
+
+static void
+TestComplement()
+{
+  const TimeStamp clock{std::chrono::seconds{100}};
+
+  TrafficList a, b;
+  a.Clear();
+  b.Clear();
+
+  Fill(a, 40, clock);
+
+  /* copy into an empty list */
+  b.Complement(a);
+  ok1(b.GetActiveTrafficCount() == 40);
+  ok1(FindAll(b, 0, 40));
+
+  /* merge */
+  TrafficList c;
+  c.Clear();
+  Fill(c, 60, clock);
+  a.Complement(c);
+  ok1(a.GetActiveTrafficCount() == 60);
+  ok1(FindAll(a, 0, 60));
+}
+
+static void
+TestAlert()
+{
+  const TimeStamp clock{std::chrono::seconds{100}};
+
+  TrafficList list;
+  list.Clear();
+  Fill(list, 50, clock);
+
+  ok1(list.FindMaximumAlert() == nullptr);
+  ok1(!list.InCloseRange());
+
+  list.FindTraffic(MakeId(10))->alarm_level =
+    FlarmTraffic::AlarmType::IMPORTANT;
+  list.FindTraffic(MakeId(20))->alarm_level =
+    FlarmTraffic::AlarmType::IMPORTANT;
+  list.FindTraffic(MakeId(30))->alarm_level = FlarmTraffic::AlarmType::LOW;
+  list.FindTraffic(MakeId(40))->distance = 100;
+
+  ok1(list.FindMaximumAlert()->id == MakeId(20));
+  ok1(list.InCloseRange());
+}
+
+/**
+ * Fill the list with #n targets on a spiral around the own aircraft,
+ * starting with id #first.
+ */
+static void
+FillSpiral(TrafficList &list, unsigned first, unsigned n,
+           TimeStamp clock) noexcept
+{
+  for (unsigned i = first; i < first + n; ++i) {
+    FlarmTraffic *traffic = list.AllocateTraffic(MakeId(i));
+    if (traffic == nullptr)
+      return;
+
+    const double r = 100 + i * 97, phi = i * 0.7;
+    traffic->valid.Update(clock);
+    traffic->alarm_level = FlarmTraffic::AlarmType::NONE;
+    traffic->relative_north = r * std::cos(phi);
+    traffic->relative_east = r * std::sin(phi);
+    traffic->distance = r;
+  }
+}
+
+[[gnu::pure]]
+static bool
+FindAll(const TrafficStore &store, unsigned begin, unsigned end) noexcept
+{
+  for (unsigned i = begin; i < end; ++i) {
+    const FlarmTraffic *traffic = store.FindTraffic(MakeId(i));
+    if (traffic == nullptr || traffic->id != MakeId(i))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Compare TrafficStore::VisitWithin() with a linear search.
+ */
+[[gnu::pure]]
+static bool
+CheckWithin(const TrafficStore &store,
+            double north, double east, double radius) noexcept
+{
+  std::set<FlarmId> expected, found;
+
+  for (const auto &traffic : store.GetList())
+    if (std::hypot(traffic.relative_north - north,
+                   traffic.relative_east - east) <= radius)
+      expected.insert(traffic.id);
+
+  bool duplicate = false;
+  store.VisitWithin(north, east, radius, [&](const FlarmTraffic &traffic){
+    if (!found.insert(traffic.id).second)
+      duplicate = true;
+  });
+
+  return !duplicate && found == expected;
+}
+
+static void
+TestStore()
+{
+  const TimeStamp clock{std::chrono::seconds{100}};
+
+  /* several devices with overlapping traffic, more than one
+     TrafficList can hold */
+  constexpr unsigned n_devices = 8;
+  TrafficList lists[n_devices];
+  for (unsigned i = 0; i < n_devices; ++i) {
+    lists[i].Clear();
+    FillSpiral(lists[i], i * 50, TrafficList::MAX_COUNT, clock);
+  }
+
+  TrafficStore store;
+  ok1(store.IsEmpty());
+  ok1(store.FindNearest() == nullptr);
+
+  for (const auto &list : lists)
+    store.Complement(list);
+
+  constexpr unsigned n = (n_devices - 1) * 50 + TrafficList::MAX_COUNT;
+
+  lists[3].list[0].alarm_level = FlarmTraffic::AlarmType::LOW;
+  store.Complement(lists[3]);
+  ok1(store.GetActiveTrafficCount() == n);
+
+  /* the first list wins */
+  ok1(store.FindTraffic(MakeId(150))->alarm_level ==
+      FlarmTraffic::AlarmType::NONE);
+
+  for (auto &traffic : store.GetList())
+    if (traffic.id == MakeId(250) || traffic.id == MakeId(300))
+      traffic.alarm_level = FlarmTraffic::AlarmType::IMPORTANT;
+
+  store.UpdateIndex();
+
+  ok1(FindAll(store, 0, n));
+  ok1(store.FindTraffic(MakeId(n)) == nullptr);
+  ok1(store.FindNearest()->id == MakeId(0));
+  ok1(store.InCloseRange());
+
+  /* the nearer one of the two alerts with the same level */
+  ok1(store.FindMaximumAlert()->id == MakeId(250));
+
+  unsigned n_alerts = 0;
+  store.VisitAlerts([&n_alerts](const FlarmTraffic &traffic){
+    if (traffic.HasAlarm())
+      ++n_alerts;
+  });
+  ok1(n_alerts == 2);
+
+  ok1(CheckWithin(store, 0, 0, 5000));
+  ok1(CheckWithin(store, 0, 0, 100000));
+  ok1(CheckWithin(store, -12345, 6789, 3000));
+  ok1(CheckWithin(store, 20000, -20000, 1));
+  ok1(CheckWithin(store, 1e7, 1e7, 1000));
+
+  store.Clear();
+  ok1(store.IsEmpty());
+  ok1(store.FindTraffic(MakeId(0)) == nullptr);
+}
+
+int main()
+{
+  plan_tests(10 + 4 + 17);
+
+  TestLookup();
+  TestComplement();
+  TestAlert();
+  TestStore();
+
+  return exit_status();
+}
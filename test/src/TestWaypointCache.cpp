@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Waypoint/WaypointCache.hpp"
+#include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/Factory.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Operation/Operation.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/MemoryReader.hxx"
+#include "io/StringOutputStream.hxx"
+#include "system/Path.hpp"
+#include "util/SpanCast.hxx"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Returns all waypoints in the order in which they were appended.
+ */
+static std::vector<WaypointPtr>
+GetWaypoints(const Waypoints &waypoints)
+{
+  std::vector<WaypointPtr> result(waypoints.begin(), waypoints.end());
+  std::sort(result.begin(), result.end(),
+            [](const WaypointPtr &a, const WaypointPtr &b){
+              return a->id < b->id;
+            });
+  return result;
+}
+
+static std::vector<WaypointPtr>
+ParseFile(Path path)
+{
+  NullOperationEnvironment operation;
+  Waypoints waypoints;
+  ReadWaypointFile(path, waypoints,
+                   WaypointFactory(WaypointOrigin::PRIMARY), operation);
+  return GetWaypoints(waypoints);
+}
+
+static std::string
+Save(const std::vector<WaypointPtr> &waypoints)
+{
+  StringOutputStream sos;
+  BufferedOutputStream bos{sos};
+  SaveWaypointCache(bos, waypoints);
+  bos.Flush();
+  return std::move(sos).GetValue();
+}
+
+static std::vector<WaypointPtr>
+Load(std::string_view data)
+{
+  MemoryReader memory_reader{AsBytes(data)};
+  BufferedReader buffered_reader{memory_reader};
+
+  Waypoints waypoints;
+  try {
+    LoadWaypointCache(buffered_reader, waypoints, WaypointOrigin::PRIMARY);
+  } catch (...) {
+    /* nothing must have been added */
+    if (!waypoints.IsEmpty())
+      return {nullptr};
+    throw;
+  }
+
+  return GetWaypoints(waypoints);
+}
+
+static bool
+Equals(const Waypoint &a, const Waypoint &b) noexcept
+{
+  return a.location == b.location &&
+    a.has_elevation == b.has_elevation &&
+    (!a.has_elevation || a.elevation == b.elevation) &&
+    a.shortname == b.shortname && a.name == b.name &&
+    a.comment == b.comment && a.details == b.details &&
+    a.files_embed == b.files_embed &&
+#ifdef HAVE_RUN_FILE
+    a.files_external == b.files_external &&
+#endif
+    a.original_id == b.original_id &&
+    a.runway.IsDirectionDefined() == b.runway.IsDirectionDefined() &&
+    (!a.runway.IsDirectionDefined() ||
+     a.runway.GetDirectionDegrees() == b.runway.GetDirectionDegrees()) &&
+    a.runway.IsLengthDefined() == b.runway.IsLengthDefined() &&
+    (!a.runway.IsLengthDefined() ||
+     a.runway.GetLength() == b.runway.GetLength()) &&
+    a.radio_frequency == b.radio_frequency &&
+    a.flags.turn_point == b.flags.turn_point &&
+    a.flags.home == b.flags.home &&
+    a.flags.start_point == b.flags.start_point &&
+    a.flags.finish_point == b.flags.finish_point &&
+    a.type == b.type && a.origin == b.origin;
+}
+
+static bool
+Equals(const std::vector<WaypointPtr> &a, const std::vector<WaypointPtr> &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if (!Equals(*a[i], *b[i]))
+      return false;
+
+  return true;
+}
+
+static void
+TestRoundTrip(Path path)
+{
+  const auto original = ParseFile(path);
+  ok1(!original.empty());
+
+  const auto data = Save(original);
+  ok1(Equals(Load(data), original));
+
+  /* a truncated file must be rejected as a whole */
+  bool failed = false;
+  try {
+    Load(data.substr(0, data.size() - 1));
+  } catch (...) {
+    failed = true;
+  }
+
+  ok1(failed);
+}
+
+static void
+TestMalformed()
+{
+  /* an unknown version must be rejected */
+  std::string data = Save({});
+  data[0] ^= 0x40;
+
+  bool failed = false;
+  try {
+    Load(data);
+  } catch (...) {
+    failed = true;
+  }
+
+  ok1(failed);
+
+  ok1(Load(Save({})).empty());
+}
+
+int main()
+try {
+  plan_tests(4 * 3 + 2);
+
+  TestRoundTrip(Path(_T("test/data/waypoints.cup")));
+  TestRoundTrip(Path(_T("test/data/waypoints.dat")));
+  TestRoundTrip(Path(_T("test/data/waypoints_ozi.wpt")));
+  TestRoundTrip(Path(_T("test/data/waypoints_compe_geo.wpt")));
+  TestMalformed();
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
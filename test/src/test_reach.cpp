@@ -50,6 +50,15 @@ test_reach(const RasterMap &map, double mwind, double mc, double height_min_work
                                               true, true);
   PrintHelper::print(reach_working);
 
+  /* the previous fan can be reused at the same location, but not
+     after a climb or a descent */
+  ok1(route.IsReachReusable(reach_terrain, aorigin, config, INT_MAX,
+                            true, false));
+  ok1(!route.IsReachReusable(reach_terrain, AGeoPoint(origin, horigin + 200),
+                             config, INT_MAX, true, false));
+  ok1(!route.IsReachReusable(reach_terrain, AGeoPoint(origin, horigin - 10),
+                             config, INT_MAX, true, false));
+
   {
     Directory::Create(Path(_T("output/results")));
     std::ofstream fout("output/results/terrain.txt");
@@ -118,7 +127,7 @@ try {
   } while (map.IsDirty());
   zzip_dir_close(dir);
 
-  plan_tests(6);
+  plan_tests(12);
   test_reach(map, 0, 0.1, 0);
   test_reach(map, 0, 0.1, 750);
   test_reach(map, 0, 0.1, 500);
@@ -36,6 +36,11 @@ test_troute(const RasterMap &map, double mwind, double mc, int ceiling)
   route.UpdatePolar(settings, config, polar, polar, wind);
   route.SetTerrain(&map);
 
+  /* this one is solved in small time slices */
+  TerrainRoute sliced_route;
+  sliced_route.UpdatePolar(settings, config, polar, polar, wind);
+  sliced_route.SetTerrain(&map);
+
   GeoPoint origin(map.GetMapCenter());
 
   auto pd = map.PixelDistance(origin, 1);
@@ -68,18 +73,28 @@ test_troute(const RasterMap &map, double mwind, double mc, int ceiling)
 
     int hdest = map.GetHeight(dest).GetValueOr0() + 100;
 
-    retval = route.Solve(AGeoPoint(origin,
-                                   map.GetHeight(origin).GetValueOr0() + 100),
-                         AGeoPoint(dest,
-                                   mc > 0
-                                   ? hdest
-                                   : std::max(hdest, 3200)),
-                         config, ceiling);
+    const AGeoPoint aorigin(origin,
+                            map.GetHeight(origin).GetValueOr0() + 100);
+    const AGeoPoint adest(dest,
+                          mc > 0
+                          ? hdest
+                          : std::max(hdest, 3200));
+
+    retval = route.Solve(aorigin, adest, config, ceiling);
     char buffer[128];
     sprintf(buffer,"terrain route solve, dir=%g, wind=%g, mc=%g ceiling=%d",
             (double)ang, (double)mwind, (double)mc, (int)ceiling);
     ok(retval, buffer, 0);
     PrintHelper::print_route(route);
+
+    /* a search split into time slices must find the same route */
+    bool sliced_retval = sliced_route.Solve(aorigin, adest, config,
+                                            ceiling, 1);
+    while (sliced_route.IsSolving())
+      sliced_retval = sliced_route.Solve(aorigin, adest, config,
+                                         ceiling, 1);
+    ok1(sliced_retval == retval &&
+        sliced_route.GetSolution() == route.GetSolution());
   }
 
   // polar.SetMC(0);
@@ -120,7 +135,7 @@ try {
   } while (map.IsDirty());
   zzip_dir_close(dir);
 
-  plan_tests(16*3);
+  plan_tests(16*3*2);
   test_troute(map, 0, 0.1, 10000);
   test_troute(map, 0, 0, 10000);
   test_troute(map, 5.0, 1, 10000);